@@ -20,18 +20,10 @@
 //Custom classes
 class PeriodicTable
 {
-  //Class for storing periodic table data
-  private:
-    //Atom types
-    vector<string> Typs; //Atomic symbols
-    //Bond distances
-    vector<double> CovRadii; //Covalent radii
-    //Radii
-    vector<double> vdWRadii; //Van der Waals radii
-    //Masses
-    vector<double> AtMasses; //Atomic masses (amu)
+  //Class for retrieving periodic table data
+  //NB: The data is hard coded in LICHEM_periodic_table.h
   public:
-    //Set data (hard coded constructor)
+    //Constructor
     PeriodicTable();
     //Destructor
     ~PeriodicTable();
@@ -39,8 +31,31 @@ class PeriodicTable
     string Typing(int); //Atom type
     int RevTyping(string); //Atomic number
     double GetCovRadius(string); //Covalent radius
+    double GetCovRadius(int); //Covalent radius
     double GetRadius(string); //Van der Waals radius
+    double GetRadius(int); //Van der Waals radius
     double GetAtMass(string); //Atomic mass
+    double GetAtMass(int); //Atomic mass
+};
+
+class FloatText
+{
+  //Fixed width text for a number, stored without heap allocations
+  //NB: Created by LICHEMFormFloat and written with the << operator
+  //NB: The text is capped at 63 characters. Widths above 60 are reduced to
+  //60, and integer text longer than 63 characters (e.g. 1e100 with a width
+  //of 0) is truncated, where the old stringstream text printed every digit.
+  public:
+    //Constructor
+    FloatText();
+    //Destructor
+    ~FloatText();
+    //Text
+    char Text[64]; //Characters (not null terminated)
+    int Nchars; //Number of characters
+    //Functions
+    string str(); //Return the text as a string
+    friend ostream& operator<<(ostream&,const FloatText&); //Write text
 };
 
 class Coord
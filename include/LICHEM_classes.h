@@ -96,6 +96,181 @@ class QMMMElec
     vector<double> rad; //Radius (Ang)
 };
 
+//Monte Carlo move history
+class MCUndoLog
+{
+  //Journal of the coordinates changed by a trial Monte Carlo move
+  private:
+    //Single bead displacements
+    vector<int> Atoms; //Atom IDs of the moved beads
+    vector<int> Beads; //Bead IDs of the moved beads
+    vector<Coord> OldPos; //Positions before the move
+    //Collective displacements (volume moves)
+    bool AllSaved; //Flag for a full copy of the coordinates
+    vector<vector<Coord> > AllPos; //Positions of all beads
+    //Box lengths
+    double LxOld; //Box length before the move
+    double LyOld; //Box length before the move
+    double LzOld; //Box length before the move
+  public:
+    //Constructor
+    MCUndoLog();
+    //Destructor
+    ~MCUndoLog();
+    //Functions to record and revert moves
+    void Clear(); //Start a new trial move
+    void SaveBead(vector<QMMMAtom>&,int,int); //Save one bead
+    void SaveAtom(vector<QMMMAtom>&,int,int); //Save all beads of an atom
+    void SaveAll(vector<QMMMAtom>&,int); //Save all beads of all atoms
+    void Undo(vector<QMMMAtom>&); //Restore the old coordinates
+    void FlagBeads(vector<bool>&,int); //Mark the beads that were moved
+    bool MovedAtoms(vector<int>&); //List the atoms that were moved
+};
+
+//Binary trajectory files
+class BinTraj
+{
+  //Random access reader for binary trajectory files
+  //NB: The file format is described above Print_traj in Analysis.cpp
+  private:
+    fstream TrajFile; //Input file stream
+    bool ReadIndex(); //Read the trailing frame index
+    void ScanFrames(); //Find the frames from the chunk headers
+  public:
+    //Constructor
+    BinTraj();
+    //Destructor
+    ~BinTraj();
+    //File settings
+    int Natoms; //Number of atoms
+    int Nbeads; //Number of beads per atom
+    int Nbytes; //Bytes per coordinate (4 or 8, 0 for compressed files)
+    double Quant; //Compression resolution (Ang)
+    vector<string> Typs; //Atom types
+    vector<long long> Frames; //File offsets of the frames
+    //Data for the last frame that was read
+    long long Step; //Simulation step
+    double Energy; //Energy (eV), NaN if it was not saved
+    double Lx; //Box length
+    double Ly; //Box length
+    double Lz; //Box length
+    vector<Coord> P; //Positions, atom i of bead j is P[i*Nbeads+j]
+    //Functions
+    bool Open(string); //Read the header and index of a file
+    bool ReadFrame(int); //Read a single frame
+    void Close(); //Close the file
+};
+
+//QM output files
+class QMLogFile
+{
+  //Single pass reader for large QM output files
+  //NB: The file is mapped into memory and searched for section markers, so
+  //only the lines after a marker are parsed
+  private:
+    const char* Text; //Contents of the file
+    size_t Size; //Number of characters
+    size_t Pos; //Current position
+    void* MapAddr; //Address of the memory map (NULL if not mapped)
+    string Copy; //Contents of files which cannot be mapped
+    bool Opened; //Flag for an open file
+    chrono::steady_clock::time_point tstart; //Time the file was opened
+    vector<string> Markers; //Section markers
+    vector<bool> LineStart; //Flags for markers at the start of a line
+    vector<size_t> NextHit; //Next position of each marker
+    vector<bool> Searched; //Flags for valid positions in NextHit
+    size_t FindMarker(int,size_t); //Search for a marker
+  public:
+    //Constructor
+    QMLogFile();
+    //Destructor
+    ~QMLogFile();
+    //Functions
+    bool Open(const string&); //Map a file into memory
+    void Close(); //Unmap the file and update the statistics
+    void AddMarker(const string&,bool); //Add a section marker
+    int NextMarker(); //Move past the next marker, -1 at the end of the file
+    void NextLine(); //Move to the start of the next line
+    void SkipWords(int); //Move past words on the current line
+    bool ReadDouble(double&); //Read a number on the current line
+    bool ReadArray(int,VectorXd&); //Read numbers on one or more lines
+};
+
+//Shared MM polarization results
+class MMPolResult
+{
+  //Polarization energy and QM forces from one TINKER calculation
+  private:
+    bool Saved; //Flag for a stored result
+    VectorXd Inputs; //Coordinates, box size, and QM multipoles
+    VectorXd GetInputs(vector<QMMMAtom>&,int); //Collect the inputs
+  public:
+    //Constructor
+    MMPolResult();
+    //Destructor
+    ~MMPolResult();
+    //Results
+    double E; //Polarization energy (kcal/mol)
+    VectorXd Forces; //Forces on the QM and PB atoms (eV/Angstrom)
+    //Functions
+    bool Match(vector<QMMMAtom>&,int); //Check for the same inputs
+    void Save(vector<QMMMAtom>&,int); //Mark the results as valid
+    void Clear(); //Remove the results
+};
+
+//Random numbers
+class RandomStream
+{
+  //Counter-based random number generator (Philox4x32-10)
+  //NB: A stream is a seed and a stream ID. The numbers are a function of
+  //the seed, the ID, and the position in the stream, so every chain, bead,
+  //and atom can have its own reproducible stream without locks.
+  private:
+    uint32_t Key[2]; //Seed
+    uint32_t Ctr[4]; //Block number (0,1) and stream ID (2,3)
+    uint32_t Block[4]; //Last block of random integers
+    int Nused; //Integers used from the last block
+    void NextBlock(); //Generate a new block of integers
+  public:
+    //Constructor
+    RandomStream();
+    //Destructor
+    ~RandomStream();
+    //Functions
+    void Seed(uint64_t,int,int,int); //Set the seed, chain, use, and index
+    uint32_t Integer(); //Random 32-bit integer
+    int Integer(int); //Random integer from 0 to N-1
+    double Uniform(); //Random number from 0 to 1
+    double Normal(); //Gaussian random number with unit variance
+    bool SelfTest(); //Compare with the published known answers
+};
+
+//Monte Carlo statistics
+class MCStats
+{
+  //Acceptance of each type of move and the cost of the samples
+  public:
+    //Constructor
+    MCStats();
+    //Destructor
+    ~MCStats();
+    //Counters
+    VectorXd Tries; //Steps which used each type of move
+    VectorXd Accepts; //Accepted steps which used each type of move
+    double QMCalls; //Number of QM bead energies
+    vector<double> Energies; //Energy after each step
+    vector<double> Evirial; //Centroid virial energy after each step
+    double Nacc; //Number of accepted steps
+    double Nrej; //Number of rejected steps
+    double DenAvg; //Average density
+    double LxAvg; //Average box length
+    double LyAvg; //Average box length
+    double LzAvg; //Average box length
+    //Functions
+    void Clear(); //Reset the counters
+    double CorrTime(); //Integrated autocorrelation time of the energy
+};
+
 //LICHEM simulation data
 class QMMMSettings
 {
@@ -113,6 +288,11 @@ class QMMMSettings
     int Charge; //QM total charge
     int Spin; //QM total spin
     string BackDir; //Directory for log file backups
+    string ScratchDir; //Root directory for bead scratch files (empty for none)
+    bool CacheResults; //Reuse wrapper results for repeated structures
+    string QMStoreDir; //Directory for saved QM results (empty for none)
+    double QMStoreMB; //Size limit for the saved QM results (MB)
+    double QMStoreCheck; //Fraction of the saved QM results to recalculate
     //Input needed for QMMM long-range electrostatics
     bool UseLREC; //Use a long-range correction
     double LRECCut; //Cutoff for the long-range correction
@@ -131,13 +311,29 @@ class QMMMSettings
     int Neq; //Number of equilibration run steps
     int Nsteps; //Number of production run steps
     int Nbeads; //Number of time-slices or beads
+    int QMBeads; //Number of beads in the contracted QM ring (0 for none)
+    string PIFactor; //Path-integral factorization (Primitive or TI)
+    bool PIVirial; //Flag to calculate the centroid virial energy
     double accratio; //Target acceptance ratio
     int Nprint; //Number of steps before printing
     double dt; //MD timestep
     double tautemp; //Thermostat time constant
+    double MCStep; //Monte Carlo step size (Angstroms)
+    int Chain; //ID of the Monte Carlo chain
+    int Nchains; //Number of independent Monte Carlo chains
+    string BeadMove; //Type of bead move (Uniform, Staging, or NormalModes)
+    int StageLen; //Number of bonds regenerated by staging moves
+    MCStats MCStat; //Statistics for the Monte Carlo moves
+    RandomStream MCRand; //Random numbers for the Monte Carlo moves
+    vector<RandomStream> BeadRand; //Random numbers for each bead
+    //Trajectory output
+    bool BinTraj; //Flag to write binary trajectories
+    int TrajBytes; //Bytes per coordinate in binary trajectories (4 or 8)
+    double TrajQuant; //Compression resolution (Ang), zero is lossless
     //Input needed for optimizations
     int MaxOptSteps; //Maximum iterative optimization steps
     double MMOptTol; //Criteria to end the optimization
+    string OptMetric; //Structure comparison for the MM convergence test
     double QMOptTol; //Criteria to end the optimization
     double StepScale; //Steepest descent step size (Ang)
     double MaxStep; //Maximum size of the optimization step
@@ -151,10 +347,133 @@ class QMMMSettings
     bool StartPathChk; //Flag to initially use checkpoints from nearby beads
     //Storage of energies (NEB and PIMC)
     double Eold; //Temporary storage
+    vector<double> BeadEpot; //Potential energy of each accepted bead
+    vector<VectorXd> BeadForces; //QM and PB forces of each accepted bead
+    double Espring; //Ring polymer energy of the accepted structure
+    vector<QMMMAtom> PIRing; //Contracted ring polymer for the QM beads
+    MatrixXd PIRingT; //Contraction matrix of the ring polymer
     double Ereact; //Reactant energy
     double Eprod; //Product energy
     double Ets; //Transition state energy
 };
 
+//Saved wrapper results
+class CachedResult
+{
+  //Energy, forces, and charges from one wrapper calculation
+  public:
+    //Constructor
+    CachedResult();
+    //Destructor
+    ~CachedResult();
+    //Results
+    uint64_t Key; //Hash of the inputs, zero for an empty entry
+    double E; //Energy (eV)
+    bool HasForces; //Flag for saved forces
+    VectorXd Forces; //Forces on the QM and PB atoms (eV/Angstrom)
+    VectorXd Charges; //Charges of the QM and PB atoms after the calculation
+};
+
+class ResultCache
+{
+  //Memory of recent wrapper results for repeated structures
+  //NB: Results are found with a hash of the coordinates, multipoles, box,
+  //and wrapper settings, so identical inputs skip the external program
+  private:
+    vector<CachedResult> Results; //Saved results
+    int NextResult; //Entry which is replaced next (oldest)
+    int Nhits; //Number of calculations found in memory
+    int Nmisses; //Number of calculations which were not found
+    void AddToHash(uint64_t&,const void*,size_t); //Update a hash
+    int FindEntry(uint64_t); //Locate a saved result
+    void Save(uint64_t,vector<QMMMAtom>&,const VectorXd*,int,double);
+  public:
+    //Constructor
+    ResultCache();
+    //Destructor
+    ~ResultCache();
+    //Functions
+    uint64_t GetKey(const string&,vector<QMMMAtom>&,QMMMSettings&,int,bool,
+                    bool);
+    bool FindEnergy(uint64_t,vector<QMMMAtom>&,int,double&);
+    bool FindForces(uint64_t,vector<QMMMAtom>&,VectorXd&,int,double&);
+    void SaveEnergy(uint64_t,vector<QMMMAtom>&,int,double);
+    void SaveForces(uint64_t,vector<QMMMAtom>&,const VectorXd&,int,double);
+    int Hits(); //Return the number of hits
+    int Misses(); //Return the number of misses
+};
+
+class QMResultStore
+{
+  //QM results saved on the disk for later simulations
+  //NB: Records are named with a hash of the QM input file, so any change to
+  //the method, basis set, QM structure, or embedding charges is a new record
+  private:
+    string Dir; //Directory for the records (empty if the store is off)
+    double MaxBytes; //Size limit for the records
+    double UsedBytes; //Approximate size of the records
+    double CheckFrac; //Fraction of the records which are recalculated
+    double ETol; //Largest energy difference for a good record (eV)
+    double FTol; //Largest force difference for a good record (eV/Ang)
+    double HTol; //Largest Hessian difference for a good record (a.u.)
+    int Nhits; //Number of results read from the disk
+    int Nmisses; //Number of results which were not found
+    int Nchecks; //Number of records which were recalculated
+    int Nbad; //Number of recalculated records which did not match
+    vector<uint64_t> CheckKeys; //Records which are being recalculated
+    string RecordName(uint64_t); //File name for a record
+    bool Read(uint64_t,double&,VectorXd&,VectorXd&,MatrixXd&);
+    bool Find(uint64_t,vector<QMMMAtom>&,int,double&,VectorXd*,MatrixXd*);
+    void Save(uint64_t,vector<QMMMAtom>&,int,double,const VectorXd*,
+              const MatrixXd*);
+    void Prune(double); //Remove the least recently used records
+  public:
+    //Constructor
+    QMResultStore();
+    //Destructor
+    ~QMResultStore();
+    //Functions
+    void Open(QMMMSettings&); //Set up the directory and limits
+    uint64_t GetKey(const string&,int); //Hash a QM input file
+    bool FindEnergy(uint64_t,vector<QMMMAtom>&,int,double&);
+    bool FindForces(uint64_t,vector<QMMMAtom>&,VectorXd&,int,double&);
+    bool FindHessian(uint64_t,MatrixXd&);
+    void SaveEnergy(uint64_t,vector<QMMMAtom>&,int,double);
+    void SaveForces(uint64_t,vector<QMMMAtom>&,const VectorXd&,int,double);
+    void SaveHessian(uint64_t,const MatrixXd&);
+    bool Active(); //Check if records are saved
+    int Hits(); //Return the number of hits
+    int Misses(); //Return the number of misses
+    int Checks(); //Return the number of recalculated records
+    int Mismatches(); //Return the number of bad records
+};
+
+//Parallel bead calculations
+class BeadScheduler
+{
+  //Divides the processors between the wrapper calculations of the beads
+  //NB: Each job uses Ncpus processors, so up to (processors/Ncpus) jobs run
+  //at the same time. The most expensive beads are started first, using the
+  //wall times of earlier jobs, and idle threads take the next bead.
+  private:
+    vector<int> Cores; //Processors available to LICHEM
+    vector<double> Cost; //Wall time of the last job for each bead (s)
+    vector<double> Started; //Start time of the current job for each bead
+    void Setup(); //Find the processors
+    double Clock(); //Wall time (s)
+  public:
+    //Constructor
+    BeadScheduler();
+    //Destructor
+    ~BeadScheduler();
+    //Functions
+    int Slots(int); //Number of jobs which can run at the same time
+    vector<int> Order(const vector<int>&); //Sort beads by expected cost
+    void Pin(); //Keep the calling thread on the processors of its slot
+    void Unpin(); //Allow the calling thread to use all processors
+    void Start(int); //Pin the thread and start the timer for a bead
+    void Finish(int); //Save the wall time for a bead and unpin the thread
+};
+
 #endif
 
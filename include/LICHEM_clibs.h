@@ -35,6 +35,9 @@
 
 //General header files
 #include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
 #include <iostream>
 #include <iomanip>
@@ -47,6 +50,25 @@
 #include <map>
 #include <sys/stat.h>
 #include <algorithm>
+#include <type_traits>
+#include <chrono>
+
+//POSIX header files for processes and files
+#include <cerrno>
+#include <fcntl.h>
+#include <ftw.h>
+#include <glob.h>
+#include <sched.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//Changing directories in posix_spawn needs glibc 2.29 or newer
+#if defined(__GLIBC__) and ((__GLIBC__ > 2) or \
+    ((__GLIBC__ == 2) and (__GLIBC_MINOR__ >= 29)))
+ #define LICHEM_SPAWN_CHDIR
+#endif
 
 #endif
 
@@ -33,11 +33,26 @@ namespace LICHEMGlobal
   int Natoms = 0; //Total number of atoms
   int Nqm = 0; //Number of QM atoms
   int Nmm = 0; //Number of MM atoms
-  double mcstep = 2*StepMin; //Monte Carlo step size
+  uint64_t RandSeed = 0; //Seed for the random number streams
   double Lx = 10000.0; //Box length
   double Ly = 10000.0; //Box length
   double Lz = 10000.0; //Box length
 
+  //Lists of atom IDs for each region (set by the input reader)
+  vector<int> MMList; //MM atoms
+  vector<int> QMPBList; //QM and pseudo-bond atoms in structure order
+  vector<int> ActiveList; //Atoms which are not frozen
+
+  //Private directory of this run inside the scratch root (empty for none)
+  string ScratchTop;
+
+  //Monte Carlo chain of the calling thread (selects the job directories)
+  int JobChain = 0;
+  #pragma omp threadprivate(JobChain)
+
+  //File offsets of the frames in open binary trajectories
+  map<fstream*,vector<long long> > BinTrajFrames;
+
   //Flags for simulation options
   bool GEM = 0; //Flag for frozen density QMMM potential
   bool AMOEBA = 0; //Flag for polarizable QMMM potential
@@ -70,6 +85,13 @@ namespace LICHEMGlobal
   int EndTime = 0; //Time the calculation ends
   int QMTime = 0; //Sum of QM wrapper times
   int MMTime = 0; //Sum of MM wrapper times
+
+  //External program statistics
+  int Nlaunches = 0; //Number of programs started
+  int LaunchFails = 0; //Number of programs with a nonzero exit status
+  double LaunchTime = 0; //Sum of the wall times of the programs (s)
+  int Nparses = 0; //Number of QM output files which were read
+  double ParseTime = 0; //Sum of the times spent reading QM output files (s)
 };
 
 #endif
@@ -34,6 +34,8 @@ using namespace LICHEMConst;
 using namespace LICHEMGlobal;
 #include "LICHEM_Lepton.h"
 using namespace LICHEMLepton;
+#include "LICHEM_periodic_table.h"
+using namespace LICHEMElements;
 
 //LICHEM headers and libraries
 #include "LICHEM_base_classes.h"
@@ -43,6 +45,15 @@ using namespace LICHEMLepton;
 //Set up periodic table
 PeriodicTable PTable;
 
+//Shared TINKER polarization calculations for each bead
+vector<MMPolResult> TINKERPolResults;
+//Results for repeated structures
+ResultCache SavedResults;
+//QM results saved between simulations
+QMResultStore QMStore;
+//Processors and costs for parallel bead calculations
+BeadScheduler BeadJobs;
+
 //Function declarations (alphabetical)
 double AMBERForces(vector<QMMMAtom>&,VectorXd&,QMMMSettings&,int);
 
@@ -54,6 +65,15 @@ double AMBEROpt(vector<QMMMAtom>&,QMMMSettings&,int);
 
 bool Angled(vector<QMMMAtom>&,int,int);
 
+VectorXd BeadDist2(vector<QMMMAtom>&,Coord&,int,VectorXd&,VectorXd&,
+                   VectorXd&);
+
+template<typename T> void BinTrajAppend(string&,T);
+
+void BinTraj2XYZ(int&,char**&);
+
+bool BinTrajSelfTest(int,double);
+
 double Bohring(double);
 
 bool Bonded(vector<QMMMAtom>&,int,int);
@@ -68,8 +88,13 @@ VectorXd CINEBTangent(VectorXd&,VectorXd&,QMMMSettings&,int);
 
 bool CheckFile(const string&);
 
+void CloseTraj(fstream&);
+
 Coord CoordDist2(Coord&,Coord&);
 
+double DistMatRMSDiff(VectorXd&,VectorXd&,VectorXd&,VectorXd&,VectorXd&,
+                      VectorXd&);
+
 bool Dihedraled(vector<QMMMAtom>&,int,int);
 
 double EFFCorr(QMMMElec&,QMMMElec&,int);
@@ -101,6 +126,8 @@ void GaussianCharges(vector<QMMMAtom>&,QMMMSettings&,int);
 
 double GaussianEnergy(vector<QMMMAtom>&,QMMMSettings&,int);
 
+bool GaussianFchk(vector<QMMMAtom>&,int,double&,VectorXd*,MatrixXd*);
+
 double GaussianForces(vector<QMMMAtom>&,VectorXd&,QMMMSettings&,int);
 
 MatrixXd GaussianHessian(vector<QMMMAtom>&,QMMMSettings&,int);
@@ -113,10 +140,23 @@ double GEMC6(double,Coord&,Coord&,double);
 
 double Get_EeFF(vector<QMMMAtom>&,vector<QMMMElec>&,QMMMSettings&);
 
+double Get_PI_AtomEspring(QMMMAtom&,QMMMSettings&);
+
+double Get_PI_BeadTI(vector<QMMMAtom>&,QMMMSettings&,VectorXd&);
+
+MatrixXd Get_PI_Contraction(QMMMSettings&);
+
 double Get_PI_Espring(vector<QMMMAtom>&,QMMMSettings&);
 
 double Get_PI_Epot(vector<QMMMAtom>&,QMMMSettings&);
 
+double Get_PI_Epot(vector<QMMMAtom>&,QMMMSettings&,vector<double>&,
+                   vector<VectorXd>&,vector<bool>&);
+
+double Get_PI_ETI(vector<QMMMAtom>&,QMMMSettings&);
+
+double Get_PI_Kvirial(vector<QMMMAtom>&,QMMMSettings&);
+
 vector<HermGau> HermBasis(string,string);
 
 double HermCoul1e(HermGau&,double,Coord&);
@@ -145,10 +185,31 @@ void LICHEM2BASIS(int&,char**&);
 
 void LICHEM2TINK(int&,char**&);
 
+void LICHEMBeadEnergies(vector<QMMMAtom>&,QMMMSettings&,const vector<int>&,
+                        vector<double>&,vector<double>&);
+
+double LICHEMBeadEnergy(vector<QMMMAtom>&,QMMMSettings&,int);
+
+double LICHEMBeadEnergy(vector<QMMMAtom>&,QMMMSettings&,int,double&,
+                        double&);
+
+void LICHEMBeadForces(vector<QMMMAtom>&,QMMMSettings&,const vector<int>&,
+                      vector<double>&,vector<double>&,vector<VectorXd>&);
+
+MatrixXd LICHEMBeadHessian(vector<QMMMAtom>&,QMMMSettings&,int);
+
+void LICHEMCloseScratch();
+
+bool LICHEMCopyFile(const string&,const string&);
+
+vector<int> LICHEMCoreList();
+
 template<typename T> int LICHEMCount(T);
 
 double LICHEMDensity(vector<QMMMAtom>&,QMMMSettings&);
 
+string LICHEMDestName(const string&,const string&);
+
 void LICHEMDFP(vector<QMMMAtom>&,QMMMSettings&,int);
 
 void LICHEMErrorChecker(QMMMSettings&);
@@ -157,24 +218,89 @@ double LICHEMFactorial(int);
 
 void LICHEMFixSciNot(string&);
 
-template<typename T> string LICHEMFormFloat(T,int);
+template<typename T> FloatText LICHEMFormFloat(T,int);
+
+int LICHEMFormFloat(char*,double,int);
+
+int LICHEMFormFloatFix(char*,int,int);
 
 VectorXd LICHEMFreq(vector<QMMMAtom>&,MatrixXd&,QMMMSettings&,int,int&);
 
+string LICHEMFullPath(const string&);
+
+string LICHEMJobDir(int);
+
+int LICHEMJobID(QMMMSettings&,int);
+
 void LICHEMLowerText(string&);
 
+bool LICHEMMakeDir(const string&);
+
+void LICHEMMakeScratch(QMMMSettings&);
+
+vector<string> LICHEMMatchFiles(const string&);
+
+double LICHEMMMEnergy(vector<QMMMAtom>&,QMMMSettings&,int);
+
+double LICHEMMMForces(vector<QMMMAtom>&,VectorXd&,QMMMSettings&,int);
+
+bool LICHEMMMUsesQMCharges(QMMMSettings&);
+
+bool LICHEMMoveFile(const string&,const string&);
+
 void LICHEMNEB(vector<QMMMAtom>&,QMMMSettings&,int);
 
+bool LICHEMPinCores(const vector<int>&);
+
 void LICHEMPrintSettings(vector<QMMMAtom>&,QMMMSettings&);
 
+double LICHEMQMEnergy(vector<QMMMAtom>&,QMMMSettings&,int);
+
+double LICHEMQMForces(vector<QMMMAtom>&,VectorXd&,QMMMSettings&,int);
+
 void LICHEMQuickMin(vector<QMMMAtom>&,QMMMSettings&,int);
 
+string LICHEMReadFile(const string&);
+
+void LICHEMRemoveDir(const string&);
+
+void LICHEMRemoveFiles(const string&);
+
+int LICHEMRemoveTreeItem(const char*,const struct stat*,int,struct FTW*);
+
+void LICHEMRingEnergies(vector<QMMMAtom>&,vector<QMMMAtom>&,QMMMSettings&,
+                        const vector<int>&,vector<double>&,vector<double>&);
+
+void LICHEMSelfTest(int&,char**&);
+
+int LICHEMSpawn(const string&,const string&,const string&,const string&,
+                double&);
+
+int LICHEMSpawn(const string&,const string&,const string&,const string&);
+
+vector<string> LICHEMSplitArgs(const string&);
+
+int LICHEMStartProc(pid_t&,vector<char*>&,const string&,const string&,
+                    const string&);
+
 void LICHEMSteepest(vector<QMMMAtom>&,QMMMSettings&,int);
 
 void LICHEMUpperText(string&);
 
 bool MCMove(vector<QMMMAtom>&,QMMMSettings&,double&);
 
+void MCNormalModeMove(vector<QMMMAtom>&,QMMMSettings&,MCUndoLog&,int);
+
+void MCPrintLine(QMMMSettings&,stringstream&);
+
+void MCRunChain(vector<QMMMAtom>&,QMMMSettings&,fstream&);
+
+void MCSeedStreams(QMMMSettings&,int);
+
+void MCStagingMove(vector<QMMMAtom>&,QMMMSettings&,MCUndoLog&,int);
+
+VectorXd MinImageDist2(VectorXd&,VectorXd&,VectorXd&);
+
 VectorXd NEBTangent(VectorXd&,VectorXd&,QMMMSettings&,int);
 
 void NWChemCharges(vector<QMMMAtom>&,QMMMSettings&,int);
@@ -197,14 +323,26 @@ void PathLinInterpolate(int&,char**&);
 
 void PBCCenter(vector<QMMMAtom>&,QMMMSettings&);
 
+void PIContractRing(vector<QMMMAtom>&,vector<QMMMAtom>&,QMMMSettings&);
+
+void PIUnwrapRing(QMMMAtom&,QMMMSettings&,VectorXd&,VectorXd&,VectorXd&);
+
 void PrintFancyTitle();
 
 void PrintLapin();
 
+void PrintMCChains(vector<QMMMSettings>&);
+
+void PrintMCStats(QMMMSettings&);
+
 void Print_traj(vector<QMMMAtom>&,fstream&,QMMMSettings&);
 
+void Print_traj(vector<QMMMAtom>&,fstream&,QMMMSettings&,long long,double);
+
 void PSI4Charges(vector<QMMMAtom>&,QMMMSettings&,int);
 
+void PSI4Cleanup(int);
+
 double PSI4Energy(vector<QMMMAtom>&,QMMMSettings&,int);
 
 double PSI4Forces(vector<QMMMAtom>&,VectorXd&,QMMMSettings&,int);
@@ -215,6 +353,8 @@ double PSI4Opt(vector<QMMMAtom>&,QMMMSettings&,int);
 
 void ReadArgs(int&,char**&,fstream&,fstream&,fstream&,fstream&);
 
+bool ReadBinTrajStruct(string,vector<string>&,vector<Coord>&);
+
 void ReadLICHEMInput(fstream&,fstream&,fstream&,
                      vector<QMMMAtom>&,QMMMSettings&);
 
@@ -222,12 +362,16 @@ void ReorderQMPBBA(int&,char**&);
 
 void RotateTINKCharges(vector<QMMMAtom>&,int);
 
+void SetRegionLists(vector<QMMMAtom>&);
+
 OctCharges SphHarm2Charges(RedMpole);
 
 void SplitPathTraj(int&,char**&);
 
 void TINK2LICHEM(int&,char**&);
 
+void TINKERCopyKey(const string&);
+
 void TINKERDynamics(vector<QMMMAtom>&,QMMMSettings&,int);
 
 double TINKEREnergy(vector<QMMMAtom>&,QMMMSettings&,int);
@@ -246,8 +390,14 @@ double TINKERPolEnergy(vector<QMMMAtom>&,QMMMSettings&,int);
 
 double TINKERPolForces(vector<QMMMAtom>&,VectorXd&,QMMMSettings&,int);
 
+void TINKERPolGradient(vector<QMMMAtom>&,QMMMSettings&,int);
+
+bool TINKERPolShared(QMMMSettings&,int);
+
 vector<int> TraceBoundary(vector<QMMMAtom>&,int);
 
+void WriteBinTrajFrame(BinTraj&,fstream&);
+
 void WriteChargeFile(vector<QMMMAtom>&,QMMMSettings&,int);
 
 void WriteGauInput(vector<QMMMAtom>&,string,QMMMSettings&,int);
@@ -276,6 +426,7 @@ void WriteQMConnect(int&,char**&);
 #include "Multipoles.cpp"
 #include "Optimizers.cpp"
 #include "Path_integral.cpp"
+#include "Process_ctrl.cpp"
 #include "Reaction_path.cpp"
 #include "Struct_writer.cpp"
 #include "Text_format.cpp"
@@ -29,6 +29,13 @@ namespace LICHEMOpts
   const double CentRatio= 5.0; //Scales step size for path-integral centroids
   const int Acc_Check = 2000; //Eq. Monte Carlo steps before checking accratio
 
+  //Uses of the random number streams
+  const int RandMoves = 0; //Monte Carlo moves and step sizes
+  const int RandBeads = 1; //Bead displacements
+  const int RandStart = 2; //Initial path-integral beads
+  const int RandFrames = 3; //Local frames of Z-only multipoles
+  const int RandOutput = 4; //Messages which do not change the results
+
   //Move Probabilities for PIMC
   /*
 
@@ -50,6 +57,14 @@ namespace LICHEMOpts
   double BeadProb = 0.60; //Probability to move all beads for an atom
   double CentProb = 0.50; //Probability to move a centroid
   double VolProb = 0.35; //Volume change probability
+
+  //Types of Monte Carlo moves (for the statistics)
+  const int MoveCent = 0; //Centroid translation
+  const int MoveBead = 1; //Uniform displacement of all beads of an atom
+  const int MoveStage = 2; //Staging move for part of a ring polymer
+  const int MoveModes = 3; //Normal mode move for a ring polymer
+  const int MoveVol = 4; //Volume change
+  const int Nmoves = 5; //Number of types of moves
 };
 
 #endif
@@ -0,0 +1,421 @@
+/*
+
+###############################################################################
+#                                                                             #
+#                 LICHEM: Layered Interacting CHEmical Models                 #
+#                              By: Eric G. Kratz                              #
+#                                                                             #
+#                      Symbiotic Computational Chemistry                      #
+#                                                                             #
+###############################################################################
+
+ Hard coded element data for the periodic table. Atomic symbols are matched
+ with a switch on their characters instead of searching the table.
+
+*/
+
+//Make including safe
+#ifndef LICHEM_PERIODIC_TABLE
+#define LICHEM_PERIODIC_TABLE
+
+//Namespace for element data
+namespace LICHEMElements
+{
+  //Element properties
+  struct ElemProps
+  {
+    const char* Typ; //Atomic symbol
+    double CovRadius; //Covalent radius
+    double vdWRadius; //Van der Waals radius
+    double AtMass; //Atomic mass (amu)
+  };
+
+  //Number of elements in the table
+  constexpr int Nelements = 118;
+
+  //Element data, the index is the atomic number minus one
+  //NB: Radii are default values, masses are from NIST (2015) when available
+  constexpr ElemProps Elements[Nelements] =
+  {
+    {"H",1.0,1.0,1.00784}, //Hydrogen, 1
+    {"He",1.0,1.0,4.002602}, //Helium, 2
+    {"Li",1.0,1.0,6.938}, //Lithium, 3
+    {"Be",1.0,1.0,9.0121831}, //Berylium, 4
+    {"B",1.0,1.0,10.806}, //Boron, 5
+    {"C",1.0,1.0,12.0096}, //Carbon, 6
+    {"N",1.0,1.0,14.00643}, //Nitrogen, 7
+    {"O",1.0,1.0,15.99903}, //Oxygen, 8
+    {"F",1.0,1.0,18.998403163}, //Fluorine, 9
+    {"Ne",1.0,1.0,20.1797}, //Neon, 10
+    {"Na",1.0,1.0,22.98976928}, //Sodium, 11
+    {"Mg",1.0,1.0,24.304}, //Magnesium, 12
+    {"Al",1.0,1.0,26.9815385}, //Aluminum, 13
+    {"Si",1.0,1.0,28.084}, //Silicon, 14
+    {"P",1.0,1.0,30.973761998}, //Phosphorus, 15
+    {"S",1.0,1.0,32.059}, //Sulfur, 16
+    {"Cl",1.0,1.0,35.446}, //Chlorine, 17
+    {"Ar",1.0,1.0,39.948}, //Argon, 18
+    {"K",1.0,1.0,39.0983}, //Potassium, 19
+    {"Ca",1.0,1.0,40.078}, //Calcium, 20
+    {"Sc",1.0,1.0,44.955908}, //Scandium, 21
+    {"Ti",1.0,1.0,47.867}, //Titanium, 22
+    {"V",1.0,1.0,50.9415}, //Vanadium, 23
+    {"Cr",1.0,1.0,51.9961}, //Chromium, 24
+    {"Mn",1.0,1.0,54.938044}, //Manganese, 25
+    {"Fe",1.0,1.0,55.845}, //Iron, 26
+    {"Co",1.0,1.0,58.933194}, //Cobalt, 27
+    {"Ni",1.0,1.0,58.6934}, //Nickel, 28
+    {"Cu",1.0,1.0,63.546}, //Copper, 29
+    {"Zn",1.0,1.0,65.38}, //Zinc, 30
+    {"Ga",1.0,1.0,69.723}, //Gallium, 31
+    {"Ge",1.0,1.0,72.630}, //Germanium, 32
+    {"As",1.0,1.0,74.921595}, //Arsenic, 33
+    {"Se",1.0,1.0,78.971}, //Selenium, 34
+    {"Br",1.0,1.0,79.901}, //Bromine, 35
+    {"Kr",1.0,1.0,83.798}, //Krypton, 36
+    {"Rb",1.0,1.0,85.4678}, //Rubidium, 37
+    {"Sr",1.0,1.0,87.62}, //Strontium, 38
+    {"Y",1.0,1.0,88.90584}, //Yttrium, 39
+    {"Zr",1.0,1.0,91.224}, //Zirconium, 40
+    {"Nb",1.0,1.0,92.90637}, //Niobium, 41
+    {"Mo",1.0,1.0,95.95}, //Molybdenum, 42
+    {"Tc",1.0,1.0,98}, //Technetium, 43
+    {"Ru",1.0,1.0,101.07}, //Ruthenium, 44
+    {"Rh",1.0,1.0,102.90550}, //Rhodium, 45
+    {"Pd",1.0,1.0,106.42}, //Palladium, 46
+    {"Ag",1.0,1.0,107.8682}, //Silver, 47
+    {"Cd",1.0,1.0,112.414}, //Cadmium, 48
+    {"In",1.0,1.0,114.818}, //Indium, 49
+    {"Sn",1.0,1.0,118.710}, //Tin, 50
+    {"Sb",1.0,1.0,121.760}, //Antimony, 51
+    {"Te",1.0,1.0,127.60}, //Tellurium, 52
+    {"I",1.0,1.0,126.90447}, //Iodine, 53
+    {"Xe",1.0,1.0,131.293}, //Xenon, 54
+    {"Cs",1.0,1.0,132.90545196}, //Caesium, 55
+    {"Ba",1.0,1.0,137.327}, //Barium, 56
+    {"La",1.0,1.0,138.90547}, //Lanthanum, 57
+    {"Ce",1.0,1.0,140.116}, //Cerium, 58
+    {"Pr",1.0,1.0,140.90766}, //Praseodymium, 59
+    {"Nd",1.0,1.0,144.242}, //Neodymium, 60
+    {"Pm",1.0,1.0,145}, //Promethium, 61
+    {"Sm",1.0,1.0,150.36}, //Samarium, 62
+    {"Eu",1.0,1.0,151.964}, //Europium, 63
+    {"Gd",1.0,1.0,157.25}, //Gadolinium, 64
+    {"Tb",1.0,1.0,158.92535}, //Terbium, 65
+    {"Dy",1.0,1.0,162.500}, //Dysprosium, 66
+    {"Ho",1.0,1.0,164.93033}, //Holmium, 67
+    {"Er",1.0,1.0,167.259}, //Erbium, 68
+    {"Tm",1.0,1.0,168.93422}, //Thulium, 69
+    {"Yb",1.0,1.0,173.054}, //Ytterbium, 70
+    {"Lu",1.0,1.0,174.9668}, //Lutetium, 71
+    {"Hf",1.0,1.0,178.49}, //Hafnium, 72
+    {"Ta",1.0,1.0,180.94788}, //Tantalum, 73
+    {"W",1.0,1.0,183.84}, //Tungsten, 74
+    {"Re",1.0,1.0,186.207}, //Rhenium, 75
+    {"Os",1.0,1.0,190.23}, //Osmium, 76
+    {"Ir",1.0,1.0,192.217}, //Iridium, 77
+    {"Pt",1.0,1.0,195.084}, //Platinum, 78
+    {"Au",1.0,1.0,196.966569}, //Gold, 79
+    {"Hg",1.0,1.0,200.592}, //Mercury, 80
+    {"Tl",1.0,1.0,204.382}, //Thallium, 81
+    {"Pb",1.0,1.0,207.2}, //Lead, 82
+    {"Bi",1.0,1.0,208.98040}, //Bismuth, 83
+    {"Po",1.0,1.0,209}, //Polonium, 84
+    {"At",1.0,1.0,210}, //Astatine, 85
+    {"Rn",1.0,1.0,222}, //Radon, 86
+    {"Fr",1.0,1.0,223}, //Francium, 87
+    {"Ra",1.0,1.0,226}, //Radium, 88
+    {"Ac",1.0,1.0,227}, //Actinium, 89
+    {"Th",1.0,1.0,232.0377}, //Thorium, 90
+    {"Pa",1.0,1.0,231.03588}, //Protactium, 91
+    {"U",1.0,1.0,238.02891}, //Uranium, 92
+    {"Np",1.0,1.0,237}, //Neptunium, 93
+    {"Pu",1.0,1.0,244}, //Plutonium, 94
+    {"Am",1.0,1.0,1.0}, //Americium, 95
+    {"Cm",1.0,1.0,1.0}, //Curium, 96
+    {"Bk",1.0,1.0,1.0}, //Berkelium, 97
+    {"Cf",1.0,1.0,1.0}, //Californium, 98
+    {"Es",1.0,1.0,1.0}, //Einsteinium, 99
+    {"Fm",1.0,1.0,1.0}, //Fermium, 100
+    {"Md",1.0,1.0,1.0}, //Mendelevium, 101
+    {"No",1.0,1.0,1.0}, //Nobelium, 102
+    {"Lr",1.0,1.0,1.0}, //Lawrencium, 103
+    {"Rf",1.0,1.0,1.0}, //Rutherfordium, 104
+    {"Db",1.0,1.0,1.0}, //Dubnium, 105
+    {"Sg",1.0,1.0,1.0}, //Seaborgium, 106
+    {"Bh",1.0,1.0,1.0}, //Bohrium, 107
+    {"Hs",1.0,1.0,1.0}, //Hasium, 108
+    {"Mt",1.0,1.0,1.0}, //Meitnerium, 109
+    {"Ds",1.0,1.0,1.0}, //Darmstadtium, 110
+    {"Rg",1.0,1.0,1.0}, //Roentgenium, 111
+    {"Cn",1.0,1.0,1.0}, //Copernicium, 112
+    {"",1.0,1.0,1.0}, //Num. 113
+    {"Fl",1.0,1.0,1.0}, //Flerovium, 114
+    {"",1.0,1.0,1.0}, //Num. 115
+    {"Lv",1.0,1.0,1.0}, //Livermorium, 116
+    {"",1.0,1.0,1.0}, //Num. 117
+    {"",1.0,1.0,1.0} //Num. 118
+  };
+
+  //Functions to find the atomic number
+  constexpr int SymbolToZ(char c1, char c2)
+  {
+    //Returns the atomic number of a one or two character symbol, or zero
+    //if the symbol is not in the table
+    switch (c1)
+    {
+      case 'A':
+        switch (c2)
+        {
+          case 'l': return 13; //Al
+          case 'r': return 18; //Ar
+          case 's': return 33; //As
+          case 'g': return 47; //Ag
+          case 'u': return 79; //Au
+          case 't': return 85; //At
+          case 'c': return 89; //Ac
+          case 'm': return 95; //Am
+        }
+        break;
+      case 'B':
+        switch (c2)
+        {
+          case 'e': return 4; //Be
+          case 0: return 5; //B
+          case 'r': return 35; //Br
+          case 'a': return 56; //Ba
+          case 'i': return 83; //Bi
+          case 'k': return 97; //Bk
+          case 'h': return 107; //Bh
+        }
+        break;
+      case 'C':
+        switch (c2)
+        {
+          case 0: return 6; //C
+          case 'l': return 17; //Cl
+          case 'a': return 20; //Ca
+          case 'r': return 24; //Cr
+          case 'o': return 27; //Co
+          case 'u': return 29; //Cu
+          case 'd': return 48; //Cd
+          case 's': return 55; //Cs
+          case 'e': return 58; //Ce
+          case 'm': return 96; //Cm
+          case 'f': return 98; //Cf
+          case 'n': return 112; //Cn
+        }
+        break;
+      case 'D':
+        switch (c2)
+        {
+          case 'y': return 66; //Dy
+          case 'b': return 105; //Db
+          case 's': return 110; //Ds
+        }
+        break;
+      case 'E':
+        switch (c2)
+        {
+          case 'u': return 63; //Eu
+          case 'r': return 68; //Er
+          case 's': return 99; //Es
+        }
+        break;
+      case 'F':
+        switch (c2)
+        {
+          case 0: return 9; //F
+          case 'e': return 26; //Fe
+          case 'r': return 87; //Fr
+          case 'm': return 100; //Fm
+          case 'l': return 114; //Fl
+        }
+        break;
+      case 'G':
+        switch (c2)
+        {
+          case 'a': return 31; //Ga
+          case 'e': return 32; //Ge
+          case 'd': return 64; //Gd
+        }
+        break;
+      case 'H':
+        switch (c2)
+        {
+          case 0: return 1; //H
+          case 'e': return 2; //He
+          case 'o': return 67; //Ho
+          case 'f': return 72; //Hf
+          case 'g': return 80; //Hg
+          case 's': return 108; //Hs
+        }
+        break;
+      case 'I':
+        switch (c2)
+        {
+          case 'n': return 49; //In
+          case 0: return 53; //I
+          case 'r': return 77; //Ir
+        }
+        break;
+      case 'K':
+        switch (c2)
+        {
+          case 0: return 19; //K
+          case 'r': return 36; //Kr
+        }
+        break;
+      case 'L':
+        switch (c2)
+        {
+          case 'i': return 3; //Li
+          case 'a': return 57; //La
+          case 'u': return 71; //Lu
+          case 'r': return 103; //Lr
+          case 'v': return 116; //Lv
+        }
+        break;
+      case 'M':
+        switch (c2)
+        {
+          case 'g': return 12; //Mg
+          case 'n': return 25; //Mn
+          case 'o': return 42; //Mo
+          case 'd': return 101; //Md
+          case 't': return 109; //Mt
+        }
+        break;
+      case 'N':
+        switch (c2)
+        {
+          case 0: return 7; //N
+          case 'e': return 10; //Ne
+          case 'a': return 11; //Na
+          case 'i': return 28; //Ni
+          case 'b': return 41; //Nb
+          case 'd': return 60; //Nd
+          case 'p': return 93; //Np
+          case 'o': return 102; //No
+        }
+        break;
+      case 'O':
+        switch (c2)
+        {
+          case 0: return 8; //O
+          case 's': return 76; //Os
+        }
+        break;
+      case 'P':
+        switch (c2)
+        {
+          case 0: return 15; //P
+          case 'd': return 46; //Pd
+          case 'r': return 59; //Pr
+          case 'm': return 61; //Pm
+          case 't': return 78; //Pt
+          case 'b': return 82; //Pb
+          case 'o': return 84; //Po
+          case 'a': return 91; //Pa
+          case 'u': return 94; //Pu
+        }
+        break;
+      case 'R':
+        switch (c2)
+        {
+          case 'b': return 37; //Rb
+          case 'u': return 44; //Ru
+          case 'h': return 45; //Rh
+          case 'e': return 75; //Re
+          case 'n': return 86; //Rn
+          case 'a': return 88; //Ra
+          case 'f': return 104; //Rf
+          case 'g': return 111; //Rg
+        }
+        break;
+      case 'S':
+        switch (c2)
+        {
+          case 'i': return 14; //Si
+          case 0: return 16; //S
+          case 'c': return 21; //Sc
+          case 'e': return 34; //Se
+          case 'r': return 38; //Sr
+          case 'n': return 50; //Sn
+          case 'b': return 51; //Sb
+          case 'm': return 62; //Sm
+          case 'g': return 106; //Sg
+        }
+        break;
+      case 'T':
+        switch (c2)
+        {
+          case 'i': return 22; //Ti
+          case 'c': return 43; //Tc
+          case 'e': return 52; //Te
+          case 'b': return 65; //Tb
+          case 'm': return 69; //Tm
+          case 'a': return 73; //Ta
+          case 'l': return 81; //Tl
+          case 'h': return 90; //Th
+        }
+        break;
+      case 'U':
+        switch (c2)
+        {
+          case 0: return 92; //U
+        }
+        break;
+      case 'V':
+        switch (c2)
+        {
+          case 0: return 23; //V
+        }
+        break;
+      case 'W':
+        switch (c2)
+        {
+          case 0: return 74; //W
+        }
+        break;
+      case 'X':
+        switch (c2)
+        {
+          case 'e': return 54; //Xe
+        }
+        break;
+      case 'Y':
+        switch (c2)
+        {
+          case 0: return 39; //Y
+          case 'b': return 70; //Yb
+        }
+        break;
+      case 'Z':
+        switch (c2)
+        {
+          case 'n': return 30; //Zn
+          case 'r': return 40; //Zr
+        }
+        break;
+    }
+    return 0;
+  };
+
+  inline int SymbolToZ(const string& AtName)
+  {
+    //Returns the atomic number of an atomic symbol, or zero
+    if ((AtName.size() < 1) or (AtName.size() > 2))
+    {
+      return 0;
+    }
+    if (AtName.size() == 1)
+    {
+      return SymbolToZ(AtName[0],0);
+    }
+    return SymbolToZ(AtName[0],AtName[1]);
+  };
+};
+
+#endif
+
@@ -18,11 +18,149 @@
 */
 
 //Trajectory analysis functions
+//Binary trajectory format (native byte order):
+// File header: "LICHEMBT", int version (1), int Natoms, int Nbeads,
+//  int bytes per coordinate (4 or 8), double compression resolution (Ang),
+//  and Natoms atom types stored as four characters
+// Frame chunks: "FRAM", long long chunk size (bytes after this field),
+//  long long step, double energy (eV), double Lx, double Ly, double Lz,
+//  and the coordinates of all beads of atom 0, then atom 1, etc
+// Frame index (written by CloseTraj): "INDX", long long Nframes, Nframes
+//  long long frame offsets, long long index offset, and "LICHEMIX"
+//NB: Compressed coordinates are rounded to the resolution and saved as
+//variable length integers. Each bead is stored as the difference from the
+//previous bead of the same atom, which needs one or two bytes for most beads.
+template<typename T> void BinTrajAppend(string& buffer, T val)
+{
+  //Function to append the bytes of a value to a binary buffer
+  buffer.append((char*)&val,sizeof(T));
+  return;
+};
+
 void Print_traj(vector<QMMMAtom>& Struct, fstream& traj,
                 QMMMSettings& QMMMOpts)
 {
   //Function to print the trajectory or restart files for all beads
+  Print_traj(Struct,traj,QMMMOpts,-1,nan(""));
+  return;
+};
+
+void Print_traj(vector<QMMMAtom>& Struct, fstream& traj,
+                QMMMSettings& QMMMOpts, long long Step, double Eframe)
+{
+  //Function to print the trajectory or restart files for all beads
+  //NB: The step and energy are only saved in binary trajectories. A
+  //negative step is replaced by the frame number.
   stringstream call; //Only used to save traj stream settings
+  if (QMMMOpts.BinTraj)
+  {
+    //Print a binary frame
+    vector<long long>& Frames = BinTrajFrames[&traj]; //Frame offsets
+    long long Pos = (long long)traj.tellp(); //Start of the chunk
+    string buffer; //Data for the file
+    if (Pos <= 0)
+    {
+      //Start a new file
+      int Nbytes = QMMMOpts.TrajBytes;
+      if (QMMMOpts.TrajQuant > 0)
+      {
+        Nbytes = 0;
+      }
+      Frames.clear();
+      buffer.append("LICHEMBT",8);
+      BinTrajAppend(buffer,(int)1);
+      BinTrajAppend(buffer,Natoms);
+      BinTrajAppend(buffer,QMMMOpts.Nbeads);
+      BinTrajAppend(buffer,Nbytes);
+      BinTrajAppend(buffer,QMMMOpts.TrajQuant);
+      for (int i=0;i<Natoms;i++)
+      {
+        //Save the atom type as four characters
+        char Typ[4] = {0,0,0,0};
+        Struct[i].QMTyp.copy(Typ,4);
+        buffer.append(Typ,4);
+      }
+      Pos = buffer.size();
+    }
+    if (Step < 0)
+    {
+      Step = Frames.size();
+    }
+    Frames.push_back(Pos);
+    //Save the frame header
+    long long SizePos; //Location of the chunk size
+    buffer.append("FRAM",4);
+    SizePos = buffer.size();
+    BinTrajAppend(buffer,(long long)0);
+    BinTrajAppend(buffer,Step);
+    BinTrajAppend(buffer,Eframe);
+    BinTrajAppend(buffer,Lx);
+    BinTrajAppend(buffer,Ly);
+    BinTrajAppend(buffer,Lz);
+    //Save the coordinates
+    if (QMMMOpts.TrajQuant > 0)
+    {
+      //Compressed coordinates
+      for (int i=0;i<Natoms;i++)
+      {
+        long long Old[3] = {0,0,0}; //Previous bead on the grid
+        for (int j=0;j<QMMMOpts.Nbeads;j++)
+        {
+          long long New[3]; //Current bead on the grid
+          New[0] = llround(Struct[i].P[j].x/QMMMOpts.TrajQuant);
+          New[1] = llround(Struct[i].P[j].y/QMMMOpts.TrajQuant);
+          New[2] = llround(Struct[i].P[j].z/QMMMOpts.TrajQuant);
+          for (int k=0;k<3;k++)
+          {
+            //Zigzag encode the sign so small differences use few bytes
+            long long Diff = New[k]-Old[k];
+            unsigned long long Val = (((unsigned long long)Diff) << 1);
+            Val ^= (unsigned long long)(Diff >> 63);
+            //Write seven bits at a time
+            while (Val >= 128)
+            {
+              buffer += (char)((Val & 127) | 128);
+              Val >>= 7;
+            }
+            buffer += (char)Val;
+            Old[k] = New[k];
+          }
+        }
+      }
+    }
+    else if (QMMMOpts.TrajBytes == 4)
+    {
+      //Single precision coordinates
+      for (int i=0;i<Natoms;i++)
+      {
+        for (int j=0;j<QMMMOpts.Nbeads;j++)
+        {
+          BinTrajAppend(buffer,(float)Struct[i].P[j].x);
+          BinTrajAppend(buffer,(float)Struct[i].P[j].y);
+          BinTrajAppend(buffer,(float)Struct[i].P[j].z);
+        }
+      }
+    }
+    else
+    {
+      //Double precision coordinates
+      for (int i=0;i<Natoms;i++)
+      {
+        for (int j=0;j<QMMMOpts.Nbeads;j++)
+        {
+          BinTrajAppend(buffer,Struct[i].P[j].x);
+          BinTrajAppend(buffer,Struct[i].P[j].y);
+          BinTrajAppend(buffer,Struct[i].P[j].z);
+        }
+      }
+    }
+    //Set the chunk size and write the data
+    long long ChunkSize = buffer.size()-SizePos-sizeof(long long);
+    memcpy(&buffer[SizePos],&ChunkSize,sizeof(long long));
+    traj.write(buffer.c_str(),buffer.size());
+    traj.flush(); //Force printing
+    return;
+  }
   //Print XYZ file
   int Ntot = QMMMOpts.Nbeads*Natoms; //Total number of particles
   traj << Ntot << '\n' << '\n'; //Print number of particles and a blank line
@@ -43,6 +181,300 @@ void Print_traj(vector<QMMMAtom>& Struct, fstream& traj,
   return;
 };
 
+void CloseTraj(fstream& traj)
+{
+  //Function to write the frame index of a binary trajectory and close it
+  map<fstream*,vector<long long> >::iterator Index;
+  Index = BinTrajFrames.find(&traj);
+  if (Index != BinTrajFrames.end())
+  {
+    if (traj.is_open() and traj.good())
+    {
+      //Save the offsets of all frames at the end of the file
+      vector<long long>& Frames = Index->second;
+      long long IndexPos = (long long)traj.tellp();
+      string buffer; //Data for the file
+      buffer.append("INDX",4);
+      BinTrajAppend(buffer,(long long)Frames.size());
+      for (unsigned int i=0;i<Frames.size();i++)
+      {
+        BinTrajAppend(buffer,Frames[i]);
+      }
+      BinTrajAppend(buffer,IndexPos);
+      buffer.append("LICHEMIX",8);
+      traj.write(buffer.c_str(),buffer.size());
+    }
+    BinTrajFrames.erase(Index);
+  }
+  traj.close();
+  return;
+};
+
+void WriteBinTrajFrame(BinTraj& Traj, fstream& ofile)
+{
+  //Function to print the last frame read from a binary trajectory as XYZ
+  int Ntot = Traj.Nbeads*Traj.Natoms; //Total number of particles
+  ofile << Ntot << '\n' << '\n'; //Print number of particles and a blank line
+  for (int i=0;i<Ntot;i++)
+  {
+    //Print the same text as Print_traj
+    ofile << setw(3) << left << Traj.Typs[i/Traj.Nbeads] << " ";
+    ofile << LICHEMFormFloat(Traj.P[i].x,16) << " ";
+    ofile << LICHEMFormFloat(Traj.P[i].y,16) << " ";
+    ofile << LICHEMFormFloat(Traj.P[i].z,16) << '\n';
+  }
+  return;
+};
+
+bool ReadBinTrajStruct(string filename, vector<string>& AtTyps,
+                       vector<Coord>& Pos)
+{
+  //Function to read the first bead of the last frame of a binary trajectory
+  //NB: Returns 0 if the file is not a binary trajectory
+  BinTraj Traj;
+  if (!Traj.Open(filename))
+  {
+    return 0;
+  }
+  if (!Traj.ReadFrame(Traj.Frames.size()-1))
+  {
+    //Escape if the file is empty
+    cout << "Error: No frames in " << filename << "!!!";
+    cout << '\n' << '\n';
+    exit(0);
+  }
+  Natoms = Traj.Natoms;
+  for (int i=0;i<Natoms;i++)
+  {
+    AtTyps.push_back(Traj.Typs[i]);
+    Pos.push_back(Traj.P[i*Traj.Nbeads]);
+  }
+  Traj.Close();
+  return 1;
+};
+
+void BinTraj2XYZ(int& argc, char**& argv)
+{
+  //Function to convert a binary trajectory to an XYZ trajectory
+  stringstream call; //Stream for system calls and reading/writing files
+  string dummy; //Generic string
+  string trajfilename = "N/A"; //Name of the binary trajectory
+  fstream ofile; //Output file
+  BinTraj Traj; //Binary trajectory
+  int FrameID = -1; //Frame to convert, all frames if negative
+  int ct; //Generic counter
+  //Read settings
+  for (int i=0;i<argc;i++)
+  {
+    dummy = string(argv[i]);
+    //Check binary trajectory file
+    if ((dummy == "-traj") and ((i+1) < argc))
+    {
+      trajfilename = string(argv[i+1]);
+    }
+    //Check frame
+    if ((dummy == "-f") and ((i+1) < argc))
+    {
+      stringstream file;
+      file << argv[i+1]; //Save to the stream
+      file >> FrameID; //Change to an int
+    }
+  }
+  if (!Traj.Open(trajfilename))
+  {
+    cout << "Error: Could not open binary trajectory ";
+    cout << trajfilename << "!!!";
+    cout << '\n' << '\n';
+    exit(0);
+  }
+  //Open new trajectory file
+  call.str("");
+  call << "TrajStruct.xyz";
+  ct = 0; //Start counting at the second file
+  while (CheckFile(call.str()))
+  {
+    //Avoids overwriting files
+    ct += 1; //Increase file counter
+    call.str(""); //Change file name
+    call << "TrajStruct_";
+    call << ct << ".xyz";
+  }
+  ofile.open(call.str().c_str(),ios_base::out);
+  cout << '\n';
+  cout << "Binary trajectory: " << trajfilename << '\n';
+  cout << " Atoms: " << Traj.Natoms << '\n';
+  cout << " Beads: " << Traj.Nbeads << '\n';
+  cout << " Frames: " << Traj.Frames.size() << '\n';
+  cout << "Trajectory output: " << call.str();
+  cout << '\n' << '\n';
+  //Write frames
+  for (int i=0;i<(int)Traj.Frames.size();i++)
+  {
+    if ((FrameID < 0) or (FrameID == i))
+    {
+      if (!Traj.ReadFrame(i))
+      {
+        cout << "Error: Frame " << i << " is damaged!!!";
+        cout << '\n' << '\n';
+        break;
+      }
+      WriteBinTrajFrame(Traj,ofile);
+    }
+  }
+  //Close files and exit
+  Traj.Close();
+  ofile.flush();
+  ofile.close();
+  exit(0);
+  return;
+};
+
+bool BinTrajSelfTest(int Nbytes, double Quant)
+{
+  //Function to compare a converted binary trajectory with Print_traj
+  //NB: The coordinates are rounded so that the binary file saves them
+  //exactly, so the converted text must match the XYZ trajectory. The test
+  //is repeated without the frame index, which makes BinTraj find the frames
+  //from the chunk headers.
+  int Nframes = 3; //Number of frames
+  Natoms = 5;
+  QMMMSettings QMMMOpts; //Trajectory settings
+  QMMMOpts.Nbeads = 4;
+  QMMMOpts.TrajBytes = Nbytes;
+  QMMMOpts.TrajQuant = Quant;
+  vector<QMMMAtom> Struct(Natoms); //Test structure
+  string Typs[5] = {"C","H","O","N","Cl"}; //Atom types
+  for (int i=0;i<Natoms;i++)
+  {
+    Struct[i].QMTyp = Typs[i];
+    Struct[i].P.resize(QMMMOpts.Nbeads);
+  }
+  RandomStream TestRand; //Reproducible coordinates
+  TestRand.Seed(1,0,0,0);
+  //Write the trajectories
+  string XYZName = "LICHM_TrajTest.xyz"; //XYZ trajectory
+  string BinName = "LICHM_TrajTest.bin"; //Binary trajectory
+  string CutName = "LICHM_TrajTest_NoIndex.bin"; //Trajectory without index
+  string OutName = "LICHM_TrajTest_Conv.xyz"; //Converted trajectory
+  fstream xyzfile,binfile,ofile; //Files
+  xyzfile.open(XYZName.c_str(),ios_base::out);
+  binfile.open(BinName.c_str(),ios_base::out|ios_base::binary);
+  for (int k=0;k<Nframes;k++)
+  {
+    for (int i=0;i<Natoms;i++)
+    {
+      for (int j=0;j<QMMMOpts.Nbeads;j++)
+      {
+        double Pos[3]; //New position
+        for (int m=0;m<3;m++)
+        {
+          Pos[m] = 40*(TestRand.Uniform()-0.5);
+          if (Quant > 0)
+          {
+            //Move to the grid
+            Pos[m] = llround(Pos[m]/Quant)*Quant;
+          }
+          else if (Nbytes == 4)
+          {
+            //Remove the extra digits
+            Pos[m] = (float)Pos[m];
+          }
+        }
+        Struct[i].P[j].x = Pos[0];
+        Struct[i].P[j].y = Pos[1];
+        Struct[i].P[j].z = Pos[2];
+      }
+    }
+    QMMMOpts.BinTraj = 0;
+    Print_traj(Struct,xyzfile,QMMMOpts);
+    QMMMOpts.BinTraj = 1;
+    Print_traj(Struct,binfile,QMMMOpts,k,-1.0*k);
+  }
+  xyzfile.close();
+  CloseTraj(binfile);
+  //Copy the binary trajectory without the frame index
+  string Data = LICHEMReadFile(BinName); //Binary file
+  long long IndexPos = 0; //Start of the frame index
+  if (Data.size() > 16)
+  {
+    memcpy(&IndexPos,&Data[Data.size()-16],sizeof(long long));
+  }
+  ofile.open(CutName.c_str(),ios_base::out|ios_base::binary);
+  ofile.write(Data.c_str(),IndexPos);
+  ofile.close();
+  //Convert both binary files
+  bool Pass = (IndexPos > 0);
+  string XYZText = LICHEMReadFile(XYZName); //Reference text
+  string TrajNames[2] = {BinName,CutName}; //Files to convert
+  for (int t=0;t<2;t++)
+  {
+    BinTraj Traj; //Binary trajectory
+    if (!Traj.Open(TrajNames[t]))
+    {
+      Pass = 0;
+      continue;
+    }
+    if ((int)Traj.Frames.size() != Nframes)
+    {
+      Pass = 0;
+    }
+    ofile.open(OutName.c_str(),ios_base::out);
+    for (int k=0;k<(int)Traj.Frames.size();k++)
+    {
+      if (Traj.ReadFrame(k))
+      {
+        WriteBinTrajFrame(Traj,ofile);
+      }
+    }
+    Traj.Close();
+    ofile.close();
+    if (LICHEMReadFile(OutName) != XYZText)
+    {
+      Pass = 0;
+    }
+  }
+  //Clean up files
+  LICHEMRemoveFiles(XYZName+" "+BinName+" "+CutName+" "+OutName);
+  return Pass;
+};
+
+void LICHEMSelfTest(int& argc, char**& argv)
+{
+  //Function to run the internal tests and exit
+  //NB: The exit status is zero only if all tests pass
+  bool AllPass = 1; //Flag for failed tests
+  bool Pass[4]; //Result of each test
+  string Names[4]; //Name of each test
+  RandomStream TestRand; //Generator to check
+  Names[0] = "Random number known answers";
+  Pass[0] = TestRand.SelfTest();
+  Names[1] = "Binary trajectory (double)";
+  Pass[1] = BinTrajSelfTest(8,0);
+  Names[2] = "Binary trajectory (single)";
+  Pass[2] = BinTrajSelfTest(4,0);
+  Names[3] = "Binary trajectory (compressed)";
+  Pass[3] = BinTrajSelfTest(8,0.001);
+  cout << '\n';
+  for (int i=0;i<4;i++)
+  {
+    cout << Names[i] << ": ";
+    if (Pass[i])
+    {
+      cout << "Pass";
+    }
+    else
+    {
+      cout << "Fail";
+      AllPass = 0;
+    }
+    cout << '\n';
+  }
+  cout << '\n';
+  cout.flush();
+  exit(!AllPass);
+  return;
+};
+
 void BurstTraj(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
 {
   //Function to split reaction path and path-integral trajectory frames
@@ -191,46 +623,55 @@ void PathLinInterpolate(int& argc, char**& argv)
   vector<Coord> ReactPOS; //Reactant coordinates
   vector<Coord> TransPOS; //Transition state coordinates
   vector<Coord> ProdPOS; //Product coordinates
-  reactfile >> Natoms; //Read number of atoms
-  for (int i=0;i<Natoms;i++)
+  if (!ReadBinTrajStruct(reactfilename,AtTyps,ReactPOS))
   {
-    string temptyp;
-    Coord temppos;
-    reactfile >> temptyp;
-    reactfile >> temppos.x;
-    reactfile >> temppos.y;
-    reactfile >> temppos.z;
-    AtTyps.push_back(temptyp);
-    ReactPOS.push_back(temppos);
+    reactfile >> Natoms; //Read number of atoms
+    for (int i=0;i<Natoms;i++)
+    {
+      string temptyp;
+      Coord temppos;
+      reactfile >> temptyp;
+      reactfile >> temppos.x;
+      reactfile >> temppos.y;
+      reactfile >> temppos.z;
+      AtTyps.push_back(temptyp);
+      ReactPOS.push_back(temppos);
+    }
   }
   reactfile.close();
   if (IncludeTS)
   {
-    tsfile >> Natoms; //Read number of atoms
+    if (!ReadBinTrajStruct(tsfilename,AtTyps,TransPOS))
+    {
+      tsfile >> Natoms; //Read number of atoms
+      for (int i=0;i<Natoms;i++)
+      {
+        string temptyp;
+        Coord temppos;
+        tsfile >> temptyp;
+        tsfile >> temppos.x;
+        tsfile >> temppos.y;
+        tsfile >> temppos.z;
+        AtTyps.push_back(temptyp);
+        TransPOS.push_back(temppos);
+      }
+    }
+    tsfile.close();
+  }
+  if (!ReadBinTrajStruct(prodfilename,AtTyps,ProdPOS))
+  {
+    prodfile >> Natoms; //Read number of atoms
     for (int i=0;i<Natoms;i++)
     {
       string temptyp;
       Coord temppos;
-      tsfile >> temptyp;
-      tsfile >> temppos.x;
-      tsfile >> temppos.y;
-      tsfile >> temppos.z;
+      prodfile >> temptyp;
+      prodfile >> temppos.x;
+      prodfile >> temppos.y;
+      prodfile >> temppos.z;
       AtTyps.push_back(temptyp);
-      TransPOS.push_back(temppos);
+      ProdPOS.push_back(temppos);
     }
-    tsfile.close();
-  }
-  prodfile >> Natoms; //Read number of atoms
-  for (int i=0;i<Natoms;i++)
-  {
-    string temptyp;
-    Coord temppos;
-    prodfile >> temptyp;
-    prodfile >> temppos.x;
-    prodfile >> temppos.y;
-    prodfile >> temppos.z;
-    AtTyps.push_back(temptyp);
-    ProdPOS.push_back(temppos);
   }
   prodfile.close();
   //Check for more errors
@@ -433,6 +874,41 @@ void SplitPathTraj(int& argc, char**& argv)
   burstfile.open(call.str().c_str(),ios_base::out);
   cout << "Trajectory output: " << call.str();
   cout << '\n' << '\n';
+  //Read binary trajectories without scanning the file
+  BinTraj Traj;
+  if (Traj.Open(pathfilename))
+  {
+    pathfile.close();
+    if (Traj.Nbeads != Nbeads)
+    {
+      //The number of beads is saved in the file
+      cout << "Warning: Using " << Traj.Nbeads << " beads from the";
+      cout << " trajectory file." << '\n' << '\n';
+    }
+    if (!Traj.ReadFrame(FrameID))
+    {
+      cout << "Error: Frame " << FrameID << " is not in the trajectory!!!";
+      cout << '\n' << '\n';
+      exit(0);
+    }
+    //Write each bead as a separate frame
+    for (int j=0;j<Traj.Nbeads;j++)
+    {
+      burstfile << Traj.Natoms << '\n' << '\n';
+      for (int i=0;i<Traj.Natoms;i++)
+      {
+        Coord& Pos = Traj.P[i*Traj.Nbeads+j];
+        burstfile << setw(3) << left << Traj.Typs[i] << " ";
+        burstfile << LICHEMFormFloat(Pos.x,16) << " ";
+        burstfile << LICHEMFormFloat(Pos.y,16) << " ";
+        burstfile << LICHEMFormFloat(Pos.z,16) << '\n';
+      }
+    }
+    Traj.Close();
+    burstfile.flush();
+    burstfile.close();
+    exit(0);
+  }
   //Read the number of atoms
   getline(pathfile,dummy); //Read the first line of the file
   call.str(dummy); //Save to a stream
@@ -665,6 +1141,184 @@ double LICHEMDensity(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
   return rho;
 };
 
+void PrintMCStats(QMMMSettings& QMMMOpts)
+{
+  //Function to print the averages of a chain, the acceptance of each type
+  //of move, and the cost of the independent samples
+  string Names[Nmoves]; //Types of moves
+  Names[MoveCent] = "Centroid";
+  Names[MoveBead] = "Bead";
+  Names[MoveStage] = "Staging";
+  Names[MoveModes] = "Normal mode";
+  Names[MoveVol] = "Volume";
+  MCStats& Stats = QMMMOpts.MCStat; //Counters for the chain
+  double Nsteps = Stats.Nacc+Stats.Nrej; //Number of production steps
+  double SumE = 0; //Average energy
+  double SumE2 = 0; //Average squared energy
+  for (unsigned int i=0;i<Stats.Energies.size();i++)
+  {
+    SumE += Stats.Energies[i];
+    SumE2 += Stats.Energies[i]*Stats.Energies[i];
+  }
+  SumE /= Nsteps; //Average energy
+  SumE2 /= Nsteps; //Variance of the energy
+  if (QMMMOpts.Ensemble == "NPT")
+  {
+    //Print simulation box information
+    cout << " | Density: ";
+    cout << LICHEMFormFloat(Stats.DenAvg,8);
+    cout << " g/cm\u00B3" << '\n';
+    cout << " | Average box size (\u212B): " << '\n';
+    cout << "  "; //Indent
+    cout << " Lx = " << LICHEMFormFloat(Stats.LxAvg,12);
+    cout << " Ly = " << LICHEMFormFloat(Stats.LyAvg,12);
+    cout << " Lz = " << LICHEMFormFloat(Stats.LzAvg,12);
+    cout << '\n';
+  }
+  cout << " | Average energy: ";
+  cout << LICHEMFormFloat(SumE,16);
+  cout << " eV | Variance: ";
+  cout << LICHEMFormFloat((SumE2-(SumE*SumE)),12);
+  cout << " eV\u00B2";
+  cout << '\n';
+  if (QMMMOpts.PIVirial)
+  {
+    double SumEv = 0; //Average centroid virial energy
+    double SumEv2 = 0; //Average squared centroid virial energy
+    for (unsigned int i=0;i<Stats.Evirial.size();i++)
+    {
+      SumEv += Stats.Evirial[i];
+      SumEv2 += Stats.Evirial[i]*Stats.Evirial[i];
+    }
+    SumEv /= Nsteps; //Average virial energy
+    SumEv2 /= Nsteps; //Variance of the virial energy
+    cout << " | Virial energy: ";
+    cout << LICHEMFormFloat(SumEv,16);
+    cout << " eV | Variance: ";
+    cout << LICHEMFormFloat((SumEv2-(SumEv*SumEv)),12);
+    cout << " eV\u00B2";
+    cout << '\n';
+  }
+  cout << " | Acceptance ratio: ";
+  cout << LICHEMFormFloat((Stats.Nacc/Nsteps),6);
+  cout << " | Optimum step size: ";
+  cout << LICHEMFormFloat(QMMMOpts.MCStep,6);
+  cout << " \u212B";
+  cout << '\n';
+  for (int k=0;k<Nmoves;k++)
+  {
+    if (Stats.Tries(k) > 0)
+    {
+      cout << " | " << Names[k] << " moves: ";
+      cout << (long long)Stats.Tries(k);
+      cout << " | Acceptance ratio: ";
+      cout << LICHEMFormFloat((Stats.Accepts(k)/Stats.Tries(k)),6);
+      cout << '\n';
+    }
+  }
+  //Find the number of independent samples from the energies
+  double Tau = Stats.CorrTime(); //Autocorrelation time (steps)
+  double Neff = Stats.Energies.size()/Tau; //Independent samples
+  cout << " | Energy correlation time: ";
+  cout << LICHEMFormFloat(Tau,6) << " steps";
+  cout << " | Independent samples: ";
+  cout << LICHEMFormFloat(Neff,6);
+  cout << '\n';
+  if (Stats.QMCalls > 0)
+  {
+    cout << " | QM bead energies: ";
+    cout << (long long)Stats.QMCalls;
+    cout << " | Per independent sample: ";
+    cout << LICHEMFormFloat((Stats.QMCalls/Neff),6);
+    cout << '\n';
+  }
+  return;
+};
+
+void PrintMCChains(vector<QMMMSettings>& Chains)
+{
+  //Function to print the combined averages of independent Monte Carlo
+  //chains
+  /*
+    NB: The standard error is found from the spread of the chain averages,
+    so it includes the correlation between the steps of each chain. The
+    potential scale reduction compares the spread of the chain averages to
+    the fluctuations inside the chains. Values close to one show that the
+    chains sample the same distribution.
+  */
+  int Nchains = Chains.size(); //Number of chains
+  int Nseries = 1; //Number of energy estimators
+  if (Chains[0].PIVirial)
+  {
+    Nseries = 2;
+  }
+  cout << "Combined MC statistics:" << '\n';
+  cout << " | Chains: " << Nchains << '\n';
+  for (int k=0;k<Nseries;k++)
+  {
+    VectorXd Avg(Nchains); //Average of each chain
+    VectorXd Var(Nchains); //Variance of each chain
+    double Nsteps = 0; //Total number of steps
+    double EAvg = 0; //Average of all steps
+    double E2Avg = 0; //Average squared energy of all steps
+    for (int c=0;c<Nchains;c++)
+    {
+      vector<double>* E = &Chains[c].MCStat.Energies; //Chain energies
+      if (k == 1)
+      {
+        E = &Chains[c].MCStat.Evirial;
+      }
+      double SumE = 0; //Sum of the energies
+      double SumE2 = 0; //Sum of the squared energies
+      for (unsigned int i=0;i<E->size();i++)
+      {
+        SumE += (*E)[i];
+        SumE2 += (*E)[i]*(*E)[i];
+      }
+      double Npts = E->size(); //Steps in the chain
+      Nsteps += Npts;
+      EAvg += SumE;
+      E2Avg += SumE2;
+      Avg(c) = SumE/Npts;
+      Var(c) = (SumE2-Npts*Avg(c)*Avg(c))/(Npts-1);
+    }
+    EAvg /= Nsteps;
+    E2Avg /= Nsteps;
+    //Spread of the chain averages
+    double Spread = (Avg.array()-Avg.mean()).square().sum()/(Nchains-1);
+    double StdErr = sqrt(Spread/Nchains); //Standard error of the average
+    //Potential scale reduction
+    double Npts = Nsteps/Nchains; //Average number of steps in a chain
+    double Within = Var.mean(); //Variance inside the chains
+    double PSR = 1; //No fluctuations
+    if (Within > 0)
+    {
+      PSR = ((Npts-1)/Npts)*Within+Spread;
+      PSR = sqrt(PSR/Within);
+    }
+    if (k == 0)
+    {
+      cout << " | Average energy: ";
+    }
+    else
+    {
+      cout << " | Virial energy: ";
+    }
+    cout << LICHEMFormFloat(EAvg,16);
+    cout << " eV | Standard error: ";
+    cout << LICHEMFormFloat(StdErr,12);
+    cout << " eV";
+    cout << '\n';
+    cout << " | Variance: ";
+    cout << LICHEMFormFloat((E2Avg-(EAvg*EAvg)),12);
+    cout << " eV\u00B2";
+    cout << " | Potential scale reduction: ";
+    cout << LICHEMFormFloat(PSR,6);
+    cout << '\n';
+  }
+  return;
+};
+
 VectorXd LICHEMFreq(vector<QMMMAtom>& Struct, MatrixXd& QMMMHess,
                     QMMMSettings& QMMMOpts, int Bead, int& remct)
 {
@@ -697,17 +1351,15 @@ VectorXd LICHEMFreq(vector<QMMMAtom>& Struct, MatrixXd& QMMMHess,
   RotZ.setZero();
   //Collect QM and PB masses
   vector<double> Masses;
-  for (int i=0;i<Natoms;i++)
+  for (int p=0;p<(Nqm+Npseudo);p++)
   {
     //Locate QM and PB atoms
-    if (Struct[i].QMregion or Struct[i].PBregion)
-    {
-      //Switch to a.u. and save mass
-      double massval = Struct[i].m/ElecMass;
-      Masses.push_back(massval); //X component
-      Masses.push_back(massval); //Y component
-      Masses.push_back(massval); //Z component
-    }
+    int i = QMPBList[p]; //Atom ID
+    //Switch to a.u. and save mass
+    double massval = Struct[i].m/ElecMass;
+    Masses.push_back(massval); //X component
+    Masses.push_back(massval); //Y component
+    Masses.push_back(massval); //Z component
   }
   //Mass scale the Hessian matrix
   #pragma omp parallel for
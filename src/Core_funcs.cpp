@@ -97,51 +97,10 @@ Coord CoordDist2(Coord& a, Coord& b)
   //Check PBC
   if (PBCon)
   {
-    bool check = 1; //Continue checking PBC
-    while (check)
-    {
-      //Overkill, bit it checks if atoms are wrapped multiple times
-      check = 0; //Stop if there are no changes
-      if (abs(dx) > (0.5*Lx))
-      {
-        //Update X displacement
-        check = 1; //The displacement was updated
-        if (dx > 0)
-        {
-          dx -= Lx;
-        }
-        else
-        {
-          dx += Lx;
-        }
-      }
-      if (abs(dy) > (0.5*Ly))
-      {
-        //Update Y displacement
-        check = 1; //The displacement was updated
-        if (dy > 0)
-        {
-          dy -= Ly;
-        }
-        else
-        {
-          dy += Ly;
-        }
-      }
-      if (abs(dz) > (0.5*Lz))
-      {
-        //Update Z displacement
-        check = 1; //The displacement was updated
-        if (dz > 0)
-        {
-          dz -= Lz;
-        }
-        else
-        {
-          dz += Lz;
-        }
-      }
-    }
+    //Minimum image convention, also works for atoms wrapped multiple times
+    dx -= Lx*floor((dx/Lx)+0.5);
+    dy -= Ly*floor((dy/Ly)+0.5);
+    dz -= Lz*floor((dz/Lz)+0.5);
   }
   //Save displacements
   Coord DispAB; //Distance between A and B
@@ -151,6 +110,59 @@ Coord CoordDist2(Coord& a, Coord& b)
   return DispAB;
 };
 
+VectorXd MinImageDist2(VectorXd& Dx, VectorXd& Dy, VectorXd& Dz)
+{
+  //Applies the minimum image convention to a list of displacements and
+  //returns the squared distances
+  //NB: Adding and subtracting RoundNum rounds to the nearest integer
+  //without branches or library calls, so the loops can use SIMD lanes
+  const double RoundNum = 6755399441055744.0; //2^52+2^51
+  int Npts = Dx.size(); //Number of displacements
+  double* dx = Dx.data();
+  double* dy = Dy.data();
+  double* dz = Dz.data();
+  VectorXd R2(Npts); //Squared distances
+  double* r2 = R2.data();
+  if (PBCon)
+  {
+    //Wrap displacements
+    double iLx = 1/Lx;
+    double iLy = 1/Ly;
+    double iLz = 1/Lz;
+    for (int i=0;i<Npts;i++)
+    {
+      double nx = ((dx[i]*iLx)+RoundNum)-RoundNum; //Number of box lengths
+      double ny = ((dy[i]*iLy)+RoundNum)-RoundNum; //Number of box lengths
+      double nz = ((dz[i]*iLz)+RoundNum)-RoundNum; //Number of box lengths
+      dx[i] -= Lx*nx;
+      dy[i] -= Ly*ny;
+      dz[i] -= Lz*nz;
+    }
+  }
+  for (int i=0;i<Npts;i++)
+  {
+    //Calculate squared distances
+    r2[i] = dx[i]*dx[i]+dy[i]*dy[i]+dz[i]*dz[i];
+  }
+  return R2;
+};
+
+VectorXd BeadDist2(vector<QMMMAtom>& Struct, Coord& Ref, int Bead,
+                   VectorXd& Dx, VectorXd& Dy, VectorXd& Dz)
+{
+  //Minimum image displacements of all atoms in a bead from a point
+  Dx.resize(Natoms);
+  Dy.resize(Natoms);
+  Dz.resize(Natoms);
+  for (int i=0;i<Natoms;i++)
+  {
+    Dx(i) = Struct[i].P[Bead].x-Ref.x;
+    Dy(i) = Struct[i].P[Bead].y-Ref.y;
+    Dz(i) = Struct[i].P[Bead].z-Ref.z;
+  }
+  return MinImageDist2(Dx,Dy,Dz);
+};
+
 //Functions to check connectivity
 vector<int> TraceBoundary(vector<QMMMAtom>& Struct, int AtID)
 {
@@ -301,92 +313,38 @@ void PBCCenter(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
   double avgx = 0;
   double avgy = 0;
   double avgz = 0;
-  #pragma omp parallel
+  #pragma omp parallel for schedule(static) reduction(+:avgx,avgy,avgz)
+  for (int i=0;i<Natoms;i++)
   {
-    #pragma omp for nowait schedule(dynamic) reduction(+:avgx)
-    for (int i=0;i<Natoms;i++)
-    {
-      //Loop over all beads
-      double centx = 0;
-      for (int j=0;j<QMMMOpts.Nbeads;j++)
-      {
-        //Update local average postion
-        centx += Struct[i].P[j].x;
-      }
-      //Upate full average
-      avgx += centx;
-    }
-    #pragma omp for nowait schedule(dynamic) reduction(+:avgy)
-    for (int i=0;i<Natoms;i++)
-    {
-      //Loop over all beads
-      double centy = 0;
-      for (int j=0;j<QMMMOpts.Nbeads;j++)
-      {
-        //Update local average postion
-        centy += Struct[i].P[j].y;
-      }
-      //Upate full average
-      avgy += centy;
-    }
-    #pragma omp for nowait schedule(dynamic) reduction(+:avgz)
-    for (int i=0;i<Natoms;i++)
+    //Loop over all beads
+    for (int j=0;j<QMMMOpts.Nbeads;j++)
     {
-      //Loop over all beads
-      double centz = 0;
-      for (int j=0;j<QMMMOpts.Nbeads;j++)
-      {
-        //Update local average postion
-        centz += Struct[i].P[j].z;
-      }
-      //Upate full average
-      avgz += centz;
+      //Update average postion
+      avgx += Struct[i].P[j].x;
+      avgy += Struct[i].P[j].y;
+      avgz += Struct[i].P[j].z;
     }
   }
-  #pragma omp barrier
-  //Convert sums to averages
+  //Convert sums to shifts
   avgx /= Natoms*QMMMOpts.Nbeads;
   avgy /= Natoms*QMMMOpts.Nbeads;
   avgz /= Natoms*QMMMOpts.Nbeads;
+  avgx -= 0.5*Lx;
+  avgy -= 0.5*Ly;
+  avgz -= 0.5*Lz;
   //Move atoms to the center of the box
-  #pragma omp parallel
+  #pragma omp parallel for schedule(static)
+  for (int i=0;i<Natoms;i++)
   {
-    #pragma omp for nowait schedule(dynamic)
-    for (int i=0;i<Natoms;i++)
+    //Loop over all beads
+    for (int j=0;j<QMMMOpts.Nbeads;j++)
     {
-      //Loop over all beads
-      for (int j=0;j<QMMMOpts.Nbeads;j++)
-      {
-        //Move bead to the center
-        Struct[i].P[j].x -= avgx;
-        Struct[i].P[j].x += 0.5*Lx;
-      }
-    }
-    #pragma omp for nowait schedule(dynamic)
-    for (int i=0;i<Natoms;i++)
-    {
-      //Loop over all beads
-      for (int j=0;j<QMMMOpts.Nbeads;j++)
-      {
-        //Move bead to the center
-        Struct[i].P[j].y -= avgy;
-        Struct[i].P[j].y += 0.5*Ly;
-      }
-    }
-    #pragma omp for nowait schedule(dynamic)
-    for (int i=0;i<Natoms;i++)
-    {
-      //Loop over all beads
-      for (int j=0;j<QMMMOpts.Nbeads;j++)
-      {
-        //Move bead to the center
-        Struct[i].P[j].z -= avgz;
-        Struct[i].P[j].z += 0.5*Lz;
-      }
+      //Move bead to the center
+      Struct[i].P[j].x -= avgx;
+      Struct[i].P[j].y -= avgy;
+      Struct[i].P[j].z -= avgz;
     }
   }
-  #pragma omp barrier
-  //Return with updated structure
   return;
 };
 
@@ -398,47 +356,45 @@ Coord FindQMCOM(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   double avgy = 0; //Average y position
   double avgz = 0; //Average z position
   double totm = 0; //Total mass
-  #pragma omp parallel
+  for (int p=0;p<(Nqm+Npseudo);p++)
   {
-    #pragma omp for nowait schedule(dynamic) reduction(+:totm)
-    for (int i=0;i<Natoms;i++)
-    {
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        totm += Struct[i].m;
-      }
-    }
-    #pragma omp for nowait schedule(dynamic) reduction(+:avgx)
-    for (int i=0;i<Natoms;i++)
+    //Only a few atoms, a single serial pass is the fastest
+    int i = QMPBList[p]; //Atom ID
+    double m = Struct[i].m; //Mass of the atom
+    totm += m;
+    avgx += m*Struct[i].P[Bead].x;
+    avgy += m*Struct[i].P[Bead].y;
+    avgz += m*Struct[i].P[Bead].z;
+  }
+  //Save center of mass
+  QMCOM.x = avgx/totm;
+  QMCOM.y = avgy/totm;
+  QMCOM.z = avgz/totm;
+  return QMCOM;
+};
+
+void SetRegionLists(vector<QMMMAtom>& Struct)
+{
+  //Save the IDs of the atoms in each region
+  MMList.clear();
+  QMPBList.clear();
+  ActiveList.clear();
+  for (int i=0;i<Natoms;i++)
+  {
+    if (Struct[i].MMregion)
     {
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        avgx += Struct[i].m*Struct[i].P[Bead].x;
-      }
+      MMList.push_back(i);
     }
-    #pragma omp for nowait schedule(dynamic) reduction(+:avgy)
-    for (int i=0;i<Natoms;i++)
+    if (Struct[i].QMregion or Struct[i].PBregion)
     {
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        avgy += Struct[i].m*Struct[i].P[Bead].y;
-      }
+      QMPBList.push_back(i);
     }
-    #pragma omp for nowait schedule(dynamic) reduction(+:avgz)
-    for (int i=0;i<Natoms;i++)
+    if (!Struct[i].Frozen)
     {
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        avgz += Struct[i].m*Struct[i].P[Bead].z;
-      }
+      ActiveList.push_back(i);
     }
   }
-  #pragma omp barrier
-  //Save center of mass
-  QMCOM.x = avgx/totm;
-  QMCOM.y = avgy/totm;
-  QMCOM.z = avgz/totm;
-  return QMCOM;
+  return;
 };
 
 //Misc.
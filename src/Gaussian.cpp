@@ -31,6 +31,7 @@ void ExternalGaussian(int& argc, char**& argv)
   stringstream call; //Stream for system calls and reading/writing files
   call.copyfmt(cout); //Copy print settings
   string dummy,Stub; //Generic strings
+  string WorkDir; //LICHEM working directory (scratch directories only)
   //Declare lots of file streams
   fstream xyzfile,connectfile,regionfile; //LICHEM streams
   fstream GauInput,GauOutput,GauMsg,GauFchk,GauMatrix; //Gaussian streams
@@ -71,11 +72,32 @@ void ExternalGaussian(int& argc, char**& argv)
       //Read the current bead
       Bead = atoi(argv[i+1]);
     }
+    if (dummy == "-w")
+    {
+      //Read the LICHEM working directory
+      WorkDir = string(argv[i+1]);
+    }
   }
   //Open files passed by Gaussian
-  GauInput.open(argv[12],ios_base::in);
-  GauOutput.open(argv[13],ios_base::out);
-  GauMsg.open(argv[14],ios_base::out);
+  //NB: Gaussian adds the layer, input, output, message, fchk, and matrix
+  //element file names to the end of the command
+  GauInput.open(argv[argc-5],ios_base::in);
+  GauOutput.open(argv[argc-4],ios_base::out);
+  GauMsg.open(argv[argc-3],ios_base::out);
+  if (WorkDir != "")
+  {
+    //Gaussian runs in the scratch directory of the bead, so the bead
+    //files stay here while the other LICHEM input is read from WorkDir
+    string BeadDir = LICHEMFullPath("."); //Scratch directory of the bead
+    ScratchTop = BeadDir.substr(0,BeadDir.find_last_of('/'));
+    if (chdir(WorkDir.c_str()) != 0)
+    {
+      cerr << "Error: Could not change to " << WorkDir << "!!!";
+      cerr << '\n';
+      cerr.flush();
+      exit(0);
+    }
+  }
   //Read LICHEM input
   ReadLICHEMInput(xyzfile,connectfile,regionfile,Struct,QMMMOpts);
   //Set degrees of freedom
@@ -95,22 +117,20 @@ void ExternalGaussian(int& argc, char**& argv)
     exit(0);
   }
   //Read updated positions from Gaussian files
-  for (int i=0;i<Natoms;i++)
+  for (int p=0;p<(Nqm+Npseudo);p++)
   {
-    if (Struct[i].QMregion or Struct[i].PBregion)
-    {
-      //Save atom information
-      getline(GauInput,dummy);
-      stringstream line(dummy);
-      line >> dummy;
-      line >> Struct[i].P[Bead].x;
-      line >> Struct[i].P[Bead].y;
-      line >> Struct[i].P[Bead].z;
-      //Change units
-      Struct[i].P[Bead].x *= BohrRad;
-      Struct[i].P[Bead].y *= BohrRad;
-      Struct[i].P[Bead].z *= BohrRad;
-    }
+    int i = QMPBList[p]; //Atom ID
+    //Save atom information
+    getline(GauInput,dummy);
+    stringstream line(dummy);
+    line >> dummy;
+    line >> Struct[i].P[Bead].x;
+    line >> Struct[i].P[Bead].y;
+    line >> Struct[i].P[Bead].z;
+    //Change units
+    Struct[i].P[Bead].x *= BohrRad;
+    Struct[i].P[Bead].y *= BohrRad;
+    Struct[i].P[Bead].z *= BohrRad;
   }
   GauInput.close();
   //Calculate the QMMM forces
@@ -174,7 +194,7 @@ void ExternalGaussian(int& argc, char**& argv)
   GauOutput.close();
   //Write new XYZ for recovery of failed optimizations
   call.str("");
-  call << Stub << ".xyz";
+  call << LICHEMJobDir(Bead) << Stub << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   ofile << Natoms << '\n' << '\n';
   for (int i=0;i<Natoms;i++)
@@ -194,6 +214,133 @@ void ExternalGaussian(int& argc, char**& argv)
   return;
 };
 
+bool GaussianFchk(vector<QMMMAtom>& Struct, int Bead, double& E,
+                  VectorXd* Forces, MatrixXd* Hess)
+{
+  //Function to read the energy, forces, Hessian, and charges from a
+  //formatted checkpoint file
+  //NB: Nothing is changed if a result is missing, so that the log file can
+  //be read instead. Charges are only updated for energies and forces.
+  stringstream call; //Stream for system calls and reading/writing files
+  call.copyfmt(cout); //Copy print settings
+  int Ndof = 3*(Nqm+Npseudo); //Number of QM and PB degrees of freedom
+  //Generate formatted checkpoint file
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
+  if (!CheckFile(call.str()))
+  {
+    return 0;
+  }
+  call.str("");
+  call << "formchk ";
+  call << "LICHM_" << Bead << ".chk";
+  GlobalSys = LICHEMSpawn(call.str(),LICHEMJobDir(Bead),"","/dev/null");
+  //Read arrays
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".fchk";
+  QMLogFile Fchk; //Formatted checkpoint file
+  if (!Fchk.Open(call.str()))
+  {
+    return 0;
+  }
+  Fchk.AddMarker("Total Energy",1);
+  Fchk.AddMarker("Cartesian Gradient",1);
+  Fchk.AddMarker("Cartesian Force Constants",1);
+  Fchk.AddMarker("Mulliken Charges",1);
+  Fchk.AddMarker("ESP Charges",1);
+  bool Efound = 0; //Flag for the energy
+  double Efchk = 0; //Energy (a.u.)
+  VectorXd Grad,FConst,MullQ,ESPQ; //Arrays
+  int Section = Fchk.NextMarker(); //Marker which was found
+  while (Section >= 0)
+  {
+    if (Section == 0)
+    {
+      Fchk.SkipWords(1); //Clear junk
+      Efound = Fchk.ReadDouble(Efchk);
+    }
+    else
+    {
+      //Read the array length and values
+      double Nvals = 0;
+      VectorXd Vals;
+      Fchk.SkipWords(2); //Clear junk
+      Fchk.ReadDouble(Nvals);
+      Fchk.ReadArray((int)Nvals,Vals);
+      if (Section == 1)
+      {
+        Grad = Vals;
+      }
+      if (Section == 2)
+      {
+        FConst = Vals;
+      }
+      if (Section == 3)
+      {
+        MullQ = Vals;
+      }
+      if (Section == 4)
+      {
+        ESPQ = Vals;
+      }
+    }
+    Section = Fchk.NextMarker();
+  }
+  Fchk.Close();
+  LICHEMRemoveFiles(call.str());
+  //Check for missing results
+  bool Done = Efound;
+  if (Forces != NULL)
+  {
+    Done = (Done and (Grad.size() == Ndof));
+  }
+  if (Hess != NULL)
+  {
+    Done = (Done and (FConst.size() == ((Ndof*(Ndof+1))/2)));
+  }
+  if (!Done)
+  {
+    return 0;
+  }
+  //Save the results
+  E = Efchk;
+  if (Forces != NULL)
+  {
+    //Change the gradient to forces (eV/Ang)
+    *Forces -= Grad*Har2eV/BohrRad;
+  }
+  if (Hess != NULL)
+  {
+    //Unpack the lower triangle
+    int ct = 0; //Array index
+    for (int i=0;i<Ndof;i++)
+    {
+      for (int j=0;j<(i+1);j++)
+      {
+        (*Hess)(i,j) = FConst(ct);
+        (*Hess)(j,i) = FConst(ct);
+        ct += 1;
+      }
+    }
+  }
+  else
+  {
+    //ESP (MK) charges, or Mulliken charges (fallback)
+    if (ESPQ.size() != (Nqm+Npseudo))
+    {
+      ESPQ = MullQ;
+    }
+    if (ESPQ.size() == (Nqm+Npseudo))
+    {
+      for (int p=0;p<(Nqm+Npseudo);p++)
+      {
+        Struct[QMPBList[p]].MP[Bead].q = ESPQ(p);
+      }
+    }
+  }
+  return 1;
+};
+
 //QM wrapper functions
 void GaussianCharges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
                      int Bead)
@@ -205,7 +352,7 @@ void GaussianCharges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call.copyfmt(cout); //Copy print settings
   //Check if there is a checkpoint file
   call.str("");
-  call << "LICHM_" << Bead << ".chk";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
   bool UseCheckPoint = CheckFile(call.str());
   if (QMMMOpts.Func == "SemiEmp")
   {
@@ -213,8 +360,8 @@ void GaussianCharges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     UseCheckPoint = 0;
     //Remove SemiEmp checkpoints to avoid errors
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".chk";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
+    LICHEMRemoveFiles(call.str());
   }
   //Construct Gaussian input
   call.str("");
@@ -254,73 +401,52 @@ void GaussianCharges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   //Run QM calculation
   call.str("");
   call << "g09 LICHM_" << Bead;
-  GlobalSys = system(call.str().c_str());
-  //Extract charges
+  GlobalSys = LICHEMSpawn(call.str(),LICHEMJobDir(Bead),"","");
+  //Check if the calculation finished
   call.str("");
-  call << "LICHM_" << Bead << ".log";
-  ifile.open(call.str().c_str(),ios_base::in);
-  while (!ifile.eof())
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  QMLogFile QMlog; //Output file
+  QMlog.Open(call.str());
+  QMlog.AddMarker("SCF Done:",1);
+  bool QMfinished = (QMlog.NextMarker() >= 0);
+  QMlog.Close();
+  //Extract charges
+  double E = 0; //QM energy (not used)
+  if (!(QMfinished and GaussianFchk(Struct,Bead,E,NULL,NULL)))
   {
-    getline(ifile,dummy);
-    stringstream line(dummy);
-    line >> dummy;
-    if (dummy == "Mulliken")
+    //Read the log file instead
+    QMlog.Open(call.str());
+    QMlog.AddMarker("Mulliken charges:",1);
+    QMlog.AddMarker("ESP charges:",1);
+    int Section = QMlog.NextMarker(); //Marker which was found
+    while (Section >= 0)
     {
-      //Mulliken charges (fallback)
-      line >> dummy;
-      if (dummy == "charges:")
-      {
-        getline(ifile,dummy); //Clear junk
-        for (int i=0;i<Natoms;i++)
-        {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            //Count through all atoms in the QM calculations
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> Struct[i].MP[Bead].q;
-          }
-        }
-      }
-    }
-    if (dummy == "ESP")
-    {
-      //ESP (MK) charges
-      line >> dummy;
-      if (dummy == "charges:")
+      if ((Section == 0) or (Section == 1))
       {
-        getline(ifile,dummy); //Clear junk
-        for (int i=0;i<Natoms;i++)
+        //Mulliken (fallback) or ESP (MK) charges
+        QMlog.NextLine(); //Clear junk
+        QMlog.NextLine(); //Ditto
+        for (int p=0;p<(Nqm+Npseudo);p++)
         {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            //Count through all atoms in the QM calculations
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> Struct[i].MP[Bead].q;
-          }
+          int i = QMPBList[p]; //Atom ID
+          //Count through all atoms in the QM calculations
+          QMlog.SkipWords(2); //Clear junk
+          QMlog.ReadDouble(Struct[i].MP[Bead].q);
+          QMlog.NextLine();
         }
       }
+      Section = QMlog.NextMarker();
     }
+    QMlog.Close();
   }
-  ifile.close();
   //Clean up files and save checkpoint file
   call.str("");
-  call << "mv LICHM_" << Bead;
-  call << ".chk tmp_" << Bead;
-  call << ".chk; ";
-  call << "rm -f ";
-  call << "LICHM_" << Bead;
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead;
   call << ".log";
   call << " ";
-  call << "LICHM_" << Bead;
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead;
   call << ".com";
-  call << "; mv tmp_" << Bead;
-  call << ".chk LICHM_" << Bead;
-  call << ".chk";
-  GlobalSys = system(call.str().c_str());
+  LICHEMRemoveFiles(call.str());
   return;
 };
 
@@ -334,9 +460,16 @@ double GaussianEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call.copyfmt(cout); //Copy print settings
   double E = 0.0; //QM energy
   double Eself = 0.0; //External field self-energy
+  //Use a saved result for repeated structures
+  uint64_t CacheKey; //Hash of the inputs
+  CacheKey = SavedResults.GetKey("Gaussian",Struct,QMMMOpts,Bead,1,0);
+  if (SavedResults.FindEnergy(CacheKey,Struct,Bead,E))
+  {
+    return E;
+  }
   //Check if there is a checkpoint file
   call.str("");
-  call << "LICHM_" << Bead << ".chk";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
   bool UseCheckPoint = CheckFile(call.str());
   if (QMMMOpts.Func == "SemiEmp")
   {
@@ -344,8 +477,8 @@ double GaussianEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     UseCheckPoint = 0;
     //Remove SemiEmp checkpoints to avoid errors
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".chk";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
+    LICHEMRemoveFiles(call.str());
   }
   //Construct Gaussian input
   call.str("");
@@ -382,88 +515,76 @@ double GaussianEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     call << '\n';
   }
   WriteGauInput(Struct,call.str(),QMMMOpts,Bead);
+  //Use a saved result from an earlier simulation
+  uint64_t StoreKey; //Hash of the QM input
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".com";
+  StoreKey = QMStore.GetKey(call.str(),Bead);
+  if (QMStore.FindEnergy(StoreKey,Struct,Bead,E))
+  {
+    LICHEMRemoveFiles(call.str());
+    SavedResults.SaveEnergy(CacheKey,Struct,Bead,E);
+    return E;
+  }
   //Calculate energy
   call.str("");
   call << "g09 ";
   call << "LICHM_" << Bead;
-  GlobalSys = system(call.str().c_str());
-  //Read output
+  GlobalSys = LICHEMSpawn(call.str(),LICHEMJobDir(Bead),"","");
+  //Read the field self-energy and check if the calculation finished
   call.str("");
-  call << "LICHM_" << Bead << ".log";
-  ifile.open(call.str().c_str(),ios_base::in);
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  QMLogFile QMlog; //Output file
+  QMlog.Open(call.str());
+  QMlog.AddMarker("Self energy",1);
+  QMlog.AddMarker("SCF Done:",1);
   bool QMfinished = 0;
-  while (!ifile.eof())
+  int Section = QMlog.NextMarker(); //Marker which was found
+  while (Section >= 0)
   {
-    stringstream line;
-    getline(ifile,dummy);
-    line.str(dummy);
-    line >> dummy;
     //Search for field self-energy
-    if (dummy == "Self")
+    if (Section == 0)
     {
-      line >> dummy;
-      if (dummy == "energy")
-      {
-        line >> dummy; //Clear junk
-        line >> dummy; //Ditto
-        line >> dummy; //Ditto
-        line >> dummy; //Ditto
-        line >> Eself; //Actual self-energy of the charges
-      }
+      QMlog.SkipWords(4); //Clear junk
+      QMlog.ReadDouble(Eself); //Actual self-energy of the charges
     }
     //Search for energy
-    if (dummy == "SCF")
+    if (Section == 1)
     {
-      line >> dummy;
-      if (dummy == "Done:")
-      {
-        line >> dummy; //Clear junk
-        line >> dummy; //Ditto
-        line >> E; //QM energy
-        QMfinished = 1;
-      }
-    }
-    //Check for charges
-    if (dummy == "Mulliken")
-    {
-      //Mulliken charges (fallback)
-      line >> dummy;
-      if (dummy == "charges:")
-      {
-        getline(ifile,dummy); //Clear junk
-        for (int i=0;i<Natoms;i++)
-        {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            //Count through all atoms in the QM calculations
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> Struct[i].MP[Bead].q;
-          }
-        }
-      }
+      QMlog.SkipWords(2); //Clear junk
+      QMlog.ReadDouble(E); //QM energy
+      QMfinished = 1;
     }
-    if (dummy == "ESP")
+    Section = QMlog.NextMarker();
+  }
+  QMlog.Close();
+  //Read the energy and charges with full precision
+  if (QMfinished and (!GaussianFchk(Struct,Bead,E,NULL,NULL)))
+  {
+    //Read the charges from the log file instead
+    QMlog.Open(call.str());
+    QMlog.AddMarker("Mulliken charges:",1);
+    QMlog.AddMarker("ESP charges:",1);
+    Section = QMlog.NextMarker();
+    while (Section >= 0)
     {
-      //ESP (MK) charges
-      line >> dummy;
-      if (dummy == "charges:")
+      if ((Section == 0) or (Section == 1))
       {
-        getline(ifile,dummy); //Clear junk
-        for (int i=0;i<Natoms;i++)
+        //Mulliken (fallback) or ESP (MK) charges
+        QMlog.NextLine(); //Clear junk
+        QMlog.NextLine(); //Ditto
+        for (int p=0;p<(Nqm+Npseudo);p++)
         {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            //Count through all atoms in the QM calculations
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> Struct[i].MP[Bead].q;
-          }
+          int i = QMPBList[p]; //Atom ID
+          //Count through all atoms in the QM calculations
+          QMlog.SkipWords(2); //Clear junk
+          QMlog.ReadDouble(Struct[i].MP[Bead].q);
+          QMlog.NextLine();
         }
       }
+      Section = QMlog.NextMarker();
     }
+    QMlog.Close();
   }
   //Check for errors
   if (!QMfinished)
@@ -476,33 +597,31 @@ double GaussianEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     cerr.flush(); //Print warning immediately
     //Delete checkpoint
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".chk";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
+    LICHEMRemoveFiles(call.str());
   }
-  ifile.close();
   //Clean up files and save checkpoint file
-  call.str("");
   if (CheckFile("BACKUPQM"))
   {
     //Save old files
-    call << "cp LICHM_";
-    call << Bead << ".* ";
-    call << QMMMOpts.BackDir;
-    call << "/.";
-    call << " 2> LICHM_" << Bead << ".trash; ";
-    call << "rm -f LICHM_" << Bead << ".trash";
-    call << " "; //Extra blank space before the next command
+    call.str("");
+    call << LICHEMJobDir(Bead) << "LICHM_";
+    call << Bead << ".*";
+    LICHEMCopyFile(call.str(),QMMMOpts.BackDir);
   }
-  call << "rm -f ";
-  call << "LICHM_" << Bead;
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead;
   call << ".log";
   call << " ";
-  call << "LICHM_" << Bead;
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead;
   call << ".com";
-  GlobalSys = system(call.str().c_str());
+  LICHEMRemoveFiles(call.str());
   //Change units and return
   E -= Eself;
   E *= Har2eV;
+  //Save the result for repeated structures and later simulations
+  SavedResults.SaveEnergy(CacheKey,Struct,Bead,E);
+  QMStore.SaveEnergy(StoreKey,Struct,Bead,E);
   return E;
 };
 
@@ -513,12 +632,20 @@ double GaussianForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   stringstream call; //Stream for system calls and reading/writing files
   call.copyfmt(cout); //Copy print settings
   string dummy; //Generic string
-  fstream ofile,ifile,QMlog; //Generic input files
+  fstream ofile,ifile; //Generic input files
   double Eqm = 0; //QM energy
   double Eself = 0; //External field self-energy
+  //Use a saved result for repeated structures
+  uint64_t CacheKey; //Hash of the inputs
+  CacheKey = SavedResults.GetKey("Gaussian",Struct,QMMMOpts,Bead,1,0);
+  if (SavedResults.FindForces(CacheKey,Struct,Forces,Bead,Eqm))
+  {
+    return Eqm;
+  }
+  VectorXd OldForces = Forces; //Forces from other wrappers
   //Check if there is a checkpoint file
   call.str("");
-  call << "LICHM_" << Bead << ".chk";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
   bool UseCheckPoint = CheckFile(call.str());
   if (QMMMOpts.Func == "SemiEmp")
   {
@@ -526,8 +653,8 @@ double GaussianForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
     UseCheckPoint = 0;
     //Remove SemiEmp checkpoints to avoid errors
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".chk";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
+    LICHEMRemoveFiles(call.str());
   }
   //Construct Gaussian input
   call.str("");
@@ -565,115 +692,108 @@ double GaussianForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
     call << '\n';
   }
   WriteGauInput(Struct,call.str(),QMMMOpts,Bead);
+  //Use a saved result from an earlier simulation
+  uint64_t StoreKey; //Hash of the QM input
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".com";
+  StoreKey = QMStore.GetKey(call.str(),Bead);
+  if (QMStore.FindForces(StoreKey,Struct,Forces,Bead,Eqm))
+  {
+    LICHEMRemoveFiles(call.str());
+    SavedResults.SaveForces(CacheKey,Struct,Forces-OldForces,Bead,Eqm);
+    return Eqm;
+  }
   //Run Gaussian
   call.str("");
   call << "g09 " << "LICHM_" << Bead;
-  GlobalSys = system(call.str().c_str());
-  //Extract forces
+  GlobalSys = LICHEMSpawn(call.str(),LICHEMJobDir(Bead),"","");
+  //Read the field self-energy and check if the calculation finished
   call.str("");
-  call << "LICHM_" << Bead << ".log";
-  QMlog.open(call.str().c_str(),ios_base::in);
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  QMLogFile QMlog; //Output file
+  QMlog.Open(call.str());
+  QMlog.AddMarker("Self energy",1);
+  QMlog.AddMarker("SCF Done:",1);
+  bool QMfinished = 0;
+  int Section = QMlog.NextMarker(); //Marker which was found
+  while (Section >= 0)
+  {
+    if (Section == 0)
+    {
+      QMlog.SkipWords(4); //Clear junk
+      QMlog.ReadDouble(Eself); //Actual self-energy of the charges
+    }
+    //Check for partial QMMM energy
+    if (Section == 1)
+    {
+      QMlog.SkipWords(2); //Clear junk
+      QMlog.ReadDouble(Eqm); //QM energy
+      QMfinished = 1;
+    }
+    Section = QMlog.NextMarker();
+  }
+  QMlog.Close();
+  //Read the forces, energy, and charges with full precision
   bool GradDone = 0;
-  while ((!QMlog.eof()) and (!GradDone))
+  if (QMfinished)
   {
-    //Parse file line by line
-    getline(QMlog,dummy);
-    stringstream line(dummy);
-    line >> dummy;
-    //This only works with #P
-    if (dummy == "Center")
+    GradDone = GaussianFchk(Struct,Bead,Eqm,&Forces,NULL);
+  }
+  if (!GradDone)
+  {
+    //Read the log file instead
+    QMlog.Open(call.str());
+    QMlog.AddMarker("Forces (Hartrees/Bohr)",0); //This only works with #P
+    QMlog.AddMarker("Mulliken charges:",1);
+    QMlog.AddMarker("ESP charges:",1);
+    Section = QMlog.NextMarker();
+    while ((Section >= 0) and (!GradDone))
     {
-      line >> dummy >> dummy;
-      if (dummy == "Forces")
+      if (Section == 0)
       {
         GradDone = 1; //Not grad school, that lasts forever
-        getline(QMlog,dummy); //Clear junk
-        getline(QMlog,dummy); //Clear more junk
+        QMlog.NextLine(); //Clear junk
+        QMlog.NextLine(); //Clear more junk
+        QMlog.NextLine(); //Clear even more junk
         for (int i=0;i<(Nqm+Npseudo);i++)
         {
           double Fx = 0;
           double Fy = 0;
           double Fz = 0;
-          //Extract forces; Convoluted, but "easy"
-          getline(QMlog,dummy);
-          stringstream line(dummy);
-          line >> dummy >> dummy; //Clear junk
-          line >> Fx;
-          line >> Fy;
-          line >> Fz;
+          //Extract forces
+          QMlog.SkipWords(2); //Clear junk
+          QMlog.ReadDouble(Fx);
+          QMlog.ReadDouble(Fy);
+          QMlog.ReadDouble(Fz);
+          QMlog.NextLine();
           //Save forces
           Forces(3*i) += Fx*Har2eV/BohrRad;
           Forces(3*i+1) += Fy*Har2eV/BohrRad;
           Forces(3*i+2) += Fz*Har2eV/BohrRad;
         }
       }
-    }
-    if (dummy == "Self")
-    {
-      line >> dummy;
-      if (dummy == "energy")
-      {
-        line >> dummy; //Clear junk
-        line >> dummy; //Ditto
-        line >> dummy; //Ditto
-        line >> dummy; //Ditto
-        line >> Eself; //Actual self-energy of the charges
-      }
-    }
-    //Check for partial QMMM energy
-    if (dummy == "SCF")
-    {
-      line >> dummy;
-      if (dummy == "Done:")
-      {
-        line >> dummy; //Clear junk
-        line >> dummy; //Ditto
-        line >> Eqm; //QM energy
-      }
-    }
-    //Check for charges
-    if (dummy == "Mulliken")
-    {
-      //Mulliken charges (fallback)
-      line >> dummy;
-      if (dummy == "charges:")
+      //Check for charges
+      if ((Section == 1) or (Section == 2))
       {
-        getline(ifile,dummy); //Clear junk
-        for (int i=0;i<Natoms;i++)
+        //Mulliken (fallback) or ESP (MK) charges
+        QMlog.NextLine(); //Clear junk
+        QMlog.NextLine(); //Ditto
+        for (int p=0;p<(Nqm+Npseudo);p++)
         {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            //Count through all atoms in the QM calculations
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> Struct[i].MP[Bead].q;
-          }
+          int i = QMPBList[p]; //Atom ID
+          //Count through all atoms in the QM calculations
+          QMlog.SkipWords(2); //Clear junk
+          QMlog.ReadDouble(Struct[i].MP[Bead].q);
+          QMlog.NextLine();
         }
       }
-    }
-    if (dummy == "ESP")
-    {
-      //ESP (MK) charges
-      line >> dummy;
-      if (dummy == "charges:")
+      if (!GradDone)
       {
-        getline(ifile,dummy); //Clear junk
-        for (int i=0;i<Natoms;i++)
-        {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            //Count through all atoms in the QM calculations
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> Struct[i].MP[Bead].q;
-          }
-        }
+        Section = QMlog.NextMarker();
       }
     }
+    QMlog.Close();
   }
-  QMlog.close();
   //Check for errors
   if (!GradDone)
   {
@@ -684,21 +804,23 @@ double GaussianForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
     cerr.flush(); //Print warning immediately
     //Delete checkpoint
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".chk";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
+    LICHEMRemoveFiles(call.str());
   }
   //Clean up files
   call.str("");
-  call << "rm -f ";
-  call << "LICHM_" << Bead;
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead;
   call << ".log";
   call << " ";
-  call << "LICHM_" << Bead;
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead;
   call << ".com";
-  GlobalSys = system(call.str().c_str());
+  LICHEMRemoveFiles(call.str());
   //Change units and return
   Eqm -= Eself;
   Eqm *= Har2eV;
+  //Save the result for repeated structures and later simulations
+  SavedResults.SaveForces(CacheKey,Struct,Forces-OldForces,Bead,Eqm);
+  QMStore.SaveForces(StoreKey,Struct,Forces-OldForces,Bead,Eqm);
   return Eqm;
 };
 
@@ -709,13 +831,13 @@ MatrixXd GaussianHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   stringstream call; //Stream for system calls and reading/writing files
   call.copyfmt(cout); //Copy print settings
   string dummy; //Generic string
-  fstream ofile,ifile,QMlog; //Generic input files
+  fstream ofile,ifile; //Generic input files
   int Ndof = 3*(Nqm+Npseudo);
   MatrixXd QMHess(Ndof,Ndof);
   QMHess.setZero();
   //Check if there is a checkpoint file
   call.str("");
-  call << "LICHM_" << Bead << ".chk";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
   bool UseCheckPoint = CheckFile(call.str());
   if (QMMMOpts.Func == "SemiEmp")
   {
@@ -723,8 +845,8 @@ MatrixXd GaussianHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     UseCheckPoint = 0;
     //Remove SemiEmp checkpoints to avoid errors
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".chk";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
+    LICHEMRemoveFiles(call.str());
   }
   //Construct Gaussian input
   call.str("");
@@ -762,70 +884,35 @@ MatrixXd GaussianHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     call << '\n';
   }
   WriteGauInput(Struct,call.str(),QMMMOpts,Bead);
-  //Run Gaussian
-  call.str("");
-  call << "g09 " << "LICHM_" << Bead;
-  GlobalSys = system(call.str().c_str());
-  //Generate formatted checkpoint file
+  //Use a saved result from an earlier simulation
+  uint64_t StoreKey; //Hash of the QM input
   call.str("");
-  call << "LICHM_" << Bead << ".chk";
-  if (CheckFile(call.str()))
-  {
-    //Run formchk
-    call.str("");
-    call << "formchk ";
-    call << "LICHM_" << Bead << ".chk";
-    call << " > LICHM_" << Bead << ".trash; ";
-    call << " rm -f LICHM_" << Bead << ".trash";
-    GlobalSys = system(call.str().c_str());
-  }
-  else
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".com";
+  StoreKey = QMStore.GetKey(call.str(),Bead);
+  if (QMStore.FindHessian(StoreKey,QMHess))
   {
-    //Calculation did not finish
-    cerr << "Error: No checkpoint file found!!!";
-    cerr << '\n';
-    cerr.flush(); //Print warning immediately
-    //Delete checkpoint
-    call.str("");
-    call << "rm -f LICHM_" << Bead << ".chk";
-    GlobalSys = system(call.str().c_str());
+    LICHEMRemoveFiles(call.str());
+    return QMHess;
   }
-  //Open checkpoint file
+  //Run Gaussian
   call.str("");
-  call << "LICHM_" << Bead << ".fchk";
-  QMlog.open(call.str().c_str(),ios_base::in);
-  //Extract Hessian
+  call << "g09 " << "LICHM_" << Bead;
+  GlobalSys = LICHEMSpawn(call.str(),LICHEMJobDir(Bead),"","");
+  //Check if the calculation finished
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  QMLogFile QMlog; //Output file
+  QMlog.Open(call.str());
+  QMlog.AddMarker("SCF Done:",1);
+  bool QMfinished = (QMlog.NextMarker() >= 0);
+  QMlog.Close();
+  //Read the Hessian from the formatted checkpoint file
+  //NB: A failed job can leave the checkpoint of an earlier calculation
+  double E = 0; //QM energy (not used)
   bool HessDone = 0;
-  while (QMlog.good() and (!QMlog.eof()) and (!HessDone))
+  if (QMfinished)
   {
-    //Parse checkpoint file line by line
-    getline(QMlog,dummy);
-    stringstream line(dummy);
-    line >> dummy >> dummy;
-    if (dummy == "Force")
-    {
-      line >> dummy;
-      if (dummy == "Constants")
-      {
-        HessDone = 1; //Recovered the Hessian
-        //Read force constants (lower triangualr)
-        for (int i=0;i<Ndof;i++)
-        {
-          for (int j=0;j<(i+1);j++)
-          {
-            //Read matrix element in scientific notation
-            string matelmt;
-            QMlog >> matelmt; //Save as a string
-            //Change D notation to E notation
-            LICHEMFixSciNot(matelmt);
-            //Convert to a double and save matrix element
-            QMHess(i,j) = atof(matelmt.c_str());
-            //Apply symmetry
-            QMHess(j,i) = QMHess(i,j);
-          }
-        }
-      }
-    }
+    HessDone = GaussianFchk(Struct,Bead,E,NULL,&QMHess);
   }
   //Check for errors
   if (!HessDone)
@@ -836,22 +923,26 @@ MatrixXd GaussianHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     cerr.flush(); //Print warning immediately
     //Delete checkpoint
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".chk";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
+    LICHEMRemoveFiles(call.str());
   }
   //Clean up files
   call.str("");
-  call << "rm -f ";
-  call << "LICHM_" << Bead;
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead;
   call << ".log";
   call << " ";
-  call << "LICHM_" << Bead;
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead;
   call << ".com";
   call << " ";
-  call << "LICHM_" << Bead;
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead;
   call << ".fchk";
-  GlobalSys = system(call.str().c_str());
+  LICHEMRemoveFiles(call.str());
   //Return
+  if (HessDone)
+  {
+    //Save the Hessian for later simulations
+    QMStore.SaveHessian(StoreKey,QMHess);
+  }
   return QMHess;
 };
 
@@ -872,7 +963,7 @@ double GaussianOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   //Write a new XYZ
   //NB: GauExternal needs different input than the rest of the wrappers
   call.str("");
-  call << "LICHMExt_" << Bead << ".xyz";
+  call << LICHEMJobDir(Bead) << "LICHMExt_" << Bead << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   ofile << Natoms << '\n' << '\n';
   for (int i=0;i<Natoms;i++)
@@ -887,7 +978,7 @@ double GaussianOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   ofile.close();
   //Write Gaussian input
   call.str("");
-  call << "LICHMExt_" << Bead << ".com";
+  call << LICHEMJobDir(Bead) << "LICHMExt_" << Bead << ".com";
   ofile.open(call.str().c_str(),ios_base::out);
   call.str("");
   call << "%chk=LICHMExt_" << Bead << ".chk";
@@ -916,9 +1007,14 @@ double GaussianOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call << "#P " << "external=\"lichem -GauExtern ";
   call << "LICHMExt_" << Bead;  //Just the stub
   call << " -n " << ExtCPUs;
-  call << " -c " << confilename;
-  call << " -r " << regfilename;
+  call << " -c " << LICHEMFullPath(confilename);
+  call << " -r " << LICHEMFullPath(regfilename);
   call << " -b " << Bead;
+  if (ScratchTop != "")
+  {
+    //Run GauExternal in the working directory with the same bead files
+    call << " -w " << LICHEMFullPath(".");
+  }
   call << "\"" << '\n';
   call << "Symmetry=None Opt=(";
   call << "MaxCycles=" << QMMMOpts.MaxOptSteps;
@@ -955,10 +1051,10 @@ double GaussianOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call.str("");
   call << "g09 ";
   call << "LICHMExt_" << Bead;
-  GlobalSys = system(call.str().c_str());
+  GlobalSys = LICHEMSpawn(call.str(),LICHEMJobDir(Bead),"","");
   //Read new structure
   call.str("");
-  call << "LICHMExt_";
+  call << LICHEMJobDir(Bead) << "LICHMExt_";
   call << Bead << ".log";
   ifile.open(call.str().c_str(),ios_base::in);
   bool Optfinished = 0;
@@ -978,19 +1074,17 @@ double GaussianOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
         //Clear junk
         getline(ifile,dummy);
         getline(ifile,dummy);
-        for (int i=0;i<Natoms;i++)
+        for (int p=0;p<(Nqm+Npseudo);p++)
         {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            //Get new coordinates
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> dummy;
-            line >> Struct[i].P[Bead].x;
-            line >> Struct[i].P[Bead].y;
-            line >> Struct[i].P[Bead].z;
-          }
+          int i = QMPBList[p]; //Atom ID
+          //Get new coordinates
+          getline(ifile,dummy);
+          stringstream line(dummy);
+          line >> dummy >> dummy;
+          line >> dummy;
+          line >> Struct[i].P[Bead].x;
+          line >> Struct[i].P[Bead].y;
+          line >> Struct[i].P[Bead].z;
         }
       }
     }
@@ -1006,9 +1100,9 @@ double GaussianOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   ifile.close();
   //Clean up files
   call.str("");
-  call << "rm -f LICHMExt_";
+  call << LICHEMJobDir(Bead) << "LICHMExt_";
   call << Bead << ".*";
-  GlobalSys = system(call.str().c_str());
+  LICHEMRemoveFiles(call.str());
   //Print warnings and errors
   if (!Optfinished)
   {
@@ -1020,8 +1114,8 @@ double GaussianOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     cerr.flush(); //Print warning immediately
     //Delete checkpoint
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".chk";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".chk";
+    LICHEMRemoveFiles(call.str());
   }
   //Calculate new point-charges and return
   GaussianCharges(Struct,QMMMOpts,Bead);
@@ -54,6 +54,11 @@ void ReadArgs(int& argc, char**& argv, fstream& xyzfile,
       //Create BASIS files
       LICHEM2BASIS(argc,argv);
     }
+    if (dummy == "-traj")
+    {
+      //Create an XYZ trajectory from a binary trajectory
+      BinTraj2XYZ(argc,argv);
+    }
     if (dummy == "-q")
     {
       //Create a QM connectivity file
@@ -94,6 +99,11 @@ void ReadArgs(int& argc, char**& argv, fstream& xyzfile,
     //Make QM, PB, and BA atoms come before MM atoms
     ReorderQMPBBA(argc,argv);
   }
+  if (dummy == "-selftest")
+  {
+    //Check the random numbers and binary trajectories
+    LICHEMSelfTest(argc,argv);
+  }
   if ((argc % 2) != 1)
   {
     //Check for help or missing arguments
@@ -331,6 +341,25 @@ void ReadLICHEMInput(fstream& xyzfile, fstream& connectfile,
       //Read the Monte Carlo acceptance ratio
       regionfile >> QMMMOpts.accratio;
     }
+    else if (keyword == "bead_moves:")
+    {
+      //Read the type of path-integral bead move
+      regionfile >> dummy;
+      LICHEMLowerText(dummy);
+      if (dummy == "uniform")
+      {
+        QMMMOpts.BeadMove = "Uniform";
+      }
+      if (dummy == "staging")
+      {
+        QMMMOpts.BeadMove = "Staging";
+      }
+      if ((dummy == "normal_modes") or (dummy == "normalmodes") or
+         (dummy == "nm"))
+      {
+        QMMMOpts.BeadMove = "NormalModes";
+      }
+    }
     else if (keyword == "beads:")
     {
       //Read the number of replica beads
@@ -500,11 +529,38 @@ void ReadLICHEMInput(fstream& xyzfile, fstream& connectfile,
       //Read the maximum displacement during optimizations
       regionfile >> QMMMOpts.MaxStep;
     }
+    else if (keyword == "mc_chains:")
+    {
+      //Read the number of independent Monte Carlo chains
+      regionfile >> QMMMOpts.Nchains;
+    }
     else if (keyword == "mm_opt_cut:")
     {
       //Read MM optimization cutoff
       regionfile >> QMMMOpts.MMOptCut;
     }
+    else if (keyword == "mm_opt_metric:")
+    {
+      //Read the structure comparison for MM convergence tests
+      regionfile >> dummy;
+      LICHEMLowerText(dummy);
+      if ((dummy == "distmat") or (dummy == "distance_matrix"))
+      {
+        QMMMOpts.OptMetric = "DistMat";
+      }
+      else if ((dummy == "kabsch") or (dummy == "rmsd"))
+      {
+        QMMMOpts.OptMetric = "Kabsch";
+      }
+      else if ((dummy == "displacement") or (dummy == "disp"))
+      {
+        QMMMOpts.OptMetric = "Displacement";
+      }
+      else
+      {
+        QMMMOpts.OptMetric = dummy; //Caught by the error checker
+      }
+    }
     else if (keyword == "mm_opt_tolerance:")
     {
       //Read MM optimization tolerance (RMSD value)
@@ -543,6 +599,34 @@ void ReadLICHEMInput(fstream& xyzfile, fstream& connectfile,
         PBCon = 1;
       }
     }
+    else if (keyword == "pi_factorization:")
+    {
+      //Read the path-integral factorization
+      regionfile >> dummy;
+      LICHEMLowerText(dummy);
+      if (dummy == "primitive")
+      {
+        QMMMOpts.PIFactor = "Primitive";
+      }
+      else if ((dummy == "ti") or (dummy == "takahashi-imada"))
+      {
+        QMMMOpts.PIFactor = "TI";
+      }
+      else
+      {
+        QMMMOpts.PIFactor = dummy; //Caught by the error checker
+      }
+    }
+    else if (keyword == "pi_virial:")
+    {
+      //Check for the centroid virial energy estimator
+      regionfile >> dummy;
+      LICHEMLowerText(dummy);
+      if ((dummy == "yes") or (dummy == "true"))
+      {
+        QMMMOpts.PIVirial = 1;
+      }
+    }
     else if (keyword == "potential_type:")
     {
       //Set QM, MM, and QMMM options
@@ -596,6 +680,11 @@ void ReadLICHEMInput(fstream& xyzfile, fstream& connectfile,
       //Set the basis set or semi-empirical Hamiltonian
       regionfile >> QMMMOpts.Basis;
     }
+    else if (keyword == "qm_beads:")
+    {
+      //Read the number of beads for the contracted QM ring polymer
+      regionfile >> QMMMOpts.QMBeads;
+    }
     else if (keyword == "qm_charge:")
     {
       //Set the total charge on the QM region
@@ -644,6 +733,27 @@ void ReadLICHEMInput(fstream& xyzfile, fstream& connectfile,
       //Set the multiplicity
       regionfile >> QMMMOpts.Spin;
     }
+    else if (keyword == "qm_store:")
+    {
+      //Read the directory for QM results saved between simulations
+      regionfile >> QMMMOpts.QMStoreDir;
+      dummy = QMMMOpts.QMStoreDir;
+      LICHEMLowerText(dummy);
+      if ((dummy == "no") or (dummy == "none") or (dummy == "false"))
+      {
+        QMMMOpts.QMStoreDir = "";
+      }
+    }
+    else if (keyword == "qm_store_check:")
+    {
+      //Read the fraction of saved QM results which are recalculated
+      regionfile >> QMMMOpts.QMStoreCheck;
+    }
+    else if (keyword == "qm_store_size:")
+    {
+      //Read the size limit for the saved QM results (MB)
+      regionfile >> QMMMOpts.QMStoreMB;
+    }
     else if (keyword == "qm_type:")
     {
       //Set QM wrapper
@@ -662,6 +772,33 @@ void ReadLICHEMInput(fstream& xyzfile, fstream& connectfile,
         Gaussian = 1;
       }
     }
+    else if (keyword == "random_seed:")
+    {
+      //Read the seed for the random number streams
+      regionfile >> RandSeed;
+    }
+    else if (keyword == "result_cache:")
+    {
+      //Check if results are saved for repeated structures
+      regionfile >> dummy;
+      LICHEMLowerText(dummy);
+      if ((dummy == "no") or (dummy == "false"))
+      {
+        //Always run the wrappers
+        QMMMOpts.CacheResults = 0;
+      }
+    }
+    else if (keyword == "scratch_dir:")
+    {
+      //Read the root directory for the bead scratch directories
+      regionfile >> QMMMOpts.ScratchDir;
+      dummy = QMMMOpts.ScratchDir;
+      LICHEMLowerText(dummy);
+      if ((dummy == "no") or (dummy == "none") or (dummy == "false"))
+      {
+        QMMMOpts.ScratchDir = "";
+      }
+    }
     else if (keyword == "solv_model:")
     {
       //Read MM implicit solvent model
@@ -672,6 +809,11 @@ void ReadLICHEMInput(fstream& xyzfile, fstream& connectfile,
       //Read the NEB spring constant
       regionfile >> QMMMOpts.Kspring;
     }
+    else if (keyword == "staging_length:")
+    {
+      //Read the number of bonds regenerated by staging moves
+      regionfile >> QMMMOpts.StageLen;
+    }
     else if (keyword == "tau_temp:")
     {
       //Read the thermostat relaxation constant
@@ -689,6 +831,50 @@ void ReadLICHEMInput(fstream& xyzfile, fstream& connectfile,
       //Read the molecular dynamics timestep
       regionfile >> QMMMOpts.dt;
     }
+    else if (keyword == "traj_compression:")
+    {
+      //Read the resolution for lossy trajectory compression
+      regionfile >> dummy;
+      LICHEMLowerText(dummy);
+      if ((dummy == "no") or (dummy == "none") or (dummy == "false"))
+      {
+        QMMMOpts.TrajQuant = 0;
+      }
+      else
+      {
+        stringstream file;
+        file << dummy;
+        file >> QMMMOpts.TrajQuant;
+      }
+    }
+    else if (keyword == "traj_format:")
+    {
+      //Read the trajectory file format
+      regionfile >> dummy;
+      LICHEMLowerText(dummy);
+      if (dummy == "binary")
+      {
+        QMMMOpts.BinTraj = 1;
+      }
+      if (dummy == "xyz")
+      {
+        QMMMOpts.BinTraj = 0;
+      }
+    }
+    else if (keyword == "traj_precision:")
+    {
+      //Read the precision of binary trajectories
+      regionfile >> dummy;
+      LICHEMLowerText(dummy);
+      if ((dummy == "single") or (dummy == "float32"))
+      {
+        QMMMOpts.TrajBytes = 4;
+      }
+      if ((dummy == "double") or (dummy == "float64"))
+      {
+        QMMMOpts.TrajBytes = 8;
+      }
+    }
     else if (keyword == "ts_freq:")
     {
       //Check for inactive NEB end-points
@@ -842,6 +1028,8 @@ void ReadLICHEMInput(fstream& xyzfile, fstream& connectfile,
     }
   }
   Nmm = Natoms-Nqm-Npseudo-Nbound; //Set number of MM atoms
+  SetRegionLists(Struct); //Save the atom IDs for each region
+  MCSeedStreams(QMMMOpts,0); //Start the random number streams
   //Replicate atoms
   if (QMMMOpts.Nbeads > 1)
   {
@@ -891,21 +1079,38 @@ void ReadLICHEMInput(fstream& xyzfile, fstream& connectfile,
       //Set transition state
       QMMMOpts.TSBead = ((QMMMOpts.Nbeads-1)/2); //Middle bead
     }
+    //Set the length of the staging moves
+    if (QMMMOpts.StageLen <= 0)
+    {
+      //Regenerate a quarter of the ring
+      QMMMOpts.StageLen = QMMMOpts.Nbeads/4;
+    }
+    if (QMMMOpts.StageLen < 2)
+    {
+      QMMMOpts.StageLen = 2; //At least one bead is moved
+    }
+    if (QMMMOpts.StageLen > QMMMOpts.Nbeads)
+    {
+      QMMMOpts.StageLen = QMMMOpts.Nbeads; //Full ring
+    }
     //Add random displacements for PIMC simulations
     if (PIMCSim)
     {
+      #pragma omp parallel for schedule(dynamic)
       for (int i=0;i<Natoms;i++)
       {
         //Shift path-integral beads
         double MassScale = sqrt(12.0/Struct[i].m); //Relative to carbon
         MassScale *= 2*StepMin*CentRatio; //Scale based on settings
+        RandomStream AtomRand; //Random numbers for this atom
+        AtomRand.Seed(RandSeed,QMMMOpts.Chain,RandStart,i);
         //Update all beads
         for (int j=0;j<(QMMMOpts.Nbeads-1);j++)
         {
           //Pick random displacements
-          double randx = (((double)rand())/((double)RAND_MAX));
-          double randy = (((double)rand())/((double)RAND_MAX));
-          double randz = (((double)rand())/((double)RAND_MAX));
+          double randx = AtomRand.Uniform();
+          double randy = AtomRand.Uniform();
+          double randz = AtomRand.Uniform();
           //Place the first bead at the initial position
           if (j == 0)
           {
@@ -1101,6 +1306,69 @@ void LICHEMErrorChecker(QMMMSettings& QMMMOpts)
       cout << '\n' << '\n';
     }
   }
+  //Check ring polymer contraction settings
+  if ((QMMMOpts.QMBeads > 0) and (QMMMOpts.QMBeads < QMMMOpts.Nbeads))
+  {
+    if (!PIMCSim)
+    {
+      //Only the PIMC energies use the contracted ring
+      QMMMOpts.QMBeads = 0;
+      cout << "Warning: Ring polymer contraction is only used for PIMC.";
+      cout << '\n' << '\n';
+    }
+    else if (QMMM and LICHEMMMUsesQMCharges(QMMMOpts))
+    {
+      //The MM beads cannot use the charges of the contracted beads
+      cout << " Error: Ring polymer contraction needs an MM energy which";
+      cout << " does not use the QM charges.";
+      cout << '\n';
+      DoQuit = 1;
+    }
+  }
+  //Check the structure comparison for MM optimizations
+  if ((QMMMOpts.OptMetric != "DistMat") and
+     (QMMMOpts.OptMetric != "Kabsch") and
+     (QMMMOpts.OptMetric != "Displacement"))
+  {
+    cout << " Error: Unrecognized MM optimization metric: ";
+    cout << QMMMOpts.OptMetric << '\n';
+    DoQuit = 1;
+  }
+  //Check path-integral factorization and estimator settings
+  if ((QMMMOpts.PIFactor != "Primitive") and (QMMMOpts.PIFactor != "TI"))
+  {
+    cout << " Error: Unrecognized path-integral factorization: ";
+    cout << QMMMOpts.PIFactor << '\n';
+    DoQuit = 1;
+  }
+  bool PIForces = (QMMMOpts.PIFactor == "TI") or QMMMOpts.PIVirial;
+  if (PIForces and ((!PIMCSim) or MMonly))
+  {
+    //Only the QM and QMMM PIMC energies calculate forces
+    QMMMOpts.PIFactor = "Primitive";
+    QMMMOpts.PIVirial = 0;
+    cout << "Warning: The Takahashi-Imada factorization and the virial";
+    cout << " estimator are only used for QM and QMMM PIMC.";
+    cout << '\n' << '\n';
+  }
+  else if (PIForces and (QMMMOpts.QMBeads > 0) and
+          (QMMMOpts.QMBeads < QMMMOpts.Nbeads))
+  {
+    //The contracted beads do not have forces for every bead
+    cout << " Error: Ring polymer contraction cannot be used with the";
+    cout << " Takahashi-Imada factorization or the virial estimator.";
+    cout << '\n';
+    DoQuit = 1;
+  }
+  if (QMMMOpts.PIVirial and
+     ((QMMMOpts.PIFactor == "TI") or (QMMMOpts.Nbeads == 1)))
+  {
+    //The estimator is only valid for a primitive ring polymer
+    QMMMOpts.PIVirial = 0;
+    cout << "Warning: The virial estimator needs the primitive";
+    cout << " factorization and more than one bead.";
+    cout << '\n' << '\n';
+  }
   //Check Ewald and implicit solvation settings
   if (QMMMOpts.UseEwald and (!PBCon))
   {
@@ -1116,6 +1384,83 @@ void LICHEMErrorChecker(QMMMSettings& QMMMOpts)
     cout << '\n';
     DoQuit = 1;
   }
+  //Check trajectory settings
+  if (QMMMOpts.TrajQuant < 0)
+  {
+    //Compression needs a positive grid spacing
+    QMMMOpts.TrajQuant = 0;
+    cout << " Warning: Invalid trajectory compression.";
+    cout << " Compression turned off.";
+    cout << '\n' << '\n';
+  }
+  //Check Monte Carlo chains
+  if (QMMMOpts.Nchains < 1)
+  {
+    cout << " Error: The number of Monte Carlo chains must be positive.";
+    cout << '\n';
+    DoQuit = 1;
+  }
+  else if ((QMMMOpts.Nchains > 1) and (!PIMCSim))
+  {
+    //Only Monte Carlo simulations use chains
+    QMMMOpts.Nchains = 1;
+    cout << "Warning: Multiple chains are only used for Monte Carlo.";
+    cout << '\n' << '\n';
+  }
+  else if ((QMMMOpts.Nchains > 1) and (QMMMOpts.Ensemble == "NPT"))
+  {
+    //The box size is shared by all chains
+    cout << " Error: Multiple Monte Carlo chains need the NVT ensemble.";
+    cout << '\n';
+    DoQuit = 1;
+  }
+  if ((QMMMOpts.Nchains > 1) and (QMMMOpts.ScratchDir == ""))
+  {
+    //Each chain needs its own directories for the wrapper files
+    QMMMOpts.ScratchDir = ".";
+  }
+  //Check scratch directory
+  if (QMMMOpts.ScratchDir != "")
+  {
+    struct stat buffer;
+    if ((stat(QMMMOpts.ScratchDir.c_str(),&buffer) != 0) or
+       (!S_ISDIR(buffer.st_mode)))
+    {
+      //The root directory is not created by LICHEM
+      cout << " Error: Scratch directory " << QMMMOpts.ScratchDir;
+      cout << " does not exist.";
+      cout << '\n';
+      DoQuit = 1;
+    }
+  }
+  //Check saved QM results
+  if (QMMMOpts.QMStoreDir != "")
+  {
+    if (QMMMOpts.QMStoreMB <= 0)
+    {
+      cout << " Error: The size limit for saved QM results must be";
+      cout << " positive.";
+      cout << '\n';
+      DoQuit = 1;
+    }
+    if ((QMMMOpts.QMStoreCheck < 0) or (QMMMOpts.QMStoreCheck > 1))
+    {
+      //Keep the fraction between 0 and 1
+      if (QMMMOpts.QMStoreCheck < 0)
+      {
+        QMMMOpts.QMStoreCheck = 0;
+      }
+      else
+      {
+        QMMMOpts.QMStoreCheck = 1;
+      }
+      cout << " Warning: The fraction of recalculated QM results must be";
+      cout << " between 0 and 1.";
+      cout << '\n';
+      cout << " Fraction set to " << QMMMOpts.QMStoreCheck << ".";
+      cout << '\n' << '\n';
+    }
+  }
   //Check threading
   if (Ncpus < 1)
   {
@@ -1252,6 +1597,20 @@ void LICHEMPrintSettings(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
   cout << " Coordinate file: " << xyzfilename << '\n';
   cout << " Connectivity file: " << confilename << '\n';
   cout << " Region file: " << regfilename << '\n';
+  if (QMMMOpts.ScratchDir != "")
+  {
+    cout << " Scratch directory: " << QMMMOpts.ScratchDir << '\n';
+  }
+  if (QMMMOpts.QMStoreDir != "")
+  {
+    cout << " Saved QM results: " << QMMMOpts.QMStoreDir;
+    cout << " (" << QMMMOpts.QMStoreMB << " MB";
+    if (QMMMOpts.QMStoreCheck > 0)
+    {
+      cout << ", " << (100*QMMMOpts.QMStoreCheck) << "% recalculated";
+    }
+    cout << ")" << '\n';
+  }
   cout << '\n';
   cout << "Atoms: " << Natoms << '\n';
   if (QMonly or QMMM)
@@ -1588,6 +1947,34 @@ void LICHEMPrintSettings(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
     cout << '\n';
     cout << " Sample every " << QMMMOpts.Nprint;
     cout << " steps" << '\n';
+    cout << " Random seed: " << RandSeed;
+    cout << '\n';
+    if (QMMMOpts.Nchains > 1)
+    {
+      cout << " Independent chains: " << QMMMOpts.Nchains;
+      cout << '\n';
+    }
+    if (QMMMOpts.Nbeads > 1)
+    {
+      cout << " Bead moves: " << QMMMOpts.BeadMove;
+      if (QMMMOpts.BeadMove == "Staging")
+      {
+        cout << " (" << QMMMOpts.StageLen << " bonds)";
+      }
+      cout << '\n';
+      if ((QMMMOpts.QMBeads > 0) and (QMMMOpts.QMBeads < QMMMOpts.Nbeads))
+      {
+        cout << " QM beads (contracted ring): " << QMMMOpts.QMBeads;
+        cout << '\n';
+      }
+      cout << " Path-integral factorization: " << QMMMOpts.PIFactor;
+      cout << '\n';
+      if (QMMMOpts.PIVirial)
+      {
+        cout << " Centroid virial estimator: Yes";
+        cout << '\n';
+      }
+    }
   }
   //Print convergence criteria for optimizations
   if (OptSim or SteepSim or QuickSim or DFPSim or
@@ -1657,6 +2044,20 @@ void LICHEMPrintSettings(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
     {
       cout << '\n';
       cout << "MM convergence criteria:" << '\n';
+      cout << " Metric: ";
+      if (QMMMOpts.OptMetric == "Kabsch")
+      {
+        cout << "Kabsch aligned RMSD";
+      }
+      else if (QMMMOpts.OptMetric == "Displacement")
+      {
+        cout << "Atomic displacements";
+      }
+      else
+      {
+        cout << "Distance matrix";
+      }
+      cout << '\n';
       cout << " RMS deviation: " << QMMMOpts.MMOptTol;
       cout << " \u212B" << '\n';
       cout << " RMS force: ";
@@ -1664,6 +2065,29 @@ void LICHEMPrintSettings(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
       cout << " eV/\u212B" << '\n';
     }
   }
+  //Print binary trajectory settings
+  if (QMMMOpts.BinTraj)
+  {
+    cout << '\n';
+    cout << "Trajectory settings:" << '\n';
+    cout << " Format: Binary" << '\n';
+    cout << " Precision: ";
+    if (QMMMOpts.TrajQuant > 0)
+    {
+      cout << "Compressed, ";
+      cout << QMMMOpts.TrajQuant;
+      cout << " \u212B";
+    }
+    else if (QMMMOpts.TrajBytes == 4)
+    {
+      cout << "Single";
+    }
+    else
+    {
+      cout << "Double";
+    }
+    cout << '\n';
+  }
   //Print frequency analysis settings
   if (FreqCalc or QMMMOpts.NEBFreq)
   {
@@ -36,9 +36,16 @@ double LAMMPSEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call.copyfmt(cout); //Copy settings from cout
   double E = 0.0;
   int ct; //Generic counter
+  //Use a saved result for repeated structures
+  uint64_t CacheKey; //Hash of the inputs
+  CacheKey = SavedResults.GetKey("LAMMPSEnergy",Struct,QMMMOpts,Bead,0,1);
+  if (SavedResults.FindEnergy(CacheKey,Struct,Bead,E))
+  {
+    return E;
+  }
   //Construct LAMMPS data file
   call.str("");
-  call << "LICHM_" << Bead << ".data";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".data";
   ofile.open(call.str().c_str(),ios_base::out);
   ifile.open("DATA",ios_base::in);
   call.str("");
@@ -101,7 +108,7 @@ double LAMMPSEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   ofile.close();
   //Construct input file
   call.str("");
-  call << "LICHM_" << Bead << ".in";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".in";
   ofile.open(call.str().c_str(),ios_base::out);
   call.str("");
   call << "atom_style full" << '\n';
@@ -132,23 +139,21 @@ double LAMMPSEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     //Partition atoms into groups
     call << "group qm id "; //QM and PB
     ct = 0;
-    for (int i=0;i<Natoms;i++)
+    for (int p=0;p<(Nqm+Npseudo);p++)
     {
-      if (Struct[i].QMregion or Struct[i].PBregion)
+      int i = QMPBList[p]; //Atom ID
+      call << (Struct[i].id+1); //LAMMPS id
+      ct += 1;
+      if (ct == 10)
       {
-        call << (Struct[i].id+1); //LAMMPS id
-        ct += 1;
-        if (ct == 10)
-        {
-          //Break up lines
-          call << " \\" << '\n';
-          ct = 0;
-        }
-        else
-        {
-          //Add spaces
-          call << " ";
-        }
+        //Break up lines
+        call << " \\" << '\n';
+        ct = 0;
+      }
+      else
+      {
+        //Add spaces
+        call << " ";
       }
     }
     if (ct != 0)
@@ -201,12 +206,14 @@ double LAMMPSEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call.str("");
   call << "lammps -suffix omp -log LICHM_";
   call << Bead;
-  call << ".log < LICHM_";
-  call << Bead;
-  call << ".in > LICHMlog_";
-  call << Bead;
-  call << ".txt";
-  GlobalSys = system(call.str().c_str());
+  call << ".log";
+  string cmd = call.str(); //Command to run
+  call.str("");
+  call << "LICHM_" << Bead << ".in";
+  string inname = call.str(); //Input file
+  call.str("");
+  call << "LICHMlog_" << Bead << ".txt";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),inname,call.str());
   //Extract energy
   exit(0);
   
@@ -220,6 +227,8 @@ double LAMMPSEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call << "_" << Bead;
   call << ".log LICHMlog_";
   call << Bead << ".txt";
+  //Save the result for repeated structures
+  SavedResults.SaveEnergy(CacheKey,Struct,Bead,E);
   return E;
 };
 
@@ -284,7 +293,7 @@ double LAMMPSOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   ofile.close();
   //Construct input file
   call.str("");
-  call << "LICHM_" << Bead << ".in";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".in";
   ofile.open(call.str().c_str(),ios_base::out);
   call.str("");
   call << "atom_style full" << '\n';
@@ -307,23 +316,21 @@ double LAMMPSOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     //Partition atoms into groups
     call << "group qm id "; //QM and PB
     ct = 0;
-    for (int i=0;i<Natoms;i++)
+    for (int p=0;p<(Nqm+Npseudo);p++)
     {
-      if (Struct[i].QMregion or Struct[i].PBregion)
+      int i = QMPBList[p]; //Atom ID
+      call << (Struct[i].id+1); //LAMMPS id
+      ct += 1;
+      if (ct == 10)
       {
-        call << (Struct[i].id+1); //LAMMPS id
-        ct += 1;
-        if (ct == 10)
-        {
-          //Break up lines
-          call << " \\" << '\n';
-          ct = 0;
-        }
-        else
-        {
-          //Add spaces
-          call << " ";
-        }
+        //Break up lines
+        call << " \\" << '\n';
+        ct = 0;
+      }
+      else
+      {
+        //Add spaces
+        call << " ";
       }
     }
     if (ct != 0)
@@ -380,10 +387,13 @@ double LAMMPSOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call.str("");
   call << "lammps -suffix omp -log ";
   call << "LICHM_" << Bead;
-  call << "< LICHM_" << Bead;
-  call << ".in > LICHMlog_" << Bead;
-  call << ".txt";
-  GlobalSys = system(call.str().c_str());
+  string cmd = call.str(); //Command to run
+  call.str("");
+  call << "LICHM_" << Bead << ".in";
+  string inname = call.str(); //Input file
+  call.str("");
+  call << "LICHMlog_" << Bead << ".txt";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),inname,call.str());
   //Extract new geometry
   
   //Clean up files
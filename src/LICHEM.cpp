@@ -23,7 +23,7 @@ int main(int argc, char* argv[])
 {
   //Misc. initialization
   StartTime = (unsigned)time(0); //Time the program starts
-  srand((unsigned)time(0)); //Serial only random numbers
+  RandSeed = (uint64_t)time(0); //Changed by the random_seed keyword
   //End of section
 
   //Output stream settings
@@ -34,13 +34,12 @@ int main(int argc, char* argv[])
 
   //Initialize local variables
   string dummy; //Generic string
-  double SumE,SumE2,DenAvg,LxAvg,LyAvg,LzAvg,Ek; //Energies and properties
+  double SumE; //Total energy
   fstream xyzfile,connectfile,regionfile,outfile; //Input and output files
   vector<QMMMAtom> Struct; //Atom list
   vector<QMMMAtom> OldStruct; //A copy of the atoms list
   vector<QMMMElec> Elecs; //Semi-classical electrons (eFF model)
   QMMMSettings QMMMOpts; //QM and MM wrapper settings
-  int randnum; //Random integer
   //End of section
 
   //Print title and compile date
@@ -83,13 +82,26 @@ int main(int argc, char* argv[])
   //Create backup directories
   if (CheckFile("BACKUPQM"))
   {
-    stringstream call;
-    call.str("");
     //Delete old files
-    call << "rm -rf " << QMMMOpts.BackDir << "; ";
+    LICHEMRemoveDir(QMMMOpts.BackDir);
     //Create new directory
-    call << "mkdir " << QMMMOpts.BackDir;
-    GlobalSys = system(call.str().c_str());
+    LICHEMMakeDir(QMMMOpts.BackDir);
+  }
+  //End of section
+
+  //Create bead scratch directories
+  LICHEMMakeScratch(QMMMOpts);
+  //End of section
+
+  //Open the QM results from earlier simulations
+  QMStore.Open(QMMMOpts);
+  //End of section
+
+  //Create storage for shared MM calculations
+  if (TINKER)
+  {
+    //Polarization energies and forces are saved for each bead
+    TINKERPolResults.resize(QMMMOpts.Nbeads*QMMMOpts.Nchains);
   }
   //End of section
 
@@ -104,8 +116,9 @@ int main(int argc, char* argv[])
   //Calculate single-point energy
   if (SinglePoint)
   {
-    double Eqm; //QM energy
-    double Emm; //MM energy
+    vector<double> Eqm(QMMMOpts.Nbeads,0.0); //QM energies
+    vector<double> Emm(QMMMOpts.Nbeads,0.0); //MM energies
+    vector<int> Beads; //List of all beads
     if (QMMMOpts.Nbeads == 1)
     {
       cout << "Single-point energy:";
@@ -116,73 +129,36 @@ int main(int argc, char* argv[])
     }
     cout << '\n' << '\n';
     cout.flush(); //Print progress
+    //Calculate QMMM energies for all beads
+    for (int p=0;p<QMMMOpts.Nbeads;p++)
+    {
+      Beads.push_back(p);
+    }
+    LICHEMBeadEnergies(Struct,QMMMOpts,Beads,Eqm,Emm);
     //Loop over all beads
     for (int p=0;p<QMMMOpts.Nbeads;p++)
     {
-      //Calculate QMMM energy
-      Eqm = 0; //Reset QM energy
-      Emm = 0; //Reset MM energy
-      //Calculate QM energy
       if (QMMMOpts.Nbeads > 1)
       {
         cout << " Energy for bead: " << p << '\n';
         cout.flush();
       }
-      if (Gaussian)
-      {
-        int tstart = (unsigned)time(0);
-        Eqm += GaussianEnergy(Struct,QMMMOpts,p);
-        QMTime += (unsigned)time(0)-tstart;
-      }
-      if (PSI4)
-      {
-        int tstart = (unsigned)time(0);
-        Eqm += PSI4Energy(Struct,QMMMOpts,p);
-        QMTime += (unsigned)time(0)-tstart;
-        //Delete annoying useless files
-        GlobalSys = system("rm -f psi.* timer.*");
-      }
-      if (NWChem)
-      {
-        int tstart = (unsigned)time(0);
-        Eqm += NWChemEnergy(Struct,QMMMOpts,p);
-        QMTime += (unsigned)time(0)-tstart;
-      }
       if (QMMM or QMonly)
       {
         //Print QM partial energy
-        cout << "  QM energy: " << LICHEMFormFloat(Eqm,16) << " eV";
+        cout << "  QM energy: " << LICHEMFormFloat(Eqm[p],16) << " eV";
         cout << '\n';
         //Print progress
         cout.flush();
       }
-      //Calculate MM energy
-      if (TINKER)
-      {
-        int tstart = (unsigned)time(0);
-        Emm += TINKEREnergy(Struct,QMMMOpts,p);
-        MMTime += (unsigned)time(0)-tstart;
-      }
-      if (AMBER)
-      {
-        int tstart = (unsigned)time(0);
-        Emm += AMBEREnergy(Struct,QMMMOpts,p);
-        MMTime += (unsigned)time(0)-tstart;
-      }
-      if (LAMMPS)
-      {
-        int tstart = (unsigned)time(0);
-        Emm += LAMMPSEnergy(Struct,QMMMOpts,p);
-        MMTime += (unsigned)time(0)-tstart;
-      }
       //Print the rest of the energies
       if (QMMM or MMonly)
       {
         //Print MM partial energy
-        cout << "  MM energy: " << LICHEMFormFloat(Emm,16) << " eV";
+        cout << "  MM energy: " << LICHEMFormFloat(Emm[p],16) << " eV";
         cout << '\n';
       }
-      SumE = Eqm+Emm; //Total energy
+      SumE = Eqm[p]+Emm[p]; //Total energy
       if (QMMM)
       {
         //Print total energy
@@ -215,58 +191,35 @@ int main(int argc, char* argv[])
     }
     cout << '\n';
     cout.flush(); //Print progress
+    //Calculate QMMM Hessians for all beads
+    vector<MatrixXd> BeadHess(QMMMOpts.Nbeads); //Hessian of each bead
+    vector<int> Beads; //List of all beads
+    for (int p=0;p<QMMMOpts.Nbeads;p++)
+    {
+      Beads.push_back(p);
+    }
+    vector<int> Order = BeadJobs.Order(Beads); //Most expensive beads first
+    #pragma omp parallel for schedule(dynamic) \
+            num_threads(BeadJobs.Slots(QMMMOpts.Nbeads))
+    for (int j=0;j<QMMMOpts.Nbeads;j++)
+    {
+      int p = Order[j]; //Bead ID
+      BeadJobs.Start(p);
+      BeadHess[p] = LICHEMBeadHessian(Struct,QMMMOpts,p);
+      BeadJobs.Finish(p);
+    }
     //Loop over all beads
     for (int p=0;p<QMMMOpts.Nbeads;p++)
     {
       //Calculate QMMM frequencies
-      QMMMHess.setZero(); //Reset frequencies
+      QMMMHess = BeadHess[p];
       QMMMFreqs.setZero();
-      //Calculate QM energy
       if (QMMMOpts.Nbeads > 1)
       {
         cout << '\n';
         cout << " Frequencies for bead: " << p << '\n';
         cout.flush();
       }
-      if (Gaussian)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += GaussianHessian(Struct,QMMMOpts,p);
-        QMTime += (unsigned)time(0)-tstart;
-      }
-      if (PSI4)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += PSI4Hessian(Struct,QMMMOpts,p);
-        QMTime += (unsigned)time(0)-tstart;
-        //Delete annoying useless files
-        GlobalSys = system("rm -f psi.* timer.*");
-      }
-      if (NWChem)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += NWChemHessian(Struct,QMMMOpts,p);
-        QMTime += (unsigned)time(0)-tstart;
-      }
-      //Calculate MM energy
-      if (TINKER)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += TINKERHessian(Struct,QMMMOpts,p);
-        MMTime += (unsigned)time(0)-tstart;
-      }
-      if (AMBER)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += AMBERHessian(Struct,QMMMOpts,p);
-        MMTime += (unsigned)time(0)-tstart;
-      }
-      if (LAMMPS)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += LAMMPSHessian(Struct,QMMMOpts,p);
-        MMTime += (unsigned)time(0)-tstart;
-      }
       //Calculate frequencies
       QMMMFreqs = LICHEMFreq(Struct,QMMMHess,QMMMOpts,p,remct);
       //Print the frequencies
@@ -318,46 +271,8 @@ int main(int argc, char* argv[])
     cout.flush(); //Print progress
     //Calculate initial energy
     SumE = 0; //Clear old energies
-    //Calculate QM energy
-    if (Gaussian)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += GaussianEnergy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-    }
-    if (PSI4)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += PSI4Energy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-      //Delete annoying useless files
-      GlobalSys = system("rm -f psi.* timer.*");
-    }
-    if (NWChem)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += NWChemEnergy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-    }
-    //Calculate MM energy
-    if (TINKER)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += TINKEREnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
-    if (AMBER)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += AMBEREnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
-    if (LAMMPS)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += LAMMPSEnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
+    //Calculate QMMM energy
+    SumE += LICHEMBeadEnergy(Struct,QMMMOpts,0);
     cout << " | Opt. step: ";
     cout << optct << " | Energy: ";
     cout << LICHEMFormFloat(SumE,16) << " eV";
@@ -412,7 +327,7 @@ int main(int argc, char* argv[])
         SumE = PSI4Opt(Struct,QMMMOpts,0);
         QMTime += (unsigned)time(0)-tstart;
         //Delete annoying useless files
-        GlobalSys = system("rm -f psi.* timer.*");
+        PSI4Cleanup(0);
       }
       if (NWChem)
       {
@@ -444,46 +359,8 @@ int main(int argc, char* argv[])
     cout.flush(); //Print progress
     //Calculate initial energy
     SumE = 0; //Clear old energies
-    //Calculate QM energy
-    if (Gaussian)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += GaussianEnergy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-    }
-    if (PSI4)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += PSI4Energy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-      //Delete annoying useless files
-      GlobalSys = system("rm -f psi.* timer.* ");
-    }
-    if (NWChem)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += NWChemEnergy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-    }
-    //Calculate MM energy
-    if (TINKER)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += TINKEREnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
-    if (AMBER)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += AMBEREnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
-    if (LAMMPS)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += LAMMPSEnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
+    //Calculate QMMM energy
+    SumE += LICHEMBeadEnergy(Struct,QMMMOpts,0);
     cout << " | Opt. step: ";
     cout << optct << " | Energy: ";
     cout << LICHEMFormFloat(SumE,16) << " eV";
@@ -547,46 +424,8 @@ int main(int argc, char* argv[])
     cout.flush(); //Print progress
     //Calculate initial energy
     SumE = 0; //Clear old energies
-    //Calculate QM energy
-    if (Gaussian)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += GaussianEnergy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-    }
-    if (PSI4)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += PSI4Energy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-      //Delete annoying useless files
-      GlobalSys = system("rm -f psi.* timer.* ");
-    }
-    if (NWChem)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += NWChemEnergy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-    }
-    //Calculate MM energy
-    if (TINKER)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += TINKEREnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
-    if (AMBER)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += AMBEREnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
-    if (LAMMPS)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += LAMMPSEnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
+    //Calculate QMMM energy
+    SumE += LICHEMBeadEnergy(Struct,QMMMOpts,0);
     cout << " | Opt. step: ";
     cout << optct << " | Energy: ";
     cout << LICHEMFormFloat(SumE,16) << " eV";
@@ -661,46 +500,8 @@ int main(int argc, char* argv[])
     cout.flush(); //Print progress
     //Calculate initial energy
     SumE = 0; //Clear old energies
-    //Calculate QM energy
-    if (Gaussian)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += GaussianEnergy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-    }
-    if (PSI4)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += PSI4Energy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-      //Delete annoying useless files
-      GlobalSys = system("rm -f psi.* timer.*");
-    }
-    if (NWChem)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += NWChemEnergy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-    }
-    //Calculate MM energy
-    if (TINKER)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += TINKEREnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
-    if (AMBER)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += AMBEREnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
-    if (LAMMPS)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += LAMMPSEnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
+    //Calculate QMMM energy
+    SumE += LICHEMBeadEnergy(Struct,QMMMOpts,0);
     cout << " | Opt. step: ";
     cout << optct << " | Energy: ";
     cout << LICHEMFormFloat(SumE,16) << " eV";
@@ -778,232 +579,97 @@ int main(int argc, char* argv[])
       //Remove volume changes
       VolProb = 0.0;
     }
-    //Initialize local variables
-    SumE = 0; //Average energy
-    SumE2 = 0; //Average squared energy
-    DenAvg = 0; //Average density
-    LxAvg = 0; //Average box length
-    LyAvg = 0; //Average box length
-    LzAvg = 0; //Average box length
-    Ek = 0; //PIMC kinietic energy
-    if (QMMMOpts.Nbeads > 1)
+    if (QMMMOpts.Nchains == 1)
     {
-      //Set kinetic energy
-      Ek = 3*Natoms*QMMMOpts.Nbeads/(2*QMMMOpts.Beta);
-    }
-    int Nct = 0; //Step counter
-    int ct = 0; //Secondary counter
-    double Nacc = 0; //Number of accepted moves
-    double Nrej = 0; //Number of rejected moves
-    double Emc = 0; //Monte Carlo energy
-    double Et = 0; //Total energy for printing
-    bool acc; //Flag for accepting a step
-    //Find the number of characters to print for the step counter
-    int SimCharLen;
-    SimCharLen = QMMMOpts.Neq+QMMMOpts.Nsteps;
-    SimCharLen = LICHEMCount(SimCharLen);
-    //Start equilibration run and calculate initial energy
-    cout << '\n';
-    cout << "Monte Carlo equilibration:" << '\n';
-    cout.flush();
-    QMMMOpts.Eold = 0;
-    QMMMOpts.Eold += Get_PI_Epot(Struct,QMMMOpts);
-    QMMMOpts.Eold += Get_PI_Espring(Struct,QMMMOpts);
-    if (VolProb > 0)
-    {
-      //Add PV term
-      QMMMOpts.Eold += QMMMOpts.Press*Lx*Ly*Lz;
+      //Run a single chain
+      MCRunChain(Struct,QMMMOpts,outfile);
+      //Print simulation details and statistics
+      cout << '\n';
+      if (QMMMOpts.Nbeads > 1)
+      {
+        cout << "PI";
+      }
+      cout << "MC statistics:" << '\n';
+      PrintMCStats(QMMMOpts);
+      cout << '\n';
+      cout.flush();
     }
-    Emc = QMMMOpts.Eold; //Needed if equilibration is skipped
-    Nct = 0;
-    while (Nct < QMMMOpts.Neq)
+    else
     {
-      Emc = 0;
-      //Check step size
-      if(ct == Acc_Check)
+      //Run independent chains at the same time
+      int Nchains = QMMMOpts.Nchains; //Number of chains
+      vector<vector<QMMMAtom> > ChainStructs(Nchains,Struct); //Atoms
+      vector<QMMMSettings> ChainOpts(Nchains,QMMMOpts); //Settings
+      vector<fstream> ChainTrajs(Nchains); //Trajectories of chains 1+
+      string TrajName; //Output filename
+      for (int i=0;i<argc;i++)
       {
-        if ((Nacc/(Nrej+Nacc)) > QMMMOpts.accratio)
+        //Find filename
+        dummy = string(argv[i]);
+        if (dummy == "-o")
         {
-          //Increase step size
-          double randval;
-          randval = (((double)rand())/((double)RAND_MAX));
-          //Use random values to keep from cycling up and down
-          if (randval >= 0.5)
-          {
-            mcstep *= 1.10;
-          }
-          else
-          {
-            mcstep *= 1.09;
-          }
+          TrajName = string(argv[i+1]);
         }
-        if ((Nacc/(Nrej+Nacc)) < QMMMOpts.accratio)
+      }
+      size_t ExtPos = TrajName.rfind('.'); //Start of the file extension
+      if ((ExtPos == string::npos) or (ExtPos == 0) or
+         (TrajName.find('/',ExtPos) != string::npos))
+      {
+        ExtPos = TrajName.size();
+      }
+      for (int c=0;c<Nchains;c++)
+      {
+        //Give each chain its own random numbers and trajectory
+        MCSeedStreams(ChainOpts[c],c);
+        if (c > 0)
         {
-          //Decrease step size
-          double randval;
-          randval = (((double)rand())/((double)RAND_MAX));
-          //Use random values to keep from cycling up and down
-          if (randval >= 0.5)
-          {
-            mcstep *= 0.90;
-          }
-          else
-          {
-            mcstep *= 0.91;
-          }
+          stringstream call; //Trajectory filename
+          call << TrajName.substr(0,ExtPos) << "_chain" << c;
+          call << TrajName.substr(ExtPos);
+          ChainTrajs[c].open(call.str().c_str(),ios_base::out);
         }
-        if (mcstep < StepMin)
+      }
+      int Nslots = BeadJobs.Slots(Nchains); //Chains running at once
+      cout << '\n';
+      cout << "Monte Carlo chains: " << Nchains;
+      cout << " | Running at once: " << Nslots << '\n';
+      cout.flush();
+      #pragma omp parallel for schedule(dynamic) num_threads(Nslots)
+      for (int c=0;c<Nchains;c++)
+      {
+        //Run a chain in its own scratch directories
+        JobChain = c;
+        if (c == 0)
         {
-          //Set to minimum
-          mcstep = StepMin;
+          MCRunChain(ChainStructs[c],ChainOpts[c],outfile);
         }
-        if (mcstep > StepMax)
+        else
         {
-          //Set to maximum
-          mcstep = StepMax;
+          MCRunChain(ChainStructs[c],ChainOpts[c],ChainTrajs[c]);
         }
-        //Statistics
-        cout << " | Step: " << setw(SimCharLen) << Nct;
-        cout << " | Step size: ";
-        cout << LICHEMFormFloat(mcstep,6);
-        cout << " | Accept ratio: ";
-        cout << LICHEMFormFloat((Nacc/(Nrej+Nacc)),6);
-        cout << '\n';
-        cout.flush(); //Print stats
-        //Reset counters
-        ct = 0;
-        Nacc = 0;
-        Nrej = 0;
+        JobChain = 0;
       }
-      //Continue simulation
-      ct += 1;
-      acc = MCMove(Struct,QMMMOpts,Emc);
-      if (acc)
+      for (int c=1;c<Nchains;c++)
       {
-        Nct += 1;
-        Nacc += 1;
-      }
-      else
-      {
-        Nrej += 1;
+        CloseTraj(ChainTrajs[c]);
       }
-    }
-    cout << " Equilibration complete." << '\n';
-    //Start production run
-    Nct = 0;
-    Nacc = 0;
-    Nrej = 0;
-    cout << '\n';
-    cout << "Monte Carlo production:" << '\n';
-    cout.flush();
-    //Print starting conditions
-    Print_traj(Struct,outfile,QMMMOpts);
-    Et = Ek+Emc; //Calculate total energy using previous saved energy
-    Et -= 2*Get_PI_Espring(Struct,QMMMOpts);
-    cout << " | Step: " << setw(SimCharLen) << 0;
-    cout << " | Energy: " << LICHEMFormFloat(Et,12);
-    cout << " eV";
-    if (QMMMOpts.Ensemble == "NPT")
-    {
-      double rho;
-      rho = LICHEMDensity(Struct,QMMMOpts);
-      cout << " | Density: ";
-      cout << LICHEMFormFloat(rho,8);
-      cout << " g/cm\u00B3";
-    }
-    cout << '\n';
-    cout.flush(); //Print results
-    //Continue simulation
-    while (Nct < QMMMOpts.Nsteps)
-    {
-      Emc = 0; //Set energy to zero
-      acc = MCMove(Struct,QMMMOpts,Emc);
-      //Update averages
-      Et = 0;
-      Et += Ek+Emc;
-      Et -= 2*Get_PI_Espring(Struct,QMMMOpts);
-      DenAvg += LICHEMDensity(Struct,QMMMOpts);
-      LxAvg += Lx;
-      LyAvg += Ly;
-      LzAvg += Lz;
-      SumE += Et;
-      SumE2 += Et*Et;
-      //Update counters and print output
-      if (acc)
+      Struct = ChainStructs[0]; //Keep the final structure of the first chain
+      //Print simulation details and statistics
+      for (int c=0;c<Nchains;c++)
       {
-        //Increase counters
-        Nct += 1;
-        Nacc += 1;
-        //Print trajectory and instantaneous energies
-        if ((Nct%QMMMOpts.Nprint) == 0)
+        cout << '\n';
+        if (QMMMOpts.Nbeads > 1)
         {
-          //Print progress
-          Print_traj(Struct,outfile,QMMMOpts);
-          cout << " | Step: " << setw(SimCharLen) << Nct;
-          cout << " | Energy: " << LICHEMFormFloat(Et,12);
-          cout << " eV";
-          if (QMMMOpts.Ensemble == "NPT")
-          {
-            double rho;
-            rho = LICHEMDensity(Struct,QMMMOpts);
-            cout << " | Density: ";
-            cout << LICHEMFormFloat(rho,8);
-            cout << " g/cm\u00B3";
-          }
-          cout << '\n';
-          cout.flush(); //Print results
+          cout << "PI";
         }
+        cout << "MC statistics (chain " << c << "):" << '\n';
+        PrintMCStats(ChainOpts[c]);
       }
-      else
-      {
-        Nrej += 1;
-      }
-    }
-    if ((Nct%QMMMOpts.Nprint) != 0)
-    {
-      //Print final geometry if it was not already written
-      Print_traj(Struct,outfile,QMMMOpts);
-    }
-    SumE /= Nrej+Nacc; //Average energy
-    SumE2 /= Nrej+Nacc; //Variance of the energy
-    DenAvg /= Nrej+Nacc; //Average density
-    LxAvg /= Nrej+Nacc; //Average box size
-    LyAvg /= Nrej+Nacc; //Average box size
-    LzAvg /= Nrej+Nacc; //Average box size
-    //Print simulation details and statistics
-    cout << '\n';
-    if (QMMMOpts.Nbeads > 1)
-    {
-      cout << "PI";
-    }
-    cout << "MC statistics:" << '\n';
-    if (QMMMOpts.Ensemble == "NPT")
-    {
-      //Print simulation box information
-      cout << " | Density: ";
-      cout << LICHEMFormFloat(DenAvg,8);
-      cout << " g/cm\u00B3" << '\n';
-      cout << " | Average box size (\u212B): " << '\n';
-      cout << "  "; //Indent
-      cout << " Lx = " << LICHEMFormFloat(LxAvg,12);
-      cout << " Ly = " << LICHEMFormFloat(LyAvg,12);
-      cout << " Lz = " << LICHEMFormFloat(LzAvg,12);
       cout << '\n';
+      PrintMCChains(ChainOpts);
+      cout << '\n';
+      cout.flush();
     }
-    cout << " | Average energy: ";
-    cout << LICHEMFormFloat(SumE,16);
-    cout << " eV | Variance: ";
-    cout << LICHEMFormFloat((SumE2-(SumE*SumE)),12);
-    cout << " eV\u00B2";
-    cout << '\n';
-    cout << " | Acceptance ratio: ";
-    cout << LICHEMFormFloat((Nacc/(Nrej+Nacc)),6);
-    cout << " | Optimum step size: ";
-    cout << LICHEMFormFloat(mcstep,6);
-    cout << " \u212B";
-    cout << '\n';
-    cout << '\n';
-    cout.flush();
   }
   //End of section
 
@@ -1051,46 +717,46 @@ int main(int argc, char* argv[])
         {
           //Increase step size
           double randval;
-          randval = (((double)rand())/((double)RAND_MAX));
+          randval = QMMMOpts.MCRand.Uniform();
           //Use random values to keep from cycling up and down
           if (randval >= 0.5)
           {
-            mcstep *= 1.10;
+            QMMMOpts.MCStep *= 1.10;
           }
           else
           {
-            mcstep *= 1.09;
+            QMMMOpts.MCStep *= 1.09;
           }
         }
         if ((Nacc/(Nrej+Nacc)) < QMMMOpts.accratio)
         {
           //Decrease step size
           double randval;
-          randval = (((double)rand())/((double)RAND_MAX));
+          randval = QMMMOpts.MCRand.Uniform();
           //Use random values to keep from cycling up and down
           if (randval >= 0.5)
           {
-            mcstep *= 0.90;
+            QMMMOpts.MCStep *= 0.90;
           }
           else
           {
-            mcstep *= 0.91;
+            QMMMOpts.MCStep *= 0.91;
           }
         }
-        if (mcstep < StepMin)
+        if (QMMMOpts.MCStep < StepMin)
         {
           //Set to minimum
-          mcstep = StepMin;
+          QMMMOpts.MCStep = StepMin;
         }
-        if (mcstep > StepMax)
+        if (QMMMOpts.MCStep > StepMax)
         {
           //Set to maximum
-          mcstep = StepMax;
+          QMMMOpts.MCStep = StepMax;
         }
         //Statistics
         cout << " | Step: " << setw(SimCharLen) << Nct;
         cout << " | Step size: ";
-        cout << LICHEMFormFloat(mcstep,6);
+        cout << LICHEMFormFloat(QMMMOpts.MCStep,6);
         cout << " | Accept ratio: ";
         cout << LICHEMFormFloat((Nacc/(Nrej+Nacc)),6);
         cout << '\n';
@@ -1118,11 +784,12 @@ int main(int argc, char* argv[])
     Nct = 0;
     Nacc = 0;
     Nrej = 0;
+    QMMMOpts.MCStat.Clear(); //Only count the production steps
     cout << '\n';
     cout << "Monte Carlo production:" << '\n';
     cout.flush();
     //Print starting conditions
-    Print_traj(Struct,outfile,QMMMOpts);
+    Print_traj(Struct,outfile,QMMMOpts,0,Emc.mean());
     cout << " | Step: " << setw(SimCharLen) << 0;
     cout << " | Average energy: " << LICHEMFormFloat(Emc.mean(),12);
     cout << " eV";
@@ -1146,7 +813,7 @@ int main(int argc, char* argv[])
         if ((Nct%QMMMOpts.Nprint) == 0)
         {
           //Print progress
-          Print_traj(Struct,outfile,QMMMOpts);
+          Print_traj(Struct,outfile,QMMMOpts,Nct,Emc.mean());
           cout << " | Step: " << setw(SimCharLen) << Nct;
           cout << " | Average energy: " << LICHEMFormFloat(Emc.mean(),12);
           cout << " eV";
@@ -1162,7 +829,7 @@ int main(int argc, char* argv[])
     if ((Nct%QMMMOpts.Nprint) != 0)
     {
       //Print final geometry if it was not already written
-      Print_traj(Struct,outfile,QMMMOpts);
+      Print_traj(Struct,outfile,QMMMOpts,Nct,Emc.mean());
     }
     //Calculate statistics
     SumE /= Nrej+Nacc;
@@ -1173,9 +840,10 @@ int main(int argc, char* argv[])
     cout << " | Acceptance ratio: ";
     cout << LICHEMFormFloat((Nacc/(Nrej+Nacc)),6);
     cout << " | Optimum step size: ";
-    cout << LICHEMFormFloat(mcstep,6);
+    cout << LICHEMFormFloat(QMMMOpts.MCStep,6);
     cout << " \u212B";
     cout << '\n';
+    PrintMCStats(QMMMOpts);
     cout << '\n';
     cout.flush();
   }
@@ -1224,21 +892,19 @@ int main(int argc, char* argv[])
       VectorXd Disp; //Store the displacement
       //Save geometries
       int ct = 0; //Reset counter for the number of atoms
-      for (int i=0;i<Natoms;i++)
+      for (int k=0;k<(Nqm+Npseudo);k++)
       {
         //Only include QM and PB regions
-        if (Struct[i].QMregion or Struct[i].PBregion)
-        {
-          //Save current replica
-          Geom1(ct,0) = Struct[i].P[p].x;
-          Geom1(ct,1) = Struct[i].P[p].y;
-          Geom1(ct,2) = Struct[i].P[p].z;
-          //Save replica p+1
-          Geom2(ct,0) = Struct[i].P[p+1].x;
-          Geom2(ct,1) = Struct[i].P[p+1].y;
-          Geom2(ct,2) = Struct[i].P[p+1].z;
-          ct += 1;
-        }
+        int i = QMPBList[k]; //Atom ID
+        //Save current replica
+        Geom1(ct,0) = Struct[i].P[p].x;
+        Geom1(ct,1) = Struct[i].P[p].y;
+        Geom1(ct,2) = Struct[i].P[p].z;
+        //Save replica p+1
+        Geom2(ct,0) = Struct[i].P[p+1].x;
+        Geom2(ct,1) = Struct[i].P[p+1].y;
+        Geom2(ct,2) = Struct[i].P[p+1].z;
+        ct += 1;
       }
       //Calculate displacement
       Disp = KabschDisplacement(Geom1,Geom2,(Nqm+Npseudo));
@@ -1248,49 +914,26 @@ int main(int argc, char* argv[])
     ReactCoord /= ReactCoord.maxCoeff(); //Must be between 0 and 1
     //Calculate initial energies
     QMMMOpts.Ets = -1*HugeNum; //Locate the initial transition state
-    for (int p=0;p<QMMMOpts.Nbeads;p++)
+    vector<double> Eqm(QMMMOpts.Nbeads,0.0); //QM energies
+    vector<double> Emm(QMMMOpts.Nbeads,0.0); //MM energies
+    if (!QMMMOpts.StartPathChk)
     {
-      SumE = 0; //Clear old energies
-      //Calculate QM energy
-      if (Gaussian)
-      {
-        int tstart = (unsigned)time(0);
-        SumE += GaussianEnergy(Struct,QMMMOpts,p);
-        QMTime += (unsigned)time(0)-tstart;
-      }
-      if (PSI4)
-      {
-        int tstart = (unsigned)time(0);
-        SumE += PSI4Energy(Struct,QMMMOpts,p);
-        QMTime += (unsigned)time(0)-tstart;
-        //Delete annoying useless files
-        GlobalSys = system("rm -f psi.* timer.*");
-      }
-      if (NWChem)
-      {
-        int tstart = (unsigned)time(0);
-        SumE += NWChemEnergy(Struct,QMMMOpts,p);
-        QMTime += (unsigned)time(0)-tstart;
-      }
-      //Calculate MM energy
-      if (TINKER)
+      //Calculate all beads at the same time
+      vector<int> Beads; //List of all beads
+      for (int p=0;p<QMMMOpts.Nbeads;p++)
       {
-        int tstart = (unsigned)time(0);
-        SumE += TINKEREnergy(Struct,QMMMOpts,p);
-        MMTime += (unsigned)time(0)-tstart;
+        Beads.push_back(p);
       }
-      if (AMBER)
-      {
-        int tstart = (unsigned)time(0);
-        SumE += AMBEREnergy(Struct,QMMMOpts,p);
-        MMTime += (unsigned)time(0)-tstart;
-      }
-      if (LAMMPS)
+      LICHEMBeadEnergies(Struct,QMMMOpts,Beads,Eqm,Emm);
+    }
+    for (int p=0;p<QMMMOpts.Nbeads;p++)
+    {
+      if (QMMMOpts.StartPathChk)
       {
-        int tstart = (unsigned)time(0);
-        SumE += LAMMPSEnergy(Struct,QMMMOpts,p);
-        MMTime += (unsigned)time(0)-tstart;
+        //Each bead starts from the checkpoint of the previous bead
+        LICHEMBeadEnergy(Struct,QMMMOpts,p,Eqm[p],Emm[p]);
       }
+      SumE = Eqm[p]+Emm[p]; //Total energy
       if (p == 0)
       {
         //Save reactant energy
@@ -1323,20 +966,20 @@ int main(int argc, char* argv[])
         if (Gaussian and (QMMMOpts.Func != "SemiEmp"))
         {
           call.str("");
-          call << "cp LICHM_" << p << ".chk ";
-          call << "LICHM_" << (p+1) << ".chk";
-          call << " 2> LICHM_" << (p+1) << ".trash; ";
-          call << "rm -f LICHM_" << (p+1) << ".trash";
-          GlobalSys = system(call.str().c_str());
+          call << LICHEMJobDir(p) << "LICHM_" << p << ".chk";
+          string oldname = call.str(); //Checkpoint of the previous bead
+          call.str("");
+          call << LICHEMJobDir(p+1) << "LICHM_" << (p+1) << ".chk";
+          LICHEMCopyFile(oldname,call.str());
         }
         if (PSI4)
         {
           call.str("");
-          call << "cp LICHM_" << p << ".180 ";
-          call << "LICHM_" << (p+1) << ".180";
-          call << " 2> LICHM_" << (p+1) << ".trash; ";
-          call << "rm -f LICHM_" << (p+1) << ".trash";
-          GlobalSys = system(call.str().c_str());
+          call << LICHEMJobDir(p) << "LICHM_" << p << ".180";
+          string oldname = call.str(); //Checkpoint of the previous bead
+          call.str("");
+          call << LICHEMJobDir(p+1) << "LICHM_" << (p+1) << ".180";
+          LICHEMCopyFile(oldname,call.str());
         }
       }
     }
@@ -1355,26 +998,38 @@ int main(int argc, char* argv[])
       //Copy structure
       OldStruct = Struct;
       //Run MM optimization
+      vector<int> Beads; //Beads which are optimized
       for (int p=PathStart;p<PathEnd;p++)
       {
+        Beads.push_back(p);
+      }
+      vector<int> Order = BeadJobs.Order(Beads); //Most expensive beads first
+      int Nopt = Order.size(); //Number of MM optimizations
+      #pragma omp parallel for schedule(dynamic) \
+              num_threads(BeadJobs.Slots(Nopt)) reduction(+:MMTime)
+      for (int j=0;j<Nopt;j++)
+      {
+        int p = Order[j]; //Bead ID
+        BeadJobs.Pin();
         if (TINKER)
         {
           int tstart = (unsigned)time(0);
-          SumE = TINKEROpt(Struct,QMMMOpts,p);
+          TINKEROpt(Struct,QMMMOpts,p);
           MMTime += (unsigned)time(0)-tstart;
         }
         if (AMBER)
         {
           int tstart = (unsigned)time(0);
-          SumE = AMBEROpt(Struct,QMMMOpts,p);
+          AMBEROpt(Struct,QMMMOpts,p);
           MMTime += (unsigned)time(0)-tstart;
         }
         if (LAMMPS)
         {
           int tstart = (unsigned)time(0);
-          SumE = LAMMPSOpt(Struct,QMMMOpts,p);
+          LAMMPSOpt(Struct,QMMMOpts,p);
           MMTime += (unsigned)time(0)-tstart;
         }
+        BeadJobs.Unpin();
       }
       if (QMMM)
       {
@@ -1436,48 +1091,8 @@ int main(int argc, char* argv[])
       cout << '\n';
       cout.flush(); //Print progress
       //Calculate QMMM frequencies
-      QMMMHess.setZero(); //Reset Hessian
       QMMMFreqs.setZero(); //Reset frequencies
-      //Calculate QM Hessian
-      if (Gaussian)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += GaussianHessian(Struct,QMMMOpts,QMMMOpts.TSBead);
-        QMTime += (unsigned)time(0)-tstart;
-      }
-      if (PSI4)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += PSI4Hessian(Struct,QMMMOpts,QMMMOpts.TSBead);
-        QMTime += (unsigned)time(0)-tstart;
-        //Delete annoying useless files
-        GlobalSys = system("rm -f psi.* timer.*");
-      }
-      if (NWChem)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += NWChemHessian(Struct,QMMMOpts,QMMMOpts.TSBead);
-        QMTime += (unsigned)time(0)-tstart;
-      }
-      //Calculate MM Hessian
-      if (TINKER)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += TINKERHessian(Struct,QMMMOpts,QMMMOpts.TSBead);
-        MMTime += (unsigned)time(0)-tstart;
-      }
-      if (AMBER)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += AMBERHessian(Struct,QMMMOpts,QMMMOpts.TSBead);
-        MMTime += (unsigned)time(0)-tstart;
-      }
-      if (LAMMPS)
-      {
-        int tstart = (unsigned)time(0);
-        QMMMHess += LAMMPSHessian(Struct,QMMMOpts,QMMMOpts.TSBead);
-        MMTime += (unsigned)time(0)-tstart;
-      }
+      QMMMHess = LICHEMBeadHessian(Struct,QMMMOpts,QMMMOpts.TSBead);
       //Calculate frequencies
       QMMMFreqs = LICHEMFreq(Struct,QMMMHess,QMMMOpts,QMMMOpts.TSBead,remct);
       //Print the frequencies
@@ -1526,46 +1141,8 @@ int main(int argc, char* argv[])
     cout.flush(); //Print progress
     //Calculate initial energy
     SumE = 0; //Clear old energies
-    //Calculate QM energy
-    if (Gaussian)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += GaussianEnergy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-    }
-    if (PSI4)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += PSI4Energy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-      //Delete annoying useless files
-      GlobalSys = system("rm -f psi.* timer.*");
-    }
-    if (NWChem)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += NWChemEnergy(Struct,QMMMOpts,0);
-      QMTime += (unsigned)time(0)-tstart;
-    }
-    //Calculate MM energy
-    if (TINKER)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += TINKEREnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
-    if (AMBER)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += AMBEREnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
-    if (LAMMPS)
-    {
-      int tstart = (unsigned)time(0);
-      SumE += LAMMPSEnergy(Struct,QMMMOpts,0);
-      MMTime += (unsigned)time(0)-tstart;
-    }
+    //Calculate QMMM energy
+    SumE += LICHEMBeadEnergy(Struct,QMMMOpts,0);
     cout << " | Opt. step: 0";
     cout << " | Energy: ";
     cout << LICHEMFormFloat(SumE,16);
@@ -1610,7 +1187,7 @@ int main(int argc, char* argv[])
 
   //Clean up
   xyzfile.close();
-  outfile.close();
+  CloseTraj(outfile); //Saves the frame index for binary trajectories
   regionfile.close();
   connectfile.close();
   if (Gaussian)
@@ -1618,23 +1195,24 @@ int main(int argc, char* argv[])
     //Clear any remaining Gaussian files
     stringstream call; //Stream for system calls and reading/writing files
     call.str("");
-    call << "rm -f Gau-*"; //Produced if there is a crash
-    GlobalSys = system(call.str().c_str());
+    call << "Gau-*"; //Produced if there is a crash
+    LICHEMRemoveFiles(call.str());
   }
   if (PSI4)
   {
     //Clear any remaining PSI4 files
     stringstream call; //Stream for system calls and reading/writing files
     call.str("");
-    call << "rm -f psi*";
-    GlobalSys = system(call.str().c_str());
+    call << "psi*";
+    LICHEMRemoveFiles(call.str());
   }
+  //Save restart files and delete the scratch directories
+  LICHEMCloseScratch();
   if (SinglePoint or FreqCalc)
   {
     //Clear worthless output xyz file
     stringstream call; //Stream for system calls and reading/writing files
     call.str("");
-    call << "rm -f ";
     for (int i=0;i<argc;i++)
     {
       //Find filename
@@ -1644,7 +1222,7 @@ int main(int argc, char* argv[])
         call << argv[i+1];
       }
     }
-    GlobalSys = system(call.str().c_str());
+    LICHEMRemoveFiles(call.str());
   }
   //End of section
 
@@ -1652,13 +1230,13 @@ int main(int argc, char* argv[])
   EndTime = (unsigned)time(0); //Time the program completes
   double TotalHours = (double(EndTime)-double(StartTime));
   double TotalQM = double(QMTime);
-  if (PIMCSim and (QMMMOpts.Nbeads > 1))
+  if (PIMCSim and ((QMMMOpts.Nbeads > 1) or (QMMMOpts.Nchains > 1)))
   {
     //Average over the number of running simulations
     TotalQM /= Nthreads;
   }
   double TotalMM = double(MMTime);
-  if (PIMCSim and (QMMMOpts.Nbeads > 1))
+  if (PIMCSim and ((QMMMOpts.Nbeads > 1) or (QMMMOpts.Nchains > 1)))
   {
     //Average over the number of running simulations
     TotalMM /= Nthreads;
@@ -1682,6 +1260,58 @@ int main(int argc, char* argv[])
   cout << "  Wall time for LICHEM:                ";
   cout << LICHEMFormFloat(OtherTime,6) << " hours";
   cout << '\n';
+  if (Nlaunches > 0)
+  {
+    //Print external program statistics
+    cout << "  External programs launched:          ";
+    cout << Nlaunches;
+    cout << '\n';
+    cout << "  Average wall time per launch:        ";
+    cout << LICHEMFormFloat(LaunchTime/Nlaunches,6) << " seconds";
+    cout << '\n';
+    cout << "  Launches with errors:                ";
+    cout << LaunchFails;
+    cout << '\n';
+  }
+  if (Nparses > 0)
+  {
+    //Print QM output parser statistics
+    cout << "  QM output files read:                ";
+    cout << Nparses;
+    cout << '\n';
+    cout << "  Average wall time per QM output:     ";
+    cout << LICHEMFormFloat(ParseTime/Nparses,6) << " seconds";
+    cout << '\n';
+  }
+  if ((SavedResults.Hits()+SavedResults.Misses()) > 0)
+  {
+    //Print saved result statistics
+    cout << "  Results reused from memory:          ";
+    cout << SavedResults.Hits();
+    cout << '\n';
+    cout << "  Results calculated:                  ";
+    cout << SavedResults.Misses();
+    cout << '\n';
+  }
+  if (QMStore.Active())
+  {
+    //Print saved QM result statistics
+    cout << "  QM results read from the disk:       ";
+    cout << QMStore.Hits();
+    cout << '\n';
+    cout << "  QM results not found on the disk:    ";
+    cout << QMStore.Misses();
+    cout << '\n';
+    if (QMStore.Checks() > 0)
+    {
+      cout << "  Saved QM results recalculated:       ";
+      cout << QMStore.Checks();
+      cout << '\n';
+      cout << "  Saved QM results which changed:      ";
+      cout << QMStore.Mismatches();
+      cout << '\n';
+    }
+  }
   cout << "####################################################";
   cout << '\n';
   cout.flush();
@@ -1696,7 +1326,9 @@ int main(int argc, char* argv[])
     string quote; //Random quote
     vector<string> Quotes; //Stores all possible quotes
     FetchQuotes(Quotes); //Fetch list of quotes
-    randnum = rand() % 1000; //Randomly pick 1 of 1000 quotes
+    RandomStream QuoteRand; //Random numbers for the quote
+    QuoteRand.Seed((uint64_t)time(0),0,RandOutput,0);
+    int randnum = QuoteRand.Integer(1000); //Randomly pick 1 of 1000 quotes
     cout << Quotes[randnum]; //Print quote
     cout << '\n';
   }
@@ -13,6 +13,42 @@
 
 */
 
+//FloatText class function definitions
+FloatText::FloatText()
+{
+  //Constructor
+  Nchars = 0;
+  return;
+};
+
+FloatText::~FloatText()
+{
+  //Generic destructor
+  return;
+};
+
+string FloatText::str()
+{
+  //Function to copy the text to a string
+  return string(Text,Nchars);
+};
+
+ostream& operator<<(ostream& os, const FloatText& txt)
+{
+  //Function to write the text to a stream
+  if (os.width() > 0)
+  {
+    //Use the normal string output to respect setw()
+    os << string(txt.Text,txt.Nchars);
+  }
+  else
+  {
+    //Copy the characters
+    os.write(txt.Text,txt.Nchars);
+  }
+  return os;
+};
+
 //Coord class function definitions
 Coord::Coord()
 {
@@ -247,736 +283,2083 @@ QMMMElec::~QMMMElec()
   return;
 };
 
-//QMMMSettings class function definitions
-QMMMSettings::QMMMSettings()
+//MCUndoLog class function definitions
+MCUndoLog::MCUndoLog()
 {
-  //QM wrapper settings
-  Func = "N/A";
-  Basis = "N/A";
-  RAM = 256;
-  MemMB = 1;
-  Charge = 0;
-  Spin = 1;
-  BackDir = "Old_files";
-  //QMMM long-range electrostatics settings
-  UseLREC = 0;
-  LRECCut = 1000.0; //Effectively infinite
-  LRECPow = 3;
-  //MM wrapper settings
-  UseMMCut = 0;
-  MMOptCut = 1000.0; //Effectively infinite
-  UseEwald = 0;
-  UseImpSolv = 0;
-  SolvModel = "N/A";
-  //MC, MD, and RP settings
-  Ensemble = "N/A";
-  Temp = 300.0;
-  Beta = 1/(300.0*k);
-  Press = 0.0;
-  Neq = 0;
-  Nsteps = 0;
-  Nbeads = 1; //Key for printing
-  accratio = 0.5;
-  Nprint = 5000;
-  dt = 1.0;
-  tautemp = 1000.0;
-  //Optimization settings
-  MaxOptSteps = 200;
-  MMOptTol = 1e-2;
-  QMOptTol = 5e-4;
-  StepScale = 1.0;
-  MaxStep = 0.1;
-  //Additional RP settings
-  Kspring = 1.0;
-  TSBead = 0;
-  Climb = 0;
-  FrznEnds = 0;
-  NEBFreq = 0;
-  PrintNormModes = 0;
-  StartPathChk = 1; //Speeds up reaction pathways
-  //Temporary energy storage
-  Eold = 0.0;
-  Ereact = 0.0;
-  Eprod = 0.0;
-  Ets = 0.0;
+  //Constructor
+  AllSaved = 0;
+  LxOld = Lx;
+  LyOld = Ly;
+  LzOld = Lz;
   return;
 };
 
-QMMMSettings::~QMMMSettings()
+MCUndoLog::~MCUndoLog()
 {
   //Generic destructor
   return;
 };
 
-//PeriodicTable class function definitions
-PeriodicTable::PeriodicTable()
+void MCUndoLog::Clear()
 {
-  //Set atomic properties
-  //Hydrogen, 1
-  Typs.push_back("H");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.00784); //NIST, 2015
-  //Helium, 2
-  Typs.push_back("He");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(4.002602); //NIST, 2015
-  //Lithium, 3
-  Typs.push_back("Li");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(6.938); //NIST, 2015
-  //Berylium, 4
-  Typs.push_back("Be");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(9.0121831); //NIST, 2015
-  //Boron, 5
-  Typs.push_back("B");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(10.806); //NIST, 2015
-  //Carbon, 6
-  Typs.push_back("C");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(12.0096); //NIST, 2015
-  //Nitrogen, 7
-  Typs.push_back("N");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(14.00643); //NIST, 2015
-  //Oxygen, 8
-  Typs.push_back("O");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(15.99903); //NIST, 2015
-  //Fluorine, 9
-  Typs.push_back("F");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(18.998403163); //NIST, 2015
-  //Neon, 10
-  Typs.push_back("Ne");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(20.1797); //NIST, 2015
-  //Sodium, 11
-  Typs.push_back("Na");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(22.98976928); //NIST, 2015
-  //Magnesium, 12
-  Typs.push_back("Mg");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(24.304); //NIST, 2015
-  //Aluminum, 13
-  Typs.push_back("Al");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(26.9815385); //NIST, 2015
-  //Silicon, 14
-  Typs.push_back("Si");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(28.084); //NIST, 2015
-  //Phosphorus, 15
-  Typs.push_back("P");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(30.973761998); //NIST, 2015
-  //Sulfur, 16
-  Typs.push_back("S");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(32.059); //NIST, 2015
-  //Chlorine, 17
-  Typs.push_back("Cl");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(35.446); //NIST, 2015
-  //Argon, 18
-  Typs.push_back("Ar");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(39.948); //NIST, 2015
-  //Potassium, 19
-  Typs.push_back("K");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(39.0983); //NIST, 2015
-  //Calcium, 20
-  Typs.push_back("Ca");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(40.078); //NIST, 2015
-  //Scandium, 21
-  Typs.push_back("Sc");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(44.955908); //NIST, 2015
-  //Titanium, 22
-  Typs.push_back("Ti");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(47.867); //NIST, 2015
-  //Vanadium, 23
-  Typs.push_back("V");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(50.9415); //NIST, 2015
-  //Chromium, 24
-  Typs.push_back("Cr");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(51.9961); //NIST, 2015
-  //Manganese, 25
-  Typs.push_back("Mn");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(54.938044); //NIST, 2015
-  //Iron, 26
-  Typs.push_back("Fe");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(55.845); //NIST, 2015
-  //Cobalt, 27
-  Typs.push_back("Co");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(58.933194); //NIST, 2015
-  //Nickel, 28
-  Typs.push_back("Ni");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(58.6934); //NIST, 2015
-  //Copper, 29
-  Typs.push_back("Cu");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(63.546); //NIST, 2015
-  //Zinc, 30
-  Typs.push_back("Zn");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(65.38); //NIST, 2015
-  //Gallium, 31
-  Typs.push_back("Ga");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(69.723); //NIST, 2015
-  //Germanium, 32
-  Typs.push_back("Ge");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(72.630); //NIST, 2015
-  //Arsenic, 33
-  Typs.push_back("As");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(74.921595); //NIST, 2015
-  //Selenium, 34
-  Typs.push_back("Se");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(78.971); //NIST, 2015
-  //Bromine, 35
-  Typs.push_back("Br");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(79.901); //NIST, 2015
-  //Krypton, 36
-  Typs.push_back("Kr");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(83.798); //NIST, 2015
-  //Rubidium, 37
-  Typs.push_back("Rb");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(85.4678); //NIST, 2015
-  //Strontium, 38
-  Typs.push_back("Sr");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(87.62); //NIST, 2015
-  //Yttrium, 39
-  Typs.push_back("Y");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(88.90584); //NIST, 2015
-  //Zirconium, 40
-  Typs.push_back("Zr");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(91.224); //NIST, 2015
-  //Niobium, 41
-  Typs.push_back("Nb");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(92.90637); //NIST, 2015
-  //Molybdenum, 42
-  Typs.push_back("Mo");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(95.95); //NIST, 2015
-  //Technetium, 43
-  Typs.push_back("Tc");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(98); //NIST, 2015
-  //Ruthenium, 44
-  Typs.push_back("Ru");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(101.07); //NIST, 2015
-  //Rhodium, 45
-  Typs.push_back("Rh");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(102.90550); //NIST, 2015
-  //Palladium, 46
-  Typs.push_back("Pd");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(106.42); //NIST, 2015
-  //Silver, 47
-  Typs.push_back("Ag");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(107.8682); //NIST, 2015
-  //Cadmium, 48
-  Typs.push_back("Cd");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(112.414); //NIST, 2015
-  //Indium, 49
-  Typs.push_back("In");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(114.818); //NIST, 2015
-  //Tin, 50
-  Typs.push_back("Sn");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(118.710); //NIST, 2015
-  //Antimony, 51
-  Typs.push_back("Sb");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(121.760); //NIST, 2015
-  //Tellurium, 52
-  Typs.push_back("Te");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(127.60); //NIST, 2015
-  //Iodine, 53
-  Typs.push_back("I");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(126.90447); //NIST, 2015
-  //Xenon, 54
-  Typs.push_back("Xe");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(131.293); //NIST, 2015
-  //Caesium, 55
-  Typs.push_back("Cs");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(132.90545196); //NIST, 2015
-  //Barium, 56
-  Typs.push_back("Ba");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(137.327); //NIST, 2015
-  //Lanthanum, 57
-  Typs.push_back("La");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(138.90547); //NIST, 2015
-  //Cerium, 58
-  Typs.push_back("Ce");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(140.116); //NIST, 2015
-  //Praseodymium, 59
-  Typs.push_back("Pr");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(140.90766); //NIST, 2015
-  //Neodymium, 60
-  Typs.push_back("Nd");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(144.242); //NIST, 2015
-  //Promethium, 61
-  Typs.push_back("Pm");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(145); //NIST, 2015
-  //Samarium, 62
-  Typs.push_back("Sm");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(150.36); //NIST, 2015
-  //Europium, 63
-  Typs.push_back("Eu");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(151.964); //NIST, 2015
-  //Gadolinium, 64
-  Typs.push_back("Gd");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(157.25); //NIST, 2015
-  //Terbium, 65
-  Typs.push_back("Tb");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(158.92535); //NIST, 2015
-  //Dysprosium, 66
-  Typs.push_back("Dy");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(162.500); //NIST, 2015
-  //Holmium, 67
-  Typs.push_back("Ho");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(164.93033); //NIST, 2015
-  //Erbium, 68
-  Typs.push_back("Er");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(167.259); //NIST, 2015
-  //Thulium, 69
-  Typs.push_back("Tm");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(168.93422); //NIST, 2015
-  //Ytterbium, 70
-  Typs.push_back("Yb");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(173.054); //NIST, 2015
-  //Lutetium, 71
-  Typs.push_back("Lu");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(174.9668); //NIST, 2015
-  //Hafnium, 72
-  Typs.push_back("Hf");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(178.49); //NIST, 2015
-  //Tantalum, 73
-  Typs.push_back("Ta");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(180.94788); //NIST, 2015
-  //Tungsten, 74
-  Typs.push_back("W");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(183.84); //NIST, 2015
-  //Rhenium, 75
-  Typs.push_back("Re");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(186.207); //NIST, 2015
-  //Osmium, 76
-  Typs.push_back("Os");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(190.23); //NIST, 2015
-  //Iridium, 77
-  Typs.push_back("Ir");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(192.217); //NIST, 2015
-  //Platinum, 78
-  Typs.push_back("Pt");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(195.084); //NIST, 2015
-  //Gold, 79
-  Typs.push_back("Au");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(196.966569); //NIST, 2015
-  //Mercury, 80
-  Typs.push_back("Hg");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(200.592); //NIST, 2015
-  //Thallium, 81
-  Typs.push_back("Tl");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(204.382); //NIST, 2015
-  //Lead, 82
-  Typs.push_back("Pb");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(207.2); //NIST, 2015
-  //Bismuth, 83
-  Typs.push_back("Bi");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(208.98040); //NIST, 2015
-  //Polonium, 84
-  Typs.push_back("Po");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(209); //NIST, 2015
-  //Astatine, 85
-  Typs.push_back("At");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(210); //NIST, 2015
-  //Radon, 86
-  Typs.push_back("Rn");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(222); //NIST, 2015
-  //Francium, 87
-  Typs.push_back("Fr");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(223); //NIST, 2015
-  //Radium, 88
-  Typs.push_back("Ra");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(226); //NIST, 2015
-  //Actinium, 89
-  Typs.push_back("Ac");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(227); //NIST, 2015
-  //Thorium, 90
-  Typs.push_back("Th");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(232.0377); //NIST, 2015
-  //Protactium, 91
-  Typs.push_back("Pa");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(231.03588); //NIST, 2015
-  //Uranium, 92
-  Typs.push_back("U");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(238.02891); //NIST, 2015
-  //Neptunium, 93
-  Typs.push_back("Np");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(237); //NIST, 2015
-  //Plutonium, 94
-  Typs.push_back("Pu");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(244); //NIST, 2015
-  //Americium, 95
-  Typs.push_back("Am");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Curium, 96
-  Typs.push_back("Cm");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Berkelium, 97
-  Typs.push_back("Bk");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Californium, 98
-  Typs.push_back("Cf");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Einsteinium, 99
-  Typs.push_back("Es");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Fermium, 100
-  Typs.push_back("Fm");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Mendelevium, 101
-  Typs.push_back("Md");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Nobelium, 102
-  Typs.push_back("No");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Lawrencium, 103
-  Typs.push_back("Lr");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Rutherfordium, 104
-  Typs.push_back("Rf");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Dubnium, 105
-  Typs.push_back("Db");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Seaborgium, 106
-  Typs.push_back("Sg");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Bohrium, 107
-  Typs.push_back("Bh");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Hasium, 108
-  Typs.push_back("Hs");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Meitnerium, 109
-  Typs.push_back("Mt");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Darmstadtium, 110
-  Typs.push_back("Ds");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Roentgenium, 111
-  Typs.push_back("Rg");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Copernicium, 112
-  Typs.push_back("Cn");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Num. 113
-  Typs.push_back("");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Flerovium, 114
-  Typs.push_back("Fl");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Num. 115
-  Typs.push_back("");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Livermorium, 116
-  Typs.push_back("Lv");
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Num. 117
-  Typs.push_back(""); //Unnamed
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
-  //Num. 118
-  Typs.push_back(""); //Unnamed
-  CovRadii.push_back(1.0); //Default value
-  vdWRadii.push_back(1.0); //Default value
-  AtMasses.push_back(1.0); //Default value
+  //Remove old entries and save the current box size
+  Atoms.clear();
+  Beads.clear();
+  OldPos.clear();
+  AllSaved = 0;
+  LxOld = Lx;
+  LyOld = Ly;
+  LzOld = Lz;
   return;
 };
 
-PeriodicTable::~PeriodicTable()
+void MCUndoLog::SaveBead(vector<QMMMAtom>& Struct, int i, int j)
+{
+  //Record the position of bead j of atom i before it is moved
+  Atoms.push_back(i);
+  Beads.push_back(j);
+  OldPos.push_back(Struct[i].P[j]);
+  return;
+};
+
+void MCUndoLog::SaveAtom(vector<QMMMAtom>& Struct, int i, int Nbeads)
+{
+  //Record the positions of all beads of atom i
+  for (int j=0;j<Nbeads;j++)
+  {
+    SaveBead(Struct,i,j);
+  }
+  return;
+};
+
+void MCUndoLog::SaveAll(vector<QMMMAtom>& Struct, int Nbeads)
+{
+  //Record all positions before a collective move
+  AllPos.resize(Natoms);
+  for (int i=0;i<Natoms;i++)
+  {
+    AllPos[i].assign(Struct[i].P.begin(),Struct[i].P.begin()+Nbeads);
+  }
+  AllSaved = 1;
+  return;
+};
+
+void MCUndoLog::Undo(vector<QMMMAtom>& Struct)
+{
+  //Revert the structure and box to the state before the move
+  if (AllSaved)
+  {
+    //Undo the collective move
+    for (int i=0;i<Natoms;i++)
+    {
+      for (unsigned int j=0;j<AllPos[i].size();j++)
+      {
+        Struct[i].P[j] = AllPos[i][j];
+      }
+    }
+  }
+  for (int k=(OldPos.size()-1);k>=0;k--)
+  {
+    //Undo single bead moves in reverse order
+    Struct[Atoms[k]].P[Beads[k]] = OldPos[k];
+  }
+  //Revert to old box sizes
+  Lx = LxOld;
+  Ly = LyOld;
+  Lz = LzOld;
+  //Start a new log
+  Clear();
+  return;
+};
+
+void MCUndoLog::FlagBeads(vector<bool>& Dirty, int Nbeads)
+{
+  //Mark the beads which need new energies after the move
+  Dirty.assign(Nbeads,0);
+  if (AllSaved or (Lx != LxOld) or (Ly != LyOld) or (Lz != LzOld))
+  {
+    //Collective moves change every bead
+    Dirty.assign(Nbeads,1);
+  }
+  for (unsigned int k=0;k<Beads.size();k++)
+  {
+    Dirty[Beads[k]] = 1;
+  }
+  return;
+};
+
+bool MCUndoLog::MovedAtoms(vector<int>& Moved)
+{
+  //List the atoms displaced by single bead moves and return 1 if all
+  //atoms were moved
+  Moved.clear();
+  for (unsigned int k=0;k<Atoms.size();k++)
+  {
+    //Avoid duplicates, the log only holds a few atoms
+    bool NewAtom = 1;
+    for (unsigned int l=0;l<Moved.size();l++)
+    {
+      if (Moved[l] == Atoms[k])
+      {
+        NewAtom = 0;
+      }
+    }
+    if (NewAtom)
+    {
+      Moved.push_back(Atoms[k]);
+    }
+  }
+  if (AllSaved or (Lx != LxOld) or (Ly != LyOld) or (Lz != LzOld))
+  {
+    //Collective moves change every atom
+    return 1;
+  }
+  return 0;
+};
+
+//BinTraj class function definitions
+BinTraj::BinTraj()
+{
+  //Constructor
+  Natoms = 0;
+  Nbeads = 0;
+  Nbytes = 8;
+  Quant = 0;
+  Step = 0;
+  Energy = 0;
+  Lx = 0;
+  Ly = 0;
+  Lz = 0;
+  return;
+};
+
+BinTraj::~BinTraj()
 {
   //Generic destructor
   return;
 };
 
-string PeriodicTable::Typing(int Z)
+bool BinTraj::Open(string filename)
 {
-  //Function to convert nuclear charges to atom types
-  return Typs[Z-1];
+  //Function to read the header and the frame index of a binary trajectory
+  char Magic[9]; //File type identifier
+  int Version; //File format version
+  Close(); //Remove data from old files
+  TrajFile.open(filename.c_str(),ios_base::in|ios_base::binary);
+  if (!TrajFile.good())
+  {
+    //Missing file
+    return 0;
+  }
+  //Read the file header
+  Magic[8] = '\0';
+  TrajFile.read(Magic,8);
+  if ((!TrajFile.good()) or (string(Magic) != "LICHEMBT"))
+  {
+    //Not a binary trajectory
+    TrajFile.close();
+    return 0;
+  }
+  TrajFile.read((char*)&Version,sizeof(int));
+  TrajFile.read((char*)&Natoms,sizeof(int));
+  TrajFile.read((char*)&Nbeads,sizeof(int));
+  TrajFile.read((char*)&Nbytes,sizeof(int));
+  TrajFile.read((char*)&Quant,sizeof(double));
+  for (int i=0;i<Natoms;i++)
+  {
+    //Atom types are saved as four characters
+    char Typ[5];
+    Typ[4] = '\0';
+    TrajFile.read(Typ,4);
+    Typs.push_back(string(Typ));
+  }
+  if ((!TrajFile.good()) or (Version != 1))
+  {
+    //Damaged header or unknown format
+    TrajFile.close();
+    return 0;
+  }
+  //Locate the frames
+  if (!ReadIndex())
+  {
+    //The index is missing if the simulation did not finish
+    ScanFrames();
+  }
+  return 1;
 };
 
-int PeriodicTable::RevTyping(string AtName)
+bool BinTraj::ReadIndex()
 {
-  //Function to convert atom types to nuclear charges
-  int Z = 0;
-  #pragma omp parallel for schedule(dynamic) num_threads(Ncpus)
-  for (unsigned int i=0;i<Typs.size();i++)
+  //Function to read the frame index at the end of the file
+  char Magic[9]; //Index identifier
+  long long IndexPos; //Offset of the index
+  long long Nframes; //Number of frames in the index
+  Magic[8] = '\0';
+  TrajFile.clear();
+  TrajFile.seekg(0,ios_base::end);
+  long long FileSize = (long long)TrajFile.tellg();
+  if (FileSize < 16)
+  {
+    return 0;
+  }
+  TrajFile.seekg(FileSize-16,ios_base::beg);
+  TrajFile.read((char*)&IndexPos,sizeof(long long));
+  TrajFile.read(Magic,8);
+  if ((!TrajFile.good()) or (string(Magic) != "LICHEMIX"))
+  {
+    //No index
+    TrajFile.clear();
+    return 0;
+  }
+  //Read the offsets
+  char Tag[5];
+  Tag[4] = '\0';
+  TrajFile.seekg(IndexPos,ios_base::beg);
+  TrajFile.read(Tag,4);
+  TrajFile.read((char*)&Nframes,sizeof(long long));
+  if ((!TrajFile.good()) or (string(Tag) != "INDX") or (Nframes < 0))
   {
-    if (AtName == Typs[i])
+    //Damaged index
+    TrajFile.clear();
+    return 0;
+  }
+  Frames.resize(Nframes);
+  if (Nframes > 0)
+  {
+    TrajFile.read((char*)&Frames[0],Nframes*sizeof(long long));
+  }
+  if (!TrajFile.good())
+  {
+    //Damaged index
+    TrajFile.clear();
+    Frames.clear();
+    return 0;
+  }
+  return 1;
+};
+
+void BinTraj::ScanFrames()
+{
+  //Function to find the frames by hopping between chunk headers
+  //NB: Only the headers are read, so the coordinates are skipped
+  TrajFile.clear();
+  TrajFile.seekg(0,ios_base::end);
+  long long FileSize = (long long)TrajFile.tellg();
+  long long Pos = 8+4*sizeof(int)+sizeof(double)+4*Natoms; //After header
+  Frames.clear();
+  while ((Pos+12) <= FileSize)
+  {
+    char Tag[5];
+    long long ChunkSize;
+    Tag[4] = '\0';
+    TrajFile.seekg(Pos,ios_base::beg);
+    TrajFile.read(Tag,4);
+    TrajFile.read((char*)&ChunkSize,sizeof(long long));
+    if ((!TrajFile.good()) or (string(Tag) != "FRAM") or
+       ((Pos+12+ChunkSize) > FileSize))
     {
-      Z = i+1;
+      //Stop at the index or at an incomplete frame
+      break;
     }
+    Frames.push_back(Pos);
+    Pos += 12+ChunkSize;
   }
-  return Z;
+  TrajFile.clear();
+  return;
 };
 
-double PeriodicTable::GetCovRadius(string AtName)
+bool BinTraj::ReadFrame(int FrameID)
 {
-  //Function to find the covalent radius of an atom
-  double radius = 0;
-  #pragma omp parallel for schedule(dynamic) num_threads(Ncpus)
-  for (unsigned int i=0;i<Typs.size();i++)
+  //Function to read a single frame
+  if ((FrameID < 0) or (FrameID >= (int)Frames.size()))
+  {
+    //The frame does not exist
+    return 0;
+  }
+  //Read the frame
+  long long ChunkSize;
+  TrajFile.clear();
+  TrajFile.seekg(Frames[FrameID]+4,ios_base::beg);
+  TrajFile.read((char*)&ChunkSize,sizeof(long long));
+  long long MinSize = sizeof(long long)+4*sizeof(double); //Frame header
+  if (Quant <= 0)
+  {
+    //Uncompressed coordinates have a fixed size
+    MinSize += 3*((long long)Natoms)*Nbeads*Nbytes;
+  }
+  if ((!TrajFile.good()) or (ChunkSize < MinSize))
   {
-    if (AtName == Typs[i])
+    //Damaged frame
+    TrajFile.clear();
+    return 0;
+  }
+  string Chunk(ChunkSize,' ');
+  TrajFile.read(&Chunk[0],ChunkSize);
+  if (!TrajFile.good())
+  {
+    //Damaged frame
+    TrajFile.clear();
+    return 0;
+  }
+  //Read the frame header
+  const char* Data = Chunk.c_str();
+  memcpy(&Step,Data,sizeof(long long));
+  Data += sizeof(long long);
+  memcpy(&Energy,Data,sizeof(double));
+  Data += sizeof(double);
+  memcpy(&Lx,Data,sizeof(double));
+  Data += sizeof(double);
+  memcpy(&Ly,Data,sizeof(double));
+  Data += sizeof(double);
+  memcpy(&Lz,Data,sizeof(double));
+  Data += sizeof(double);
+  //Read the coordinates
+  P.resize(Natoms*Nbeads);
+  if (Quant > 0)
+  {
+    //Decode the compressed coordinates
+    const char* DataEnd = Chunk.c_str()+Chunk.size();
+    for (int i=0;i<Natoms;i++)
+    {
+      long long Old[3] = {0,0,0}; //Previous bead on the grid
+      for (int j=0;j<Nbeads;j++)
+      {
+        for (int k=0;k<3;k++)
+        {
+          //Read a variable length integer
+          unsigned long long Val = 0;
+          int Shift = 0;
+          while (Data < DataEnd)
+          {
+            unsigned char Byte = (unsigned char)(*Data);
+            Data += 1;
+            Val |= ((unsigned long long)(Byte & 127)) << Shift;
+            Shift += 7;
+            if ((Byte & 128) == 0)
+            {
+              break;
+            }
+          }
+          //Undo the zigzag sign encoding and the difference between beads
+          long long Diff = (long long)(Val >> 1)^(-(long long)(Val & 1));
+          Old[k] += Diff;
+        }
+        P[i*Nbeads+j].x = Old[0]*Quant;
+        P[i*Nbeads+j].y = Old[1]*Quant;
+        P[i*Nbeads+j].z = Old[2]*Quant;
+      }
+    }
+  }
+  else if (Nbytes == 4)
+  {
+    //Single precision coordinates
+    for (int i=0;i<(Natoms*Nbeads);i++)
     {
-      //Save value
-      radius = CovRadii[i];
+      float Pos[3];
+      memcpy(Pos,Data,3*sizeof(float));
+      Data += 3*sizeof(float);
+      P[i].x = Pos[0];
+      P[i].y = Pos[1];
+      P[i].z = Pos[2];
     }
   }
-  return radius;
+  else
+  {
+    //Double precision coordinates
+    for (int i=0;i<(Natoms*Nbeads);i++)
+    {
+      double Pos[3];
+      memcpy(Pos,Data,3*sizeof(double));
+      Data += 3*sizeof(double);
+      P[i].x = Pos[0];
+      P[i].y = Pos[1];
+      P[i].z = Pos[2];
+    }
+  }
+  return 1;
 };
 
-double PeriodicTable::GetRadius(string AtName)
+void BinTraj::Close()
 {
-  //Function to find the vdW radius of an atom
-  double radius = 0;
-  #pragma omp parallel for schedule(dynamic) num_threads(Ncpus)
-  for (unsigned int i=0;i<Typs.size();i++)
+  //Function to close the file and remove the data
+  if (TrajFile.is_open())
+  {
+    TrajFile.close();
+  }
+  TrajFile.clear();
+  Typs.clear();
+  Frames.clear();
+  P.clear();
+  Natoms = 0;
+  Nbeads = 0;
+  return;
+};
+
+//QMLogFile class function definitions
+QMLogFile::QMLogFile()
+{
+  //Constructor
+  Text = NULL;
+  Size = 0;
+  Pos = 0;
+  MapAddr = NULL;
+  Opened = 0;
+  return;
+};
+
+QMLogFile::~QMLogFile()
+{
+  //Destructor
+  Close();
+  return;
+};
+
+bool QMLogFile::Open(const string& FileName)
+{
+  //Function to map a file into memory
+  Close();
+  tstart = chrono::steady_clock::now();
+  int FileID = open(FileName.c_str(),O_RDONLY);
+  if (FileID < 0)
+  {
+    return 0;
+  }
+  struct stat buffer;
+  if ((fstat(FileID,&buffer) == 0) and (buffer.st_size > 0))
+  {
+    Size = buffer.st_size;
+    MapAddr = mmap(NULL,Size,PROT_READ,MAP_PRIVATE,FileID,0);
+    if (MapAddr != MAP_FAILED)
+    {
+      Text = (const char*)MapAddr;
+    }
+    else
+    {
+      //Read the whole file instead
+      MapAddr = NULL;
+      ifstream ifile(FileName.c_str(),ios_base::in|ios_base::binary);
+      Copy.assign(istreambuf_iterator<char>(ifile),
+                  istreambuf_iterator<char>());
+      Text = Copy.data();
+      Size = Copy.size();
+    }
+  }
+  close(FileID);
+  Pos = 0;
+  Opened = 1;
+  return 1;
+};
+
+void QMLogFile::Close()
+{
+  //Function to unmap the file and update the statistics
+  if (MapAddr != NULL)
   {
-    if (AtName == Typs[i])
+    munmap(MapAddr,Size);
+    MapAddr = NULL;
+  }
+  Copy.clear();
+  Text = NULL;
+  Size = 0;
+  Pos = 0;
+  Markers.clear();
+  LineStart.clear();
+  NextHit.clear();
+  Searched.clear();
+  if (Opened)
+  {
+    double WallTime = chrono::duration<double>(chrono::steady_clock::now()-
+                                               tstart).count();
+    #pragma omp critical(LICHEMParseStats)
     {
-      //Save value
-      radius = vdWRadii[i];
+      Nparses += 1;
+      ParseTime += WallTime;
     }
+    Opened = 0;
   }
-  return radius;
+  return;
 };
 
-double PeriodicTable::GetAtMass(string AtName)
+void QMLogFile::AddMarker(const string& Marker, bool AtStart)
 {
-  //Function to find the atomic mass of an atom
-  double mass = 0;
-  #pragma omp parallel for schedule(dynamic) num_threads(Ncpus)
-  for (unsigned int i=0;i<Typs.size();i++)
+  //Function to add a section marker
+  //NB: Markers must follow a space, and markers at the start of a line can
+  //only follow spaces
+  Markers.push_back(Marker);
+  LineStart.push_back(AtStart);
+  NextHit.push_back(0);
+  Searched.push_back(0);
+  return;
+};
+
+size_t QMLogFile::FindMarker(int Mark, size_t From)
+{
+  //Function to find the next position of a marker, returns Size if the
+  //marker is not found
+  const string& Marker = Markers[Mark]; //Shorter name
+  while ((Text != NULL) and (From < Size))
+  {
+    const char* Hit = (const char*)memmem(Text+From,Size-From,Marker.c_str(),
+                                          Marker.size());
+    if (Hit == NULL)
+    {
+      break;
+    }
+    size_t HitPos = Hit-Text;
+    bool Good = 1; //Flag for a marker at the start of a word
+    if (HitPos > 0)
+    {
+      Good = isspace((unsigned char)Text[HitPos-1]);
+    }
+    if (Good and LineStart[Mark])
+    {
+      //Only spaces can come before the marker
+      size_t i = HitPos;
+      while (Good and (i > 0) and (Text[i-1] != '\n'))
+      {
+        i -= 1;
+        Good = ((Text[i] == ' ') or (Text[i] == '\t') or (Text[i] == '\r'));
+      }
+    }
+    if (Good)
+    {
+      return HitPos;
+    }
+    From = HitPos+1;
+  }
+  return Size;
+};
+
+int QMLogFile::NextMarker()
+{
+  //Function to move past the next marker in the file
+  int Best = -1; //Closest marker
+  for (unsigned int i=0;i<Markers.size();i++)
+  {
+    if ((!Searched[i]) or (NextHit[i] < Pos))
+    {
+      //Update the position of the marker
+      NextHit[i] = FindMarker(i,Pos);
+      Searched[i] = 1;
+    }
+    if ((NextHit[i] < Size) and ((Best < 0) or (NextHit[i] < NextHit[Best])))
+    {
+      Best = i;
+    }
+  }
+  if (Best >= 0)
+  {
+    Pos = NextHit[Best]+Markers[Best].size();
+  }
+  else
+  {
+    Pos = Size;
+  }
+  return Best;
+};
+
+void QMLogFile::NextLine()
+{
+  //Function to move to the start of the next line
+  if (Pos < Size)
+  {
+    const char* End = (const char*)memchr(Text+Pos,'\n',Size-Pos);
+    if (End == NULL)
+    {
+      Pos = Size;
+    }
+    else
+    {
+      Pos = End-Text+1;
+    }
+  }
+  return;
+};
+
+void QMLogFile::SkipWords(int Nwords)
+{
+  //Function to move past words without leaving the current line
+  for (int i=0;i<Nwords;i++)
   {
-    if (AtName == Typs[i])
+    while ((Pos < Size) and ((Text[Pos] == ' ') or (Text[Pos] == '\t')))
+    {
+      Pos += 1;
+    }
+    while ((Pos < Size) and (!isspace((unsigned char)Text[Pos])))
     {
-      //Save value
-      mass = AtMasses[i];
+      Pos += 1;
     }
   }
-  return mass;
+  return;
 };
 
+bool QMLogFile::ReadDouble(double& Val)
+{
+  //Function to read the next word on the line as a number
+  //NB: The word is copied to a small buffer, so the file is never read
+  //past its end, and Fortran D exponents are changed to E
+  while ((Pos < Size) and ((Text[Pos] == ' ') or (Text[Pos] == '\t')))
+  {
+    Pos += 1;
+  }
+  char Word[64]; //Copy of the number
+  int Nchars = 0;
+  while ((Pos < Size) and (!isspace((unsigned char)Text[Pos])) and
+         (Nchars < 63))
+  {
+    Word[Nchars] = Text[Pos];
+    if ((Word[Nchars] == 'D') or (Word[Nchars] == 'd'))
+    {
+      Word[Nchars] = 'E';
+    }
+    Nchars += 1;
+    Pos += 1;
+  }
+  Word[Nchars] = '\0';
+  char* End; //End of the number
+  double Tmp = strtod(Word,&End);
+  if ((Nchars == 0) or (End == Word))
+  {
+    return 0;
+  }
+  Val = Tmp;
+  return 1;
+};
+
+bool QMLogFile::ReadArray(int Nvals, VectorXd& Vals)
+{
+  //Function to read numbers which can continue on the next lines
+  Vals.resize(Nvals);
+  for (int i=0;i<Nvals;i++)
+  {
+    //Skip line breaks
+    while ((Pos < Size) and isspace((unsigned char)Text[Pos]))
+    {
+      Pos += 1;
+    }
+    if (!ReadDouble(Vals(i)))
+    {
+      //Incomplete array
+      Vals.resize(0);
+      return 0;
+    }
+  }
+  return 1;
+};
+
+//MMPolResult class function definitions
+MMPolResult::MMPolResult()
+{
+  //Constructor
+  Saved = 0;
+  E = 0;
+  return;
+};
+
+MMPolResult::~MMPolResult()
+{
+  //Generic destructor
+  return;
+};
+
+VectorXd MMPolResult::GetInputs(vector<QMMMAtom>& Struct, int Bead)
+{
+  //Function to collect everything that changes the polarization result
+  int Nmpole = 0; //Number of QM, PB, and BA atoms
+  for (int i=0;i<Natoms;i++)
+  {
+    if (Struct[i].QMregion or Struct[i].PBregion or Struct[i].BAregion)
+    {
+      Nmpole += 1;
+    }
+  }
+  VectorXd Vals(3*Natoms+3+10*Nmpole);
+  int ct = 0; //Position in the array
+  for (int i=0;i<Natoms;i++)
+  {
+    Vals(ct) = Struct[i].P[Bead].x;
+    Vals(ct+1) = Struct[i].P[Bead].y;
+    Vals(ct+2) = Struct[i].P[Bead].z;
+    ct += 3;
+  }
+  Vals(ct) = Lx;
+  Vals(ct+1) = Ly;
+  Vals(ct+2) = Lz;
+  ct += 3;
+  for (int i=0;i<Natoms;i++)
+  {
+    //Multipoles written to the key file
+    if (Struct[i].QMregion or Struct[i].PBregion or Struct[i].BAregion)
+    {
+      Mpole& MP = Struct[i].MP[Bead]; //Shorter name
+      Vals(ct) = MP.q;
+      Vals(ct+1) = MP.Dx;
+      Vals(ct+2) = MP.Dy;
+      Vals(ct+3) = MP.Dz;
+      Vals(ct+4) = MP.Qxx;
+      Vals(ct+5) = MP.Qxy;
+      Vals(ct+6) = MP.Qxz;
+      Vals(ct+7) = MP.Qyy;
+      Vals(ct+8) = MP.Qyz;
+      Vals(ct+9) = MP.Qzz;
+      ct += 10;
+    }
+  }
+  return Vals;
+};
+
+bool MMPolResult::Match(vector<QMMMAtom>& Struct, int Bead)
+{
+  //Function to check if the results belong to the current structure
+  if (!Saved)
+  {
+    return 0;
+  }
+  VectorXd NewInputs = GetInputs(Struct,Bead);
+  if (NewInputs.size() != Inputs.size())
+  {
+    return 0;
+  }
+  //Only identical inputs give identical TINKER files
+  return (NewInputs == Inputs);
+};
+
+void MMPolResult::Save(vector<QMMMAtom>& Struct, int Bead)
+{
+  //Function to mark the current results as valid for the structure
+  Inputs = GetInputs(Struct,Bead);
+  Saved = 1;
+  return;
+};
+
+void MMPolResult::Clear()
+{
+  //Function to remove the results
+  Saved = 0;
+  E = 0;
+  Forces.setZero();
+  return;
+};
+
+//RandomStream class function definitions
+RandomStream::RandomStream()
+{
+  //Constructor
+  Seed(0,0,0,0);
+  return;
+};
+
+RandomStream::~RandomStream()
+{
+  //Generic destructor
+  return;
+};
+
+void RandomStream::NextBlock()
+{
+  //Function to generate four random integers from the counter
+  uint32_t K0 = Key[0]; //Round key
+  uint32_t K1 = Key[1]; //Round key
+  for (int i=0;i<4;i++)
+  {
+    Block[i] = Ctr[i];
+  }
+  for (int r=0;r<10;r++)
+  {
+    //Philox round
+    uint64_t Prod0 = ((uint64_t)0xD2511F53)*Block[0];
+    uint64_t Prod1 = ((uint64_t)0xCD9E8D57)*Block[2];
+    uint32_t X0 = ((uint32_t)(Prod1 >> 32))^Block[1]^K0;
+    uint32_t X2 = ((uint32_t)(Prod0 >> 32))^Block[3]^K1;
+    Block[0] = X0;
+    Block[1] = (uint32_t)Prod1;
+    Block[2] = X2;
+    Block[3] = (uint32_t)Prod0;
+    //Update the key
+    K0 += 0x9E3779B9;
+    K1 += 0xBB67AE85;
+  }
+  //Move to the next block
+  Ctr[0] += 1;
+  if (Ctr[0] == 0)
+  {
+    Ctr[1] += 1;
+  }
+  Nused = 0;
+  return;
+};
+
+void RandomStream::Seed(uint64_t NewSeed, int Chain, int Use, int Index)
+{
+  //Function to start a stream
+  Key[0] = (uint32_t)NewSeed;
+  Key[1] = (uint32_t)(NewSeed >> 32);
+  Ctr[0] = 0;
+  Ctr[1] = 0;
+  Ctr[2] = (uint32_t)Index;
+  Ctr[3] = (((uint32_t)Chain) << 8)+((uint32_t)(Use & 0xFF));
+  Nused = 4; //Generate a block on the first call
+  return;
+};
+
+uint32_t RandomStream::Integer()
+{
+  //Function to return a random 32-bit integer
+  if (Nused == 4)
+  {
+    NextBlock();
+  }
+  uint32_t Val = Block[Nused];
+  Nused += 1;
+  return Val;
+};
+
+int RandomStream::Integer(int N)
+{
+  //Function to return a random integer from 0 to N-1
+  uint64_t Val = ((uint64_t)Integer())*((uint64_t)N);
+  return (int)(Val >> 32);
+};
+
+double RandomStream::Uniform()
+{
+  //Function to return a random number from 0 to 1 (53-bit resolution)
+  uint64_t Hi = Integer() >> 5;
+  uint64_t Lo = Integer() >> 6;
+  return ((Hi << 26)+Lo)/9007199254740992.0;
+};
+
+double RandomStream::Normal()
+{
+  //Function to return a Gaussian random number (Box-Muller)
+  double u1 = 1-Uniform(); //Avoid log(0)
+  double u2 = Uniform();
+  return sqrt(-2*log(u1))*cos(2*pi*u2);
+};
+
+bool RandomStream::SelfTest()
+{
+  //Function to check the generator against known answers
+  //NB: The vectors are the Philox4x32-10 known-answer tests of Random123.
+  //The stream is reset to the default seed afterwards.
+  uint32_t Keys[3][2] = {{0x00000000,0x00000000},
+                         {0xFFFFFFFF,0xFFFFFFFF},
+                         {0xA4093822,0x299F31D0}};
+  uint32_t Ctrs[3][4] = {{0x00000000,0x00000000,0x00000000,0x00000000},
+                         {0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF},
+                         {0x243F6A88,0x85A308D3,0x13198A2E,0x03707344}};
+  uint32_t Answers[3][4] = {{0x6627E8D5,0xE169C58D,0xBC57AC4C,0x9B00DBD8},
+                            {0x408F276D,0x41C83B0E,0xA20BC7C6,0x6D5451FD},
+                            {0xD16CFE09,0x94FDCCEB,0x5001E420,0x24126EA1}};
+  bool Pass = 1;
+  for (int t=0;t<3;t++)
+  {
+    //Generate the block for the test vector
+    Key[0] = Keys[t][0];
+    Key[1] = Keys[t][1];
+    for (int i=0;i<4;i++)
+    {
+      Ctr[i] = Ctrs[t][i];
+    }
+    NextBlock();
+    for (int i=0;i<4;i++)
+    {
+      if (Block[i] != Answers[t][i])
+      {
+        Pass = 0;
+      }
+    }
+  }
+  Seed(0,0,0,0);
+  return Pass;
+};
+
+//MCStats class function definitions
+MCStats::MCStats()
+{
+  //Constructor
+  Clear();
+  return;
+};
+
+MCStats::~MCStats()
+{
+  //Generic destructor
+  return;
+};
+
+void MCStats::Clear()
+{
+  //Function to reset the counters
+  Tries.setZero(Nmoves);
+  Accepts.setZero(Nmoves);
+  QMCalls = 0;
+  Energies.clear();
+  Evirial.clear();
+  Nacc = 0;
+  Nrej = 0;
+  DenAvg = 0;
+  LxAvg = 0;
+  LyAvg = 0;
+  LzAvg = 0;
+  return;
+};
+
+double MCStats::CorrTime()
+{
+  //Function to estimate the integrated autocorrelation time of the
+  //energies (steps)
+  //NB: The sum is truncated at the first window M with M > 5*tau, which
+  //balances the bias and the noise of the estimate
+  int Npts = Energies.size(); //Number of samples
+  if (Npts < 2)
+  {
+    return 1;
+  }
+  Map<VectorXd> E(Energies.data(),Npts); //Energies as a vector
+  VectorXd dE = E.array()-E.mean(); //Energy fluctuations
+  double Var = dE.squaredNorm()/Npts; //Variance
+  if (Var <= 0)
+  {
+    //Constant energies
+    return 1;
+  }
+  double Tau = 1; //Autocorrelation time
+  for (int t=1;t<(Npts/2);t++)
+  {
+    //Add the autocorrelation function
+    double Rho = dE.head(Npts-t).dot(dE.tail(Npts-t));
+    Rho /= (Npts-t)*Var;
+    Tau += 2*Rho;
+    if (t > (5*Tau))
+    {
+      //Window is large enough
+      break;
+    }
+  }
+  if (Tau < 1)
+  {
+    //Anticorrelated samples are counted as independent
+    Tau = 1;
+  }
+  return Tau;
+};
+
+//QMMMSettings class function definitions
+QMMMSettings::QMMMSettings()
+{
+  //QM wrapper settings
+  Func = "N/A";
+  Basis = "N/A";
+  RAM = 256;
+  MemMB = 1;
+  Charge = 0;
+  Spin = 1;
+  BackDir = "Old_files";
+  ScratchDir = ""; //Files are written in the working directory
+  CacheResults = 1; //Skip calculations on repeated structures
+  QMStoreDir = ""; //QM results are not saved between simulations
+  QMStoreMB = 1024.0;
+  QMStoreCheck = 0.0; //Trust the saved results
+  //QMMM long-range electrostatics settings
+  UseLREC = 0;
+  LRECCut = 1000.0; //Effectively infinite
+  LRECPow = 3;
+  //MM wrapper settings
+  UseMMCut = 0;
+  MMOptCut = 1000.0; //Effectively infinite
+  UseEwald = 0;
+  UseImpSolv = 0;
+  SolvModel = "N/A";
+  //MC, MD, and RP settings
+  Ensemble = "N/A";
+  Temp = 300.0;
+  Beta = 1/(300.0*k);
+  Press = 0.0;
+  Neq = 0;
+  Nsteps = 0;
+  Nbeads = 1; //Key for printing
+  QMBeads = 0; //QM energies for every bead
+  PIFactor = "Primitive"; //Trotter factorization
+  PIVirial = 0;
+  accratio = 0.5;
+  Nprint = 5000;
+  dt = 1.0;
+  tautemp = 1000.0;
+  BeadMove = "Staging";
+  StageLen = 0; //Set from the number of beads
+  MCStep = 2*StepMin;
+  Chain = 0;
+  Nchains = 1;
+  //Trajectory settings
+  BinTraj = 0; //Text XYZ trajectories
+  TrajBytes = 8; //Double precision
+  TrajQuant = 0.0; //No compression
+  //Optimization settings
+  MaxOptSteps = 200;
+  MMOptTol = 1e-2;
+  OptMetric = "DistMat"; //Distance matrix RMS deviation
+  QMOptTol = 5e-4;
+  StepScale = 1.0;
+  MaxStep = 0.1;
+  //Additional RP settings
+  Kspring = 1.0;
+  TSBead = 0;
+  Climb = 0;
+  FrznEnds = 0;
+  NEBFreq = 0;
+  PrintNormModes = 0;
+  StartPathChk = 1; //Speeds up reaction pathways
+  //Temporary energy storage
+  Eold = 0.0;
+  Espring = 0.0;
+  Ereact = 0.0;
+  Eprod = 0.0;
+  Ets = 0.0;
+  return;
+};
+
+QMMMSettings::~QMMMSettings()
+{
+  //Generic destructor
+  return;
+};
+
+//PeriodicTable class function definitions
+PeriodicTable::PeriodicTable()
+{
+  //Generic constructor
+  return;
+};
+
+PeriodicTable::~PeriodicTable()
+{
+  //Generic destructor
+  return;
+};
+
+string PeriodicTable::Typing(int Z)
+{
+  //Function to convert nuclear charges to atom types
+  return Elements[Z-1].Typ;
+};
+
+int PeriodicTable::RevTyping(string AtName)
+{
+  //Function to convert atom types to nuclear charges
+  return SymbolToZ(AtName);
+};
+
+double PeriodicTable::GetCovRadius(string AtName)
+{
+  //Function to find the covalent radius of an atom
+  return GetCovRadius(SymbolToZ(AtName));
+};
+
+double PeriodicTable::GetCovRadius(int Z)
+{
+  //Function to find the covalent radius of an element
+  if ((Z < 1) or (Z > Nelements))
+  {
+    //Unknown element
+    return 0;
+  }
+  return Elements[Z-1].CovRadius;
+};
+
+double PeriodicTable::GetRadius(string AtName)
+{
+  //Function to find the vdW radius of an atom
+  return GetRadius(SymbolToZ(AtName));
+};
+
+double PeriodicTable::GetRadius(int Z)
+{
+  //Function to find the vdW radius of an element
+  if ((Z < 1) or (Z > Nelements))
+  {
+    //Unknown element
+    return 0;
+  }
+  return Elements[Z-1].vdWRadius;
+};
+
+double PeriodicTable::GetAtMass(string AtName)
+{
+  //Function to find the atomic mass of an atom
+  return GetAtMass(SymbolToZ(AtName));
+};
+
+double PeriodicTable::GetAtMass(int Z)
+{
+  //Function to find the atomic mass of an element
+  if ((Z < 1) or (Z > Nelements))
+  {
+    //Unknown element
+    return 0;
+  }
+  return Elements[Z-1].AtMass;
+};
+
+//CachedResult class function definitions
+CachedResult::CachedResult()
+{
+  //Constructor
+  Key = 0;
+  E = 0;
+  HasForces = 0;
+  return;
+};
+
+CachedResult::~CachedResult()
+{
+  //Generic destructor
+  return;
+};
+
+//ResultCache class function definitions
+ResultCache::ResultCache()
+{
+  //Constructor
+  Results.resize(128); //Enough for several steps of every bead
+  NextResult = 0;
+  Nhits = 0;
+  Nmisses = 0;
+  return;
+};
+
+ResultCache::~ResultCache()
+{
+  //Generic destructor
+  return;
+};
+
+void ResultCache::AddToHash(uint64_t& Hash, const void* Data, size_t Nbytes)
+{
+  //Function to add raw data to a 64-bit FNV-1a hash
+  const unsigned char* Bytes = (const unsigned char*)Data;
+  for (size_t i=0;i<Nbytes;i++)
+  {
+    Hash ^= (uint64_t)Bytes[i];
+    Hash *= 1099511628211ULL; //FNV prime
+  }
+  return;
+};
+
+uint64_t ResultCache::GetKey(const string& Tag, vector<QMMMAtom>& Struct,
+                             QMMMSettings& QMMMOpts, int Bead, bool QMCalc,
+                             bool QMCharges)
+{
+  //Function to hash everything that changes the result of a calculation
+  //NB: QM calculations only see the multipoles of the MM atoms, and their
+  //own charges are updated by the calculation. MM calculations only see the
+  //QM charges when QMCharges is true.
+  if (!QMMMOpts.CacheResults)
+  {
+    //Zero is never saved
+    return 0;
+  }
+  uint64_t Hash = 14695981039346656037ULL; //FNV offset basis
+  //Wrapper and settings
+  AddToHash(Hash,Tag.c_str(),Tag.size()+1);
+  AddToHash(Hash,QMMMOpts.Func.c_str(),QMMMOpts.Func.size()+1);
+  AddToHash(Hash,QMMMOpts.Basis.c_str(),QMMMOpts.Basis.size()+1);
+  AddToHash(Hash,QMMMOpts.SolvModel.c_str(),QMMMOpts.SolvModel.size()+1);
+  AddToHash(Hash,&QMMMOpts.Charge,sizeof(int));
+  AddToHash(Hash,&QMMMOpts.Spin,sizeof(int));
+  AddToHash(Hash,&QMMMOpts.UseLREC,sizeof(bool));
+  AddToHash(Hash,&QMMMOpts.LRECCut,sizeof(double));
+  AddToHash(Hash,&QMMMOpts.LRECPow,sizeof(int));
+  AddToHash(Hash,&QMMMOpts.UseMMCut,sizeof(bool));
+  AddToHash(Hash,&QMMMOpts.MMOptCut,sizeof(double));
+  AddToHash(Hash,&QMMMOpts.UseEwald,sizeof(bool));
+  AddToHash(Hash,&QMMMOpts.UseImpSolv,sizeof(bool));
+  //Box
+  AddToHash(Hash,&Lx,sizeof(double));
+  AddToHash(Hash,&Ly,sizeof(double));
+  AddToHash(Hash,&Lz,sizeof(double));
+  //Atoms
+  for (int i=0;i<Natoms;i++)
+  {
+    AddToHash(Hash,&Struct[i].P[Bead].x,sizeof(double));
+    AddToHash(Hash,&Struct[i].P[Bead].y,sizeof(double));
+    AddToHash(Hash,&Struct[i].P[Bead].z,sizeof(double));
+    if (QMCalc and (!Struct[i].MMregion))
+    {
+      //Not part of the QM input
+      continue;
+    }
+    if ((!QMCharges) and (Struct[i].QMregion or Struct[i].PBregion))
+    {
+      //The QM charges are not used
+      continue;
+    }
+    if ((int)Struct[i].MP.size() > Bead)
+    {
+      Mpole& MP = Struct[i].MP[Bead]; //Shorter name
+      AddToHash(Hash,&MP.q,sizeof(double));
+      AddToHash(Hash,&MP.Dx,sizeof(double));
+      AddToHash(Hash,&MP.Dy,sizeof(double));
+      AddToHash(Hash,&MP.Dz,sizeof(double));
+      AddToHash(Hash,&MP.IDx,sizeof(double));
+      AddToHash(Hash,&MP.IDy,sizeof(double));
+      AddToHash(Hash,&MP.IDz,sizeof(double));
+      AddToHash(Hash,&MP.Qxx,sizeof(double));
+      AddToHash(Hash,&MP.Qxy,sizeof(double));
+      AddToHash(Hash,&MP.Qxz,sizeof(double));
+      AddToHash(Hash,&MP.Qyy,sizeof(double));
+      AddToHash(Hash,&MP.Qyz,sizeof(double));
+      AddToHash(Hash,&MP.Qzz,sizeof(double));
+    }
+    if (QMCalc and ((int)Struct[i].PC.size() > Bead))
+    {
+      //Point-charges used in place of the multipoles
+      OctCharges& PC = Struct[i].PC[Bead]; //Shorter name
+      double Vals[24] = {PC.q1,PC.q2,PC.q3,PC.q4,PC.q5,PC.q6,
+                         PC.x1,PC.y1,PC.z1,PC.x2,PC.y2,PC.z2,
+                         PC.x3,PC.y3,PC.z3,PC.x4,PC.y4,PC.z4,
+                         PC.x5,PC.y5,PC.z5,PC.x6,PC.y6,PC.z6};
+      AddToHash(Hash,Vals,sizeof(Vals));
+    }
+  }
+  //The lowest bit marks QM calculations, which update the QM charges
+  Hash &= (~1ULL);
+  if (QMCalc)
+  {
+    Hash |= 1ULL;
+  }
+  if (Hash == 0)
+  {
+    //Avoid the empty key
+    Hash = 2;
+  }
+  return Hash;
+};
+
+int ResultCache::FindEntry(uint64_t Key)
+{
+  //Function to locate a saved result, returns -1 if it is not found
+  int Entry = -1;
+  for (unsigned int i=0;i<Results.size();i++)
+  {
+    if (Results[i].Key == Key)
+    {
+      //Prefer entries with forces
+      if ((Entry < 0) or Results[i].HasForces)
+      {
+        Entry = i;
+      }
+    }
+  }
+  return Entry;
+};
+
+bool ResultCache::FindEnergy(uint64_t Key, vector<QMMMAtom>& Struct,
+                             int Bead, double& E)
+{
+  //Function to recover a saved energy and the QM charges
+  if (Key == 0)
+  {
+    return 0;
+  }
+  bool Found = 0;
+  #pragma omp critical(LICHEMResultCache)
+  {
+    int Entry = FindEntry(Key);
+    if (Entry >= 0)
+    {
+      E = Results[Entry].E;
+      //NB: Only QM results have charges
+      for (int p=0;p<Results[Entry].Charges.size();p++)
+      {
+        Struct[QMPBList[p]].MP[Bead].q = Results[Entry].Charges(p);
+      }
+      Found = 1;
+      Nhits += 1;
+    }
+    else
+    {
+      Nmisses += 1;
+    }
+  }
+  return Found;
+};
+
+bool ResultCache::FindForces(uint64_t Key, vector<QMMMAtom>& Struct,
+                             VectorXd& Forces, int Bead, double& E)
+{
+  //Function to recover saved forces, the energy, and the QM charges
+  if (Key == 0)
+  {
+    return 0;
+  }
+  bool Found = 0;
+  #pragma omp critical(LICHEMResultCache)
+  {
+    int Entry = FindEntry(Key);
+    if ((Entry >= 0) and Results[Entry].HasForces and
+       (Results[Entry].Forces.size() == Forces.size()))
+    {
+      E = Results[Entry].E;
+      Forces += Results[Entry].Forces;
+      //NB: Only QM results have charges
+      for (int p=0;p<Results[Entry].Charges.size();p++)
+      {
+        Struct[QMPBList[p]].MP[Bead].q = Results[Entry].Charges(p);
+      }
+      Found = 1;
+      Nhits += 1;
+    }
+    else
+    {
+      Nmisses += 1;
+    }
+  }
+  return Found;
+};
+
+void ResultCache::Save(uint64_t Key, vector<QMMMAtom>& Struct,
+                       const VectorXd* Forces, int Bead, double E)
+{
+  //Function to save a new result
+  if ((Key == 0) or (E >= HugeNum))
+  {
+    //Failed calculations are not saved
+    return;
+  }
+  #pragma omp critical(LICHEMResultCache)
+  {
+    int Entry = FindEntry(Key);
+    bool Update = 1; //Flag to write the entry
+    if ((Entry >= 0) and Results[Entry].HasForces and (Forces == NULL))
+    {
+      //The saved forces calculation already has the energy
+      Update = 0;
+    }
+    if (Entry < 0)
+    {
+      //Replace the oldest result
+      Entry = NextResult;
+      NextResult = (NextResult+1)%Results.size();
+    }
+    if (Update)
+    {
+      CachedResult& Saved = Results[Entry]; //Shorter name
+      Saved.Key = Key;
+      Saved.E = E;
+      Saved.HasForces = (Forces != NULL);
+      if (Saved.HasForces)
+      {
+        Saved.Forces = *Forces;
+      }
+      else
+      {
+        Saved.Forces.resize(0);
+      }
+      Saved.Charges.resize(0);
+      if (Key & 1ULL)
+      {
+        //Save the new QM charges
+        Saved.Charges.resize(Nqm+Npseudo);
+        for (int p=0;p<(Nqm+Npseudo);p++)
+        {
+          Saved.Charges(p) = Struct[QMPBList[p]].MP[Bead].q;
+        }
+      }
+    }
+  }
+  return;
+};
+
+void ResultCache::SaveEnergy(uint64_t Key, vector<QMMMAtom>& Struct,
+                             int Bead, double E)
+{
+  //Function to save an energy
+  Save(Key,Struct,NULL,Bead,E);
+  return;
+};
+
+void ResultCache::SaveForces(uint64_t Key, vector<QMMMAtom>& Struct,
+                             const VectorXd& Forces, int Bead, double E)
+{
+  //Function to save forces and the energy
+  Save(Key,Struct,&Forces,Bead,E);
+  return;
+};
+
+int ResultCache::Hits()
+{
+  //Function to return the number of results found in memory
+  return Nhits;
+};
+
+int ResultCache::Misses()
+{
+  //Function to return the number of results which were calculated
+  return Nmisses;
+};
+
+//QMResultStore class function definitions
+QMResultStore::QMResultStore()
+{
+  //Constructor
+  Dir = ""; //Nothing is saved until the store is opened
+  MaxBytes = 0;
+  UsedBytes = 0;
+  CheckFrac = 0;
+  ETol = 1e-4;
+  FTol = 1e-3;
+  HTol = 1e-4;
+  Nhits = 0;
+  Nmisses = 0;
+  Nchecks = 0;
+  Nbad = 0;
+  return;
+};
+
+QMResultStore::~QMResultStore()
+{
+  //Generic destructor
+  return;
+};
+
+void QMResultStore::Open(QMMMSettings& QMMMOpts)
+{
+  //Function to set up the directory and limits
+  Dir = QMMMOpts.QMStoreDir;
+  MaxBytes = QMMMOpts.QMStoreMB*1024*1024;
+  CheckFrac = QMMMOpts.QMStoreCheck;
+  if (Dir == "")
+  {
+    return;
+  }
+  if (!LICHEMMakeDir(Dir))
+  {
+    cerr << "Warning: Could not create the QM result directory ";
+    cerr << Dir << "!!!";
+    cerr << '\n';
+    cerr << " LICHEM will continue without saved QM results...";
+    cerr << '\n';
+    cerr.flush(); //Print warning immediately
+    Dir = "";
+    return;
+  }
+  //Find the size of the old records and apply the limit
+  Prune(MaxBytes);
+  return;
+};
+
+string QMResultStore::RecordName(uint64_t Key)
+{
+  //Function to find the file name for a record
+  stringstream call; //Stream for file names
+  call << Dir << "/" << hex << setfill('0') << setw(16) << Key << ".qm";
+  return call.str();
+};
+
+uint64_t QMResultStore::GetKey(const string& InputFile, int Bead)
+{
+  //Function to hash a QM input file
+  //NB: Lines for the memory, CPUs, checkpoints, and initial guesses are
+  //skipped, since they change between simulations without changing the
+  //results. The bead number is also removed from the file names.
+  if (Dir == "")
+  {
+    //Zero is never saved
+    return 0;
+  }
+  fstream ifile; //Input file stream
+  ifile.open(InputFile.c_str(),ios_base::in);
+  if (!ifile.good())
+  {
+    return 0;
+  }
+  stringstream call; //Stream for file names
+  call << "LICHM_" << Bead;
+  string BeadName = call.str();
+  uint64_t Hash = 14695981039346656037ULL; //FNV offset basis
+  string dummy; //Generic string
+  while (getline(ifile,dummy))
+  {
+    //Remove the bead number
+    size_t Pos = dummy.find(BeadName);
+    while (Pos != string::npos)
+    {
+      dummy.replace(Pos,BeadName.size(),"LICHM_");
+      Pos = dummy.find(BeadName,Pos+1);
+    }
+    //Remove PSI4 restart files
+    Pos = dummy.find(",restart_file=[");
+    if (Pos != string::npos)
+    {
+      dummy.erase(Pos,dummy.find("]",Pos)-Pos+1);
+    }
+    //Collect the words of the line
+    stringstream line(dummy);
+    string Canon = ""; //Line with single spaces
+    string word,lword; //Original and lower case words
+    bool Skip = 0; //Flag for lines which do not change the results
+    int Nwords = 0; //Number of saved words
+    while ((!Skip) and (line >> word))
+    {
+      lword = word;
+      LICHEMLowerText(lword);
+      if (Nwords == 0)
+      {
+        //Gaussian Link 0 and NWChem or PSI4 settings
+        Skip = ((lword[0] == '%') or (lword == "memory") or
+               (lword == "start") or (lword == "restart") or
+               (lword == "vectors") or
+               (lword.compare(0,15,"set_num_threads") == 0));
+      }
+      if ((Nwords == 1) and (lword == "guess") and (Canon == "set "))
+      {
+        //PSI4 initial guess
+        Skip = 1;
+      }
+      if ((!Skip) and (lword != "guess=tcheck"))
+      {
+        Canon += word+" ";
+        Nwords += 1;
+      }
+    }
+    if (!Skip)
+    {
+      //Add the line to the hash
+      Canon += '\n';
+      for (size_t i=0;i<Canon.size();i++)
+      {
+        Hash ^= (uint64_t)(unsigned char)Canon[i];
+        Hash *= 1099511628211ULL; //FNV prime
+      }
+    }
+  }
+  ifile.close();
+  if (Hash == 0)
+  {
+    //Avoid the empty key
+    Hash = 1;
+  }
+  return Hash;
+};
+
+bool QMResultStore::Read(uint64_t Key, double& E, VectorXd& Charges,
+                         VectorXd& Forces, MatrixXd& Hess)
+{
+  //Function to read a record, returns 0 for missing or incomplete files
+  fstream ifile; //Input file stream
+  ifile.open(RecordName(Key).c_str(),ios_base::in);
+  if (!ifile.good())
+  {
+    return 0;
+  }
+  E = HugeNum; //No energy
+  Charges.resize(0);
+  Forces.resize(0);
+  Hess.resize(0,0);
+  bool Complete = 0; //Flag for the end of the record
+  int N = 0; //Number of values
+  string dummy; //Generic string
+  while ((!Complete) and (ifile >> dummy))
+  {
+    if (dummy == "Energy:")
+    {
+      ifile >> E;
+    }
+    else if (dummy == "Charges:")
+    {
+      ifile >> N;
+      Charges.resize(N);
+      for (int i=0;i<N;i++)
+      {
+        ifile >> Charges(i);
+      }
+    }
+    else if (dummy == "Forces:")
+    {
+      ifile >> N;
+      Forces.resize(N);
+      for (int i=0;i<N;i++)
+      {
+        ifile >> Forces(i);
+      }
+    }
+    else if (dummy == "Hessian:")
+    {
+      ifile >> N;
+      Hess.resize(N,N);
+      for (int i=0;i<N;i++)
+      {
+        for (int j=0;j<N;j++)
+        {
+          ifile >> Hess(i,j);
+        }
+      }
+    }
+    else if (dummy == "End")
+    {
+      Complete = 1;
+    }
+  }
+  ifile.close();
+  return Complete;
+};
+
+bool QMResultStore::Find(uint64_t Key, vector<QMMMAtom>& Struct, int Bead,
+                         double& E, VectorXd* Forces, MatrixXd* Hess)
+{
+  //Function to recover a saved result
+  if (Key == 0)
+  {
+    return 0;
+  }
+  bool Found = 0;
+  #pragma omp critical(LICHEMQMStore)
+  {
+    double Eold;
+    VectorXd Qold,Fold;
+    MatrixXd Hold;
+    bool Good = Read(Key,Eold,Qold,Fold,Hold);
+    //Check that the record has the requested results
+    if (Good and (Hess == NULL))
+    {
+      Good = ((Eold < HugeNum) and (Qold.size() == (Nqm+Npseudo)));
+    }
+    if (Good and (Forces != NULL))
+    {
+      Good = (Fold.size() == Forces->size());
+    }
+    if (Good and (Hess != NULL))
+    {
+      Good = (Hold.rows() == Hess->rows());
+    }
+    if (!Good)
+    {
+      Nmisses += 1;
+    }
+    else
+    {
+      Nhits += 1;
+      //Mark the record as recently used
+      utimensat(AT_FDCWD,RecordName(Key).c_str(),NULL,0);
+      if (Nchecks < (CheckFrac*Nhits))
+      {
+        //Recalculate the result to test the record
+        Nchecks += 1;
+        CheckKeys.push_back(Key);
+      }
+      else
+      {
+        //Copy the results
+        Found = 1;
+        if (Hess != NULL)
+        {
+          *Hess = Hold;
+        }
+        else
+        {
+          E = Eold;
+          for (int p=0;p<(Nqm+Npseudo);p++)
+          {
+            Struct[QMPBList[p]].MP[Bead].q = Qold(p);
+          }
+        }
+        if (Forces != NULL)
+        {
+          *Forces += Fold;
+        }
+      }
+    }
+  }
+  return Found;
+};
+
+void QMResultStore::Save(uint64_t Key, vector<QMMMAtom>& Struct, int Bead,
+                         double E, const VectorXd* Forces,
+                         const MatrixXd* Hess)
+{
+  //Function to write a new record
+  if ((Key == 0) or ((Hess == NULL) and (!(E < HugeNum))))
+  {
+    //Failed calculations are not saved
+    return;
+  }
+  #pragma omp critical(LICHEMQMStore)
+  {
+    string Name = RecordName(Key); //Record file
+    //Compare the new result to a recalculated record
+    vector<uint64_t>::iterator Pos;
+    Pos = find(CheckKeys.begin(),CheckKeys.end(),Key);
+    if (Pos != CheckKeys.end())
+    {
+      CheckKeys.erase(Pos);
+      double Eold;
+      VectorXd Qold,Fold;
+      MatrixXd Hold;
+      bool Match = Read(Key,Eold,Qold,Fold,Hold);
+      if (Match and (Hess == NULL))
+      {
+        Match = (abs(E-Eold) <= ETol);
+      }
+      if (Match and (Forces != NULL))
+      {
+        Match = ((Fold.size() == Forces->size()) and
+                ((Fold.size() == 0) or
+                ((Fold-*Forces).cwiseAbs().maxCoeff() <= FTol)));
+      }
+      if (Match and (Hess != NULL))
+      {
+        Match = ((Hold.rows() == Hess->rows()) and
+                ((Hold.size() == 0) or
+                ((Hold-*Hess).cwiseAbs().maxCoeff() <= HTol)));
+      }
+      if (!Match)
+      {
+        Nbad += 1;
+        cerr << "Warning: Saved QM result " << Name;
+        cerr << " does not match the new calculation!!!";
+        cerr << '\n';
+        cerr << " LICHEM will replace the saved result...";
+        cerr << '\n';
+        cerr.flush(); //Print warning immediately
+      }
+    }
+    //Write the record to a temporary file
+    stringstream call; //Stream for file names
+    call << Name << ".tmp" << getpid();
+    string TmpName = call.str();
+    ofstream ofile; //Output file stream
+    ofile.open(TmpName.c_str(),ios_base::out);
+    ofile << scientific << setprecision(17);
+    ofile << "LICHEM QM result" << '\n';
+    if (Hess == NULL)
+    {
+      ofile << "Energy: " << E << '\n';
+      ofile << "Charges: " << (Nqm+Npseudo) << '\n';
+      for (int p=0;p<(Nqm+Npseudo);p++)
+      {
+        ofile << Struct[QMPBList[p]].MP[Bead].q << '\n';
+      }
+    }
+    if (Forces != NULL)
+    {
+      ofile << "Forces: " << Forces->size() << '\n';
+      for (int i=0;i<Forces->size();i++)
+      {
+        ofile << (*Forces)(i) << '\n';
+      }
+    }
+    if (Hess != NULL)
+    {
+      ofile << "Hessian: " << Hess->rows() << '\n';
+      for (int i=0;i<Hess->rows();i++)
+      {
+        for (int j=0;j<Hess->cols();j++)
+        {
+          ofile << (*Hess)(i,j) << " ";
+        }
+        ofile << '\n';
+      }
+    }
+    ofile << "End" << '\n';
+    ofile.close();
+    //Replace the old record
+    struct stat buffer;
+    double OldSize = 0;
+    if (stat(Name.c_str(),&buffer) == 0)
+    {
+      OldSize = buffer.st_size;
+    }
+    if ((!ofile.fail()) and (rename(TmpName.c_str(),Name.c_str()) == 0))
+    {
+      if (stat(Name.c_str(),&buffer) == 0)
+      {
+        UsedBytes += buffer.st_size-OldSize;
+      }
+    }
+    else
+    {
+      remove(TmpName.c_str());
+    }
+    if (UsedBytes > MaxBytes)
+    {
+      //Leave room for new records
+      Prune(0.9*MaxBytes);
+    }
+  }
+  return;
+};
+
+void QMResultStore::Prune(double MaxSize)
+{
+  //Function to remove the least recently used records
+  //NB: This also updates the size of the directory, since other simulations
+  //can add records
+  vector<pair<double,string> > Records; //Access times and file names
+  string Pattern = Dir+"/*.qm";
+  glob_t Files;
+  UsedBytes = 0;
+  if (glob(Pattern.c_str(),0,NULL,&Files) == 0)
+  {
+    for (size_t i=0;i<Files.gl_pathc;i++)
+    {
+      struct stat buffer;
+      if (stat(Files.gl_pathv[i],&buffer) == 0)
+      {
+        double Age = buffer.st_mtim.tv_sec+1e-9*buffer.st_mtim.tv_nsec;
+        Records.push_back(make_pair(Age,string(Files.gl_pathv[i])));
+        UsedBytes += buffer.st_size;
+      }
+    }
+  }
+  globfree(&Files);
+  //Remove the oldest records first
+  sort(Records.begin(),Records.end());
+  for (unsigned int i=0;i<Records.size();i++)
+  {
+    if (UsedBytes <= MaxSize)
+    {
+      break;
+    }
+    struct stat buffer;
+    if ((stat(Records[i].second.c_str(),&buffer) == 0) and
+       (remove(Records[i].second.c_str()) == 0))
+    {
+      UsedBytes -= buffer.st_size;
+    }
+  }
+  return;
+};
+
+bool QMResultStore::FindEnergy(uint64_t Key, vector<QMMMAtom>& Struct,
+                               int Bead, double& E)
+{
+  //Function to recover a saved energy and the QM charges
+  return Find(Key,Struct,Bead,E,NULL,NULL);
+};
+
+bool QMResultStore::FindForces(uint64_t Key, vector<QMMMAtom>& Struct,
+                               VectorXd& Forces, int Bead, double& E)
+{
+  //Function to recover saved forces, the energy, and the QM charges
+  return Find(Key,Struct,Bead,E,&Forces,NULL);
+};
+
+bool QMResultStore::FindHessian(uint64_t Key, MatrixXd& Hess)
+{
+  //Function to recover a saved Hessian
+  vector<QMMMAtom> Struct; //Not used for Hessians
+  double E = 0; //Not used for Hessians
+  return Find(Key,Struct,0,E,NULL,&Hess);
+};
+
+void QMResultStore::SaveEnergy(uint64_t Key, vector<QMMMAtom>& Struct,
+                               int Bead, double E)
+{
+  //Function to save an energy and the QM charges
+  Save(Key,Struct,Bead,E,NULL,NULL);
+  return;
+};
+
+void QMResultStore::SaveForces(uint64_t Key, vector<QMMMAtom>& Struct,
+                               const VectorXd& Forces, int Bead, double E)
+{
+  //Function to save forces, the energy, and the QM charges
+  Save(Key,Struct,Bead,E,&Forces,NULL);
+  return;
+};
+
+void QMResultStore::SaveHessian(uint64_t Key, const MatrixXd& Hess)
+{
+  //Function to save a Hessian
+  vector<QMMMAtom> Struct; //Not used for Hessians
+  Save(Key,Struct,0,0,NULL,&Hess);
+  return;
+};
+
+bool QMResultStore::Active()
+{
+  //Function to check if QM results are saved
+  return (Dir != "");
+};
+
+int QMResultStore::Hits()
+{
+  //Function to return the number of results read from the disk
+  return Nhits;
+};
+
+int QMResultStore::Misses()
+{
+  //Function to return the number of results which were not found
+  return Nmisses;
+};
+
+int QMResultStore::Checks()
+{
+  //Function to return the number of recalculated records
+  return Nchecks;
+};
+
+int QMResultStore::Mismatches()
+{
+  //Function to return the number of records which did not match
+  return Nbad;
+};
+
+//BeadScheduler class function definitions
+BeadScheduler::BeadScheduler()
+{
+  //Constructor
+  return;
+};
+
+BeadScheduler::~BeadScheduler()
+{
+  //Generic destructor
+  return;
+};
+
+void BeadScheduler::Setup()
+{
+  //Function to find the processors available to LICHEM
+  //NB: This is called outside of parallel regions, before any thread is
+  //pinned to a slot
+  if (Cores.size() == 0)
+  {
+    Cores = LICHEMCoreList();
+  }
+  return;
+};
+
+double BeadScheduler::Clock()
+{
+  //Function to return the wall time
+  return chrono::duration<double>(chrono::steady_clock::now().
+                                  time_since_epoch()).count();
+};
+
+int BeadScheduler::Slots(int Njobs)
+{
+  //Function to find the number of jobs which can run at the same time
+  Setup();
+  int Nslots = ((int)Cores.size())/Ncpus; //Jobs with Ncpus processors
+  if (Nslots > Nthreads)
+  {
+    //Respect the OpenMP thread settings
+    Nslots = Nthreads;
+  }
+  if (Nslots > Njobs)
+  {
+    Nslots = Njobs;
+  }
+  if (Nslots < 1)
+  {
+    Nslots = 1;
+  }
+  return Nslots;
+};
+
+vector<int> BeadScheduler::Order(const vector<int>& Beads)
+{
+  //Function to sort the beads from the most to the least expensive
+  //NB: Beads without a wall time keep their order. Monte Carlo chains which
+  //run at the same time share the costs of their beads.
+  int MaxBead = 0; //Largest bead ID
+  for (unsigned int i=0;i<Beads.size();i++)
+  {
+    MaxBead = max(MaxBead,Beads[i]);
+  }
+  vector<pair<double,int> > Jobs; //Negative cost and position in the list
+  #pragma omp critical(LICHEMBeadJobs)
+  {
+    if ((int)Cost.size() <= MaxBead)
+    {
+      Cost.resize(MaxBead+1,0.0);
+      Started.resize(MaxBead+1,0.0);
+    }
+    for (unsigned int i=0;i<Beads.size();i++)
+    {
+      Jobs.push_back(make_pair(-1*Cost[Beads[i]],(int)i));
+    }
+  }
+  sort(Jobs.begin(),Jobs.end());
+  vector<int> Sorted; //Beads in the order they are started
+  for (unsigned int i=0;i<Jobs.size();i++)
+  {
+    Sorted.push_back(Beads[Jobs[i].second]);
+  }
+  return Sorted;
+};
+
+void BeadScheduler::Pin()
+{
+  //Function to keep the calling thread on the processors of its slot
+  //NB: The slot is found from the innermost team which runs in parallel,
+  //so the beads of a Monte Carlo chain stay on the processors of the chain
+  int Slot = 0; //Thread number in the team
+  int Nslots = 1; //Number of threads in the team
+  #ifdef _OPENMP
+    int Level = omp_get_active_level(); //Innermost parallel team
+    if (Level > 0)
+    {
+      Slot = omp_get_ancestor_thread_num(Level);
+      Nslots = omp_get_team_size(Level);
+    }
+  #endif
+  if ((Nslots < 2) or ((Slot+1)*Ncpus > (int)Cores.size()))
+  {
+    //Nothing to divide
+    return;
+  }
+  vector<int> SlotCores(Cores.begin()+Slot*Ncpus,
+                        Cores.begin()+(Slot+1)*Ncpus);
+  LICHEMPinCores(SlotCores);
+  return;
+};
+
+void BeadScheduler::Unpin()
+{
+  //Function to allow the calling thread to use all processors
+  int Nslots = 1; //Number of threads in the team
+  #ifdef _OPENMP
+    int Level = omp_get_active_level(); //Innermost parallel team
+    if (Level > 0)
+    {
+      Nslots = omp_get_team_size(Level);
+    }
+  #endif
+  if (Nslots > 1)
+  {
+    LICHEMPinCores(Cores);
+  }
+  return;
+};
+
+void BeadScheduler::Start(int Bead)
+{
+  //Function to pin the thread and start the timer for a bead
+  Pin();
+  #pragma omp critical(LICHEMBeadJobs)
+  {
+    if (Bead < (int)Started.size())
+    {
+      Started[Bead] = Clock();
+    }
+  }
+  return;
+};
+
+void BeadScheduler::Finish(int Bead)
+{
+  //Function to save the wall time for a bead and unpin the thread
+  #pragma omp critical(LICHEMBeadJobs)
+  {
+    if (Bead < (int)Started.size())
+    {
+      Cost[Bead] = Clock()-Started[Bead];
+    }
+  }
+  Unpin();
+  return;
+};
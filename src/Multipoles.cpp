@@ -29,7 +29,7 @@ void ExtractTINKpoles(vector<QMMMAtom>& Struct, int Bead)
   stringstream call; //Stream for system calls and reading/writing files
   //Create TINKER xyz file from the structure
   call.str("");
-  call << "LICHM_" << Bead << ".xyz";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   //Write atoms to the xyz file
   ofile << Natoms << '\n';
@@ -58,7 +58,7 @@ void ExtractTINKpoles(vector<QMMMAtom>& Struct, int Bead)
   ofile.close();
   //Write poledit input
   call.str("");
-  call << "LICHM_" << Bead << ".txt";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".txt";
   ofile.open(call.str().c_str(),ios_base::out);
   ofile << "2" << '\n';
   ofile << "LICHM_" << Bead << ".xyz" << '\n';
@@ -67,11 +67,14 @@ void ExtractTINKpoles(vector<QMMMAtom>& Struct, int Bead)
   ofile.close();
   //Run poledit
   call.str("");
-  call << "poledit < LICHM_" << Bead << ".txt > LICHM_" << Bead << ".out";
-  GlobalSys = system(call.str().c_str());
-  //Extract multipole frames
+  call << "LICHM_" << Bead << ".txt";
+  string inname = call.str(); //Input file
   call.str("");
   call << "LICHM_" << Bead << ".out";
+  GlobalSys = LICHEMSpawn("poledit",LICHEMJobDir(Bead),inname,call.str());
+  //Extract multipole frames
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out";
   ifile.open(call.str().c_str(),ios_base::in);
   while (!ifile.eof())
   {
@@ -158,10 +161,11 @@ void ExtractTINKpoles(vector<QMMMAtom>& Struct, int Bead)
   ifile.close();
   //Clean up files
   call.str("");
-  call << "rm -f LICHM_" << Bead << ".txt LICHM_";
-  call << Bead << ".key LICHM_" << Bead << ".xyz LICHM_";
-  call << Bead << ".out";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".txt ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".key ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out";
+  LICHEMRemoveFiles(call.str());
   return;
 };
 
@@ -310,10 +314,12 @@ void RotateTINKCharges(vector<QMMMAtom>& Struct, int Bead)
         Vecz(1) = -1*y; //Correct the direction
         Vecz(2) = -1*z; //Correct the direction
         Vecz.normalize();
-        //Random vector
-        Vecx(0) = 2*((((double)rand())/((double)RAND_MAX))-0.5);
-        Vecx(1) = 2*((((double)rand())/((double)RAND_MAX))-0.5);
-        Vecx(2) = 2*((((double)rand())/((double)RAND_MAX))-0.5);
+        //Random vector (the same vector is used for every call)
+        RandomStream AtomRand; //Random numbers for this atom
+        AtomRand.Seed(RandSeed,0,RandFrames,i);
+        Vecx(0) = 2*(AtomRand.Uniform()-0.5);
+        Vecx(1) = 2*(AtomRand.Uniform()-0.5);
+        Vecx(2) = 2*(AtomRand.Uniform()-0.5);
         Vecx.normalize();
         //Subtract overlap and normalize
         Vecx -= Vecz*(Vecx.dot(Vecz));
@@ -532,9 +538,11 @@ void WriteChargeFile(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   bool FirstCharge = 1; //Always write the first charge
   //Find the center of mass
   Coord QMCOM; //QM region center of mass
+  VectorXd DxCOM,DyCOM,DzCOM; //Displacements from the QM COM
   if (PBCon or QMMMOpts.UseLREC)
   {
     QMCOM = FindQMCOM(Struct,QMMMOpts,Bead);
+    BeadDist2(Struct,QMCOM,Bead,DxCOM,DyCOM,DzCOM);
   }
   //Initialize charges
   if (AMOEBA)
@@ -550,137 +558,137 @@ void WriteChargeFile(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   {
     //Save file
     call.str("");
-    call << "MMCharges_" << Bead << ".txt";
+    call << LICHEMJobDir(Bead) << "MMCharges_" << Bead << ".txt";
     ofile.open(call.str().c_str(),ios_base::out);
-    for (int i=0;i<Natoms;i++)
+    for (unsigned int m=0;m<MMList.size();m++)
     {
-      if (Struct[i].MMregion)
+      int i = MMList[m]; //Atom ID
+      //Check PBC (minimum image convention)
+      Coord DistCent; //Distance from QM COM
+      double xshft = 0;
+      double yshft = 0;
+      double zshft = 0;
+      if (PBCon or QMMMOpts.UseLREC)
       {
-        //Check PBC (minimum image convention)
-        Coord DistCent; //Distance from QM COM
-        double xshft = 0;
-        double yshft = 0;
-        double zshft = 0;
-        if (PBCon or QMMMOpts.UseLREC)
+        //Initialize displacements
+        double dx,dy,dz; //Starting displacements
+        dx = Struct[i].P[Bead].x-QMCOM.x;
+        dy = Struct[i].P[Bead].y-QMCOM.y;
+        dz = Struct[i].P[Bead].z-QMCOM.z;
+        DistCent.x = DxCOM(i);
+        DistCent.y = DyCOM(i);
+        DistCent.z = DzCOM(i);
+        //Calculate the shift in positions
+        //NB: Generally this work out to be +/- {Lx,Ly,Lz}
+        if (PBCon)
         {
-          //Initialize displacements
-          double dx,dy,dz; //Starting displacements
-          dx = Struct[i].P[Bead].x-QMCOM.x;
-          dy = Struct[i].P[Bead].y-QMCOM.y;
-          dz = Struct[i].P[Bead].z-QMCOM.z;
-          DistCent = CoordDist2(Struct[i].P[Bead],QMCOM);
-          //Calculate the shift in positions
-          //NB: Generally this work out to be +/- {Lx,Ly,Lz}
-          if (PBCon)
-          {
-            xshft = DistCent.x-dx;
-            yshft = DistCent.y-dy;
-            zshft = DistCent.z-dz;
-          }
+          xshft = DistCent.x-dx;
+          yshft = DistCent.y-dy;
+          zshft = DistCent.z-dz;
         }
-        //Check for long-range corrections
-        double scrq = 1;
-        if (QMMMOpts.UseLREC)
+      }
+      //Check for long-range corrections
+      double scrq = 1;
+      if (QMMMOpts.UseLREC)
+      {
+        //Use the long-range correction
+        double rcom = 0; //Distance from center of mass
+        //Calculate the distance from the center of mass
+        rcom = DistCent.VecMag();
+        if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
         {
-          //Use the long-range correction
-          double rcom = 0; //Distance from center of mass
-          //Calculate the distance from the center of mass
-          rcom = DistCent.VecMag();
-          if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
-          {
-            //Scale the charge
-            rcom = sqrt(rcom);
-            double scrqA,scrqB; //Temporary variables
-            //Calculate temp. variables
-            scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
-            scrqB = -3*scrqA*scrqA;
-            scrqA *= 2*scrqA*scrqA;
-            //Combine temp. variables
-            scrqA += scrqB+1;
-            //Set the scale factor
-            scrq -= pow(scrqA,QMMMOpts.LRECPow);
-          }
-          else
-          {
-            //Delete the charge
-            scrq = 0;
-          }
+          //Scale the charge
+          rcom = sqrt(rcom);
+          double scrqA,scrqB; //Temporary variables
+          //Calculate temp. variables
+          scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
+          scrqB = -3*scrqA*scrqA;
+          scrqA *= 2*scrqA*scrqA;
+          //Combine temp. variables
+          scrqA += scrqB+1;
+          //Set the scale factor
+          scrq -= pow(scrqA,QMMMOpts.LRECPow);
         }
-        if ((scrq > 0) or FirstCharge)
+        else
         {
-          if (CHRG)
-          {
-            //Add charges
-            FirstCharge = 0; //Skips writing the remaining zeros
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].P[Bead].x+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].P[Bead].y+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].P[Bead].z+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].MP[Bead].q*scrq,16);
-            ofile << '\n';
-          }
-          if (AMOEBA)
-          {
-            //Add multipoles
-            FirstCharge = 0; //Skips writing the remaining zeros
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x1+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y1+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z1+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q1*scrq,16);
-            ofile << '\n';
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x2+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y2+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z2+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q2*scrq,16);
-            ofile << '\n';
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x3+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y3+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z3+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q3*scrq,16);
-            ofile << '\n';
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x4+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y4+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z4+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q4*scrq,16);
-            ofile << '\n';
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x5+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y5+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z5+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q5*scrq,16);
-            ofile << '\n';
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x6+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y6+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z6+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q6*scrq,16);
-            ofile << '\n';
-          }
+          //Delete the charge
+          scrq = 0;
+        }
+      }
+      if ((scrq > 0) or FirstCharge)
+      {
+        if (CHRG)
+        {
+          //Add charges
+          FirstCharge = 0; //Skips writing the remaining zeros
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].P[Bead].x+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].P[Bead].y+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].P[Bead].z+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].MP[Bead].q*scrq,16);
+          ofile << '\n';
+        }
+        if (AMOEBA)
+        {
+          //Add multipoles
+          FirstCharge = 0; //Skips writing the remaining zeros
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x1+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y1+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z1+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q1*scrq,16);
+          ofile << '\n';
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x2+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y2+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z2+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q2*scrq,16);
+          ofile << '\n';
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x3+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y3+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z3+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q3*scrq,16);
+          ofile << '\n';
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x4+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y4+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z4+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q4*scrq,16);
+          ofile << '\n';
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x5+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y5+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z5+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q5*scrq,16);
+          ofile << '\n';
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x6+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y6+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z6+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q6*scrq,16);
+          ofile << '\n';
         }
       }
     }
@@ -689,114 +697,114 @@ void WriteChargeFile(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   {
     //Save file
     call.str("");
-    call << "MMCharges_" << Bead << ".txt";
+    call << LICHEMJobDir(Bead) << "MMCharges_" << Bead << ".txt";
     ofile.open(call.str().c_str(),ios_base::out);
-    for (int i=0;i<Natoms;i++)
+    for (unsigned int m=0;m<MMList.size();m++)
     {
-      if (Struct[i].MMregion)
+      int i = MMList[m]; //Atom ID
+      //Check PBC (minimum image convention)
+      Coord DistCent; //Distance from QM COM
+      double xshft = 0;
+      double yshft = 0;
+      double zshft = 0;
+      if (PBCon or QMMMOpts.UseLREC)
       {
-        //Check PBC (minimum image convention)
-        Coord DistCent; //Distance from QM COM
-        double xshft = 0;
-        double yshft = 0;
-        double zshft = 0;
-        if (PBCon or QMMMOpts.UseLREC)
+        //Initialize displacements
+        double dx,dy,dz; //Starting displacements
+        dx = Struct[i].P[Bead].x-QMCOM.x;
+        dy = Struct[i].P[Bead].y-QMCOM.y;
+        dz = Struct[i].P[Bead].z-QMCOM.z;
+        DistCent.x = DxCOM(i);
+        DistCent.y = DyCOM(i);
+        DistCent.z = DzCOM(i);
+        //Calculate the shift in positions
+        //NB: Generally this work out to be +/- {Lx,Ly,Lz}
+        if (PBCon)
         {
-          //Initialize displacements
-          double dx,dy,dz; //Starting displacements
-          dx = Struct[i].P[Bead].x-QMCOM.x;
-          dy = Struct[i].P[Bead].y-QMCOM.y;
-          dz = Struct[i].P[Bead].z-QMCOM.z;
-          DistCent = CoordDist2(Struct[i].P[Bead],QMCOM);
-          //Calculate the shift in positions
-          //NB: Generally this work out to be +/- {Lx,Ly,Lz}
-          if (PBCon)
-          {
-            xshft = DistCent.x-dx;
-            yshft = DistCent.y-dy;
-            zshft = DistCent.z-dz;
-          }
+          xshft = DistCent.x-dx;
+          yshft = DistCent.y-dy;
+          zshft = DistCent.z-dz;
         }
-        //Check for long-range corrections
-        double scrq = 1;
-        if (QMMMOpts.UseLREC)
+      }
+      //Check for long-range corrections
+      double scrq = 1;
+      if (QMMMOpts.UseLREC)
+      {
+        //Use the long-range correction
+        double rcom = 0; //Distance from center of mass
+        //Calculate the distance from the center of mass
+        rcom = DistCent.VecMag();
+        if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
         {
-          //Use the long-range correction
-          double rcom = 0; //Distance from center of mass
-          //Calculate the distance from the center of mass
-          rcom = DistCent.VecMag();
-          if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
-          {
-            //Scale the charge
-            rcom = sqrt(rcom);
-            double scrqA,scrqB; //Temporary variables
-            //Calculate temp. variables
-            scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
-            scrqB = -3*scrqA*scrqA;
-            scrqA *= 2*scrqA*scrqA;
-            //Combine temp. variables
-            scrqA += scrqB+1;
-            //Set the scale factor
-            scrq -= pow(scrqA,QMMMOpts.LRECPow);
-          }
-          else
-          {
-            //Delete the charge
-            scrq = 0;
-          }
+          //Scale the charge
+          rcom = sqrt(rcom);
+          double scrqA,scrqB; //Temporary variables
+          //Calculate temp. variables
+          scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
+          scrqB = -3*scrqA*scrqA;
+          scrqA *= 2*scrqA*scrqA;
+          //Combine temp. variables
+          scrqA += scrqB+1;
+          //Set the scale factor
+          scrq -= pow(scrqA,QMMMOpts.LRECPow);
         }
-        if (scrq > 0)
+        else
         {
-          if (CHRG)
-          {
-            //Add charges
-            ofile << "Chrgfield.extern.addCharge(";
-            ofile << LICHEMFormFloat(Struct[i].MP[Bead].q*scrq,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].P[Bead].x+xshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].P[Bead].y+yshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].P[Bead].z+zshft,16);
-            ofile << ")" << '\n';
-          }
-          if (AMOEBA)
-          {
-            //Add multipoles
-            ofile << "Chrgfield.extern.addCharge(";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q1*scrq,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x1+xshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y1+yshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z1+zshft,16);
-            ofile << ")" << '\n';
-            ofile << "Chrgfield.extern.addCharge(";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q2*scrq,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x2+xshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y2+yshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z2+zshft,16);
-            ofile << ")" << '\n';
-            ofile << "Chrgfield.extern.addCharge(";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q3*scrq,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x3+xshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y3+yshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z3+zshft,16);
-            ofile << ")" << '\n';
-            ofile << "Chrgfield.extern.addCharge(";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q4*scrq,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x4+xshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y4+yshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z4+zshft,16);
-            ofile << ")" << '\n';
-            ofile << "Chrgfield.extern.addCharge(";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q5*scrq,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x5+xshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y5+yshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z5+zshft,16);
-            ofile << ")" << '\n';
-            ofile << "Chrgfield.extern.addCharge(";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q6*scrq,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x6+xshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y6+yshft,16) << ",";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z6+zshft,16);
-            ofile << ")" << '\n';
-          }
+          //Delete the charge
+          scrq = 0;
+        }
+      }
+      if (scrq > 0)
+      {
+        if (CHRG)
+        {
+          //Add charges
+          ofile << "Chrgfield.extern.addCharge(";
+          ofile << LICHEMFormFloat(Struct[i].MP[Bead].q*scrq,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].P[Bead].x+xshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].P[Bead].y+yshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].P[Bead].z+zshft,16);
+          ofile << ")" << '\n';
+        }
+        if (AMOEBA)
+        {
+          //Add multipoles
+          ofile << "Chrgfield.extern.addCharge(";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q1*scrq,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x1+xshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y1+yshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z1+zshft,16);
+          ofile << ")" << '\n';
+          ofile << "Chrgfield.extern.addCharge(";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q2*scrq,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x2+xshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y2+yshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z2+zshft,16);
+          ofile << ")" << '\n';
+          ofile << "Chrgfield.extern.addCharge(";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q3*scrq,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x3+xshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y3+yshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z3+zshft,16);
+          ofile << ")" << '\n';
+          ofile << "Chrgfield.extern.addCharge(";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q4*scrq,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x4+xshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y4+yshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z4+zshft,16);
+          ofile << ")" << '\n';
+          ofile << "Chrgfield.extern.addCharge(";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q5*scrq,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x5+xshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y5+yshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z5+zshft,16);
+          ofile << ")" << '\n';
+          ofile << "Chrgfield.extern.addCharge(";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q6*scrq,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x6+xshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y6+yshft,16) << ",";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z6+zshft,16);
+          ofile << ")" << '\n';
         }
       }
     }
@@ -1014,10 +1022,12 @@ void ExtractGlobalPoles(int& argc, char**& argv)
         Vecz(1) = -1*y; //Correct the direction
         Vecz(2) = -1*z; //Correct the direction
         Vecz.normalize();
-        //Random vector
-        Vecx(0) = 2*((((double)rand())/((double)RAND_MAX))-0.5);
-        Vecx(1) = 2*((((double)rand())/((double)RAND_MAX))-0.5);
-        Vecx(2) = 2*((((double)rand())/((double)RAND_MAX))-0.5);
+        //Random vector (the same vector is used for every call)
+        RandomStream AtomRand; //Random numbers for this atom
+        AtomRand.Seed(RandSeed,0,RandFrames,i);
+        Vecx(0) = 2*(AtomRand.Uniform()-0.5);
+        Vecx(1) = 2*(AtomRand.Uniform()-0.5);
+        Vecx(2) = 2*(AtomRand.Uniform()-0.5);
         Vecx.normalize();
         //Subtract overlap and normalize
         Vecx -= Vecz*(Vecx.dot(Vecz));
@@ -42,11 +42,13 @@ void NWChemCharges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     call << "mpirun -n " << Ncpus << " ";
   }
   call << "nwchem LICHM_" << Bead << ".nw";
-  call << " > LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
-  //Parse output for energy
+  string cmd = call.str(); //Command to run
   call.str("");
   call << "LICHM_" << Bead << ".log";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
+  //Parse output for energy
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
   ifile.open(call.str().c_str(),ios_base::in);
   bool QMfinished = 0;
   while (!ifile.eof())
@@ -70,25 +72,23 @@ void NWChemCharges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   ifile.close();
   //Parse output for charges
   call.str("");
-  call << "LICHM_" << Bead << ".q";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".q";
   ifile.open(call.str().c_str(),ios_base::in);
   if (ifile.good())
   {
     getline(ifile,dummy);
-    for (int i=0;i<Natoms;i++)
+    for (int p=0;p<(Nqm+Npseudo);p++)
     {
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        //Read charges
-        stringstream line;
-        getline(ifile,dummy);
-        line.str(dummy);
-        //Clear junk
-        line >> dummy >> dummy;
-        line >> dummy >> dummy;
-        //Save charge
-        line >> Struct[i].MP[Bead].q;
-      }
+      int i = QMPBList[p]; //Atom ID
+      //Read charges
+      stringstream line;
+      getline(ifile,dummy);
+      line.str(dummy);
+      //Clear junk
+      line >> dummy >> dummy;
+      line >> dummy >> dummy;
+      //Save charge
+      line >> Struct[i].MP[Bead].q;
     }
   }
   ifile.close();
@@ -103,25 +103,24 @@ void NWChemCharges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     cerr.flush(); //Print warning immediately
     //Remove checkpoint file
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".movecs";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".movecs";
+    LICHEMRemoveFiles(call.str());
   }
   //Clean up files and return
   call.str("");
-  call << "rm -f ";
-  call << "LICHM_" << Bead << ".b*" << " ";
-  call << "LICHM_" << Bead << ".c*" << " ";
-  call << "LICHM_" << Bead << ".d*" << " ";
-  call << "LICHM_" << Bead << ".f*" << " ";
-  call << "LICHM_" << Bead << ".g*" << " ";
-  call << "LICHM_" << Bead << ".h*" << " ";
-  call << "LICHM_" << Bead << ".l*" << " ";
-  call << "LICHM_" << Bead << ".n*" << " ";
-  call << "LICHM_" << Bead << ".p*" << " ";
-  call << "LICHM_" << Bead << ".q*" << " ";
-  call << "LICHM_" << Bead << ".x*" << " ";
-  call << "LICHM_" << Bead << ".z*";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".b*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".c*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".d*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".f*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".g*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".h*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".l*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".n*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".p*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".q*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".x*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".z*";
+  LICHEMRemoveFiles(call.str());
   return;
 };
 
@@ -134,11 +133,29 @@ double NWChemEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   stringstream call; //Stream for system calls and reading/writing files
   call.copyfmt(cout); //Copy print settings
   double E = 0.0; //QM energy
+  //Use a saved result for repeated structures
+  uint64_t CacheKey; //Hash of the inputs
+  CacheKey = SavedResults.GetKey("NWChem",Struct,QMMMOpts,Bead,1,0);
+  if (SavedResults.FindEnergy(CacheKey,Struct,Bead,E))
+  {
+    return E;
+  }
   //Write NWChem input
   call.str("");
   call << "task dft energy" << '\n';
   call << "task esp" << '\n';
   WriteNWChemInput(Struct,call.str(),QMMMOpts,Bead);
+  //Use a saved result from an earlier simulation
+  uint64_t StoreKey; //Hash of the QM input
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".nw";
+  StoreKey = QMStore.GetKey(call.str(),Bead);
+  if (QMStore.FindEnergy(StoreKey,Struct,Bead,E))
+  {
+    LICHEMRemoveFiles(call.str());
+    SavedResults.SaveEnergy(CacheKey,Struct,Bead,E);
+    return E;
+  }
   //Run calculation
   call.str("");
   if (Ncpus > 1)
@@ -146,53 +163,45 @@ double NWChemEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     call << "mpirun -n " << Ncpus << " ";
   }
   call << "nwchem LICHM_" << Bead << ".nw";
-  call << " > LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
-  //Parse output for energy
+  string cmd = call.str(); //Command to run
   call.str("");
   call << "LICHM_" << Bead << ".log";
-  ifile.open(call.str().c_str(),ios_base::in);
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
+  //Parse output for energy
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  QMLogFile QMlog; //Output file
+  QMlog.Open(call.str());
+  QMlog.AddMarker("Total DFT energy",1);
+  QMlog.AddMarker("Total SCF energy",1);
   bool QMfinished = 0;
-  while (!ifile.eof())
+  while (QMlog.NextMarker() >= 0)
   {
-    stringstream line;
-    getline(ifile,dummy);
-    line.str(dummy);
-    line >> dummy;
-    //Search for energy
-    if (dummy == "Total")
-    {
-      line >> dummy >> dummy;
-      if (dummy == "energy")
-      {
-        line >> dummy; //Clear junk
-        line >> E; //Read energy
-        QMfinished = 1;
-      }
-    }
+    //Read energy
+    QMlog.SkipWords(1); //Clear junk
+    QMlog.ReadDouble(E);
+    QMfinished = 1;
   }
-  ifile.close();
+  QMlog.Close();
   //Parse output for charges
   call.str("");
-  call << "LICHM_" << Bead << ".q";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".q";
   ifile.open(call.str().c_str(),ios_base::in);
   if (ifile.good())
   {
     getline(ifile,dummy);
-    for (int i=0;i<Natoms;i++)
+    for (int p=0;p<(Nqm+Npseudo);p++)
     {
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        //Read charges
-        stringstream line;
-        getline(ifile,dummy);
-        line.str(dummy);
-        //Clear junk
-        line >> dummy >> dummy;
-        line >> dummy >> dummy;
-        //Save charge
-        line >> Struct[i].MP[Bead].q;
-      }
+      int i = QMPBList[p]; //Atom ID
+      //Read charges
+      stringstream line;
+      getline(ifile,dummy);
+      line.str(dummy);
+      //Clear junk
+      line >> dummy >> dummy;
+      line >> dummy >> dummy;
+      //Save charge
+      line >> Struct[i].MP[Bead].q;
     }
   }
   ifile.close();
@@ -207,46 +216,42 @@ double NWChemEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     cerr.flush(); //Print warning immediately
     //Remove checkpoint file
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".movecs";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".movecs";
+    LICHEMRemoveFiles(call.str());
   }
   //Clean up files
-  call.str("");
   if (CheckFile("BACKUPQM"))
   {
     //Save old files
-    call << "cp LICHM_";
-    call << Bead << ".nw " << QMMMOpts.BackDir << "/.";
-    call << " 2> LICHM_" << Bead << ".trash; ";
-    call << "rm -f LICHM_" << Bead << ".trash";
-    call << "; ";
-    call << "cp LICHM_" << Bead << ".movecs ";
-    call << QMMMOpts.BackDir << "/.";
-    call << " 2> LICHM_" << Bead << ".trash; ";
-    call << "rm -f LICHM_" << Bead << ".trash";
-    call << "; ";
-    call << "cp LICHM_" << Bead << ".log ";
-    call << QMMMOpts.BackDir << "/.";
-    call << " 2> LICHM_" << Bead << ".trash; ";
-    call << "rm -f LICHM_" << Bead << ".trash";
-    call << " "; //Extra blank space before the next command
+    call.str("");
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".nw";
+    LICHEMCopyFile(call.str(),QMMMOpts.BackDir);
+    call.str("");
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".movecs";
+    LICHEMCopyFile(call.str(),QMMMOpts.BackDir);
+    call.str("");
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+    LICHEMCopyFile(call.str(),QMMMOpts.BackDir);
   }
-  call << "rm -f ";
-  call << "LICHM_" << Bead << ".b*" << " ";
-  call << "LICHM_" << Bead << ".c*" << " ";
-  call << "LICHM_" << Bead << ".d*" << " ";
-  call << "LICHM_" << Bead << ".f*" << " ";
-  call << "LICHM_" << Bead << ".g*" << " ";
-  call << "LICHM_" << Bead << ".h*" << " ";
-  call << "LICHM_" << Bead << ".l*" << " ";
-  call << "LICHM_" << Bead << ".n*" << " ";
-  call << "LICHM_" << Bead << ".p*" << " ";
-  call << "LICHM_" << Bead << ".q*" << " ";
-  call << "LICHM_" << Bead << ".x*" << " ";
-  call << "LICHM_" << Bead << ".z*";
-  GlobalSys = system(call.str().c_str());
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".b*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".c*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".d*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".f*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".g*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".h*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".l*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".n*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".p*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".q*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".x*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".z*";
+  LICHEMRemoveFiles(call.str());
   //Change units and return
   E *= Har2eV;
+  //Save the result for repeated structures and later simulations
+  SavedResults.SaveEnergy(CacheKey,Struct,Bead,E);
+  QMStore.SaveEnergy(StoreKey,Struct,Bead,E);
   return E;
 };
 
@@ -259,11 +264,30 @@ double NWChemForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   stringstream call; //Stream for system calls and reading/writing files
   call.copyfmt(cout); //Copy print settings
   double E = 0.0;
+  //Use a saved result for repeated structures
+  uint64_t CacheKey; //Hash of the inputs
+  CacheKey = SavedResults.GetKey("NWChem",Struct,QMMMOpts,Bead,1,0);
+  if (SavedResults.FindForces(CacheKey,Struct,Forces,Bead,E))
+  {
+    return E;
+  }
+  VectorXd OldForces = Forces; //Forces from other wrappers
   //Set up force calculation
   call.str("");
   call << "task dft gradient" << '\n';
   call << "task esp" << '\n';
   WriteNWChemInput(Struct,call.str(),QMMMOpts,Bead);
+  //Use a saved result from an earlier simulation
+  uint64_t StoreKey; //Hash of the QM input
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".nw";
+  StoreKey = QMStore.GetKey(call.str(),Bead);
+  if (QMStore.FindForces(StoreKey,Struct,Forces,Bead,E))
+  {
+    LICHEMRemoveFiles(call.str());
+    SavedResults.SaveForces(CacheKey,Struct,Forces-OldForces,Bead,E);
+    return E;
+  }
   //Run calculation
   call.str("");
   if (Ncpus > 1)
@@ -271,11 +295,13 @@ double NWChemForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
     call << "mpirun -n " << Ncpus << " ";
   }
   call << "nwchem LICHM_" << Bead << ".nw";
-  call << " > LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
-  //Parse output for forces and energies
+  string cmd = call.str(); //Command to run
   call.str("");
   call << "LICHM_" << Bead << ".log";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
+  //Parse output for forces and energies
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
   ifile.open(call.str().c_str(),ios_base::in);
   bool QMfinished = 0;
   bool GradDone = 0;
@@ -332,22 +358,20 @@ double NWChemForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   ifile.close();
   //Parse output for charges
   call.str("");
-  call << "LICHM_" << Bead << ".q";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".q";
   ifile.open(call.str().c_str(),ios_base::in);
   if (ifile.good())
   {
     getline(ifile,dummy);
-    for (int i=0;i<Natoms;i++)
+    for (int p=0;p<(Nqm+Npseudo);p++)
     {
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        stringstream line;
-        getline(ifile,dummy);
-        line.str(dummy);
-        line >> dummy >> dummy;
-        line >> dummy >> dummy;
-        line >> Struct[i].MP[Bead].q;
-      }
+      int i = QMPBList[p]; //Atom ID
+      stringstream line;
+      getline(ifile,dummy);
+      line.str(dummy);
+      line >> dummy >> dummy;
+      line >> dummy >> dummy;
+      line >> Struct[i].MP[Bead].q;
     }
   }
   ifile.close();
@@ -362,8 +386,8 @@ double NWChemForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
     cerr.flush(); //Print warning immediately
     //Remove checkpoint file
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".movecs";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".movecs";
+    LICHEMRemoveFiles(call.str());
   }
   if (!GradDone)
   {
@@ -375,22 +399,24 @@ double NWChemForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   }
   //Clean up files
   call.str("");
-  call << "rm -f ";
-  call << "LICHM_" << Bead << ".b*" << " ";
-  call << "LICHM_" << Bead << ".c*" << " ";
-  call << "LICHM_" << Bead << ".d*" << " ";
-  call << "LICHM_" << Bead << ".f*" << " ";
-  call << "LICHM_" << Bead << ".g*" << " ";
-  call << "LICHM_" << Bead << ".h*" << " ";
-  call << "LICHM_" << Bead << ".l*" << " ";
-  call << "LICHM_" << Bead << ".n*" << " ";
-  call << "LICHM_" << Bead << ".p*" << " ";
-  call << "LICHM_" << Bead << ".q*" << " ";
-  call << "LICHM_" << Bead << ".x*" << " ";
-  call << "LICHM_" << Bead << ".z*";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".b*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".c*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".d*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".f*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".g*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".h*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".l*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".n*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".p*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".q*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".x*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".z*";
+  LICHEMRemoveFiles(call.str());
   //Change units and return
   E *= Har2eV;
+  //Save the result for repeated structures and later simulations
+  SavedResults.SaveForces(CacheKey,Struct,Forces-OldForces,Bead,E);
+  QMStore.SaveForces(StoreKey,Struct,Forces-OldForces,Bead,E);
   return E;
 };
 
@@ -409,6 +435,16 @@ MatrixXd NWChemHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call.str("");
   call << "task dft hessian" << '\n';
   WriteNWChemInput(Struct,call.str(),QMMMOpts,Bead);
+  //Use a saved result from an earlier simulation
+  uint64_t StoreKey; //Hash of the QM input
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".nw";
+  StoreKey = QMStore.GetKey(call.str(),Bead);
+  if (QMStore.FindHessian(StoreKey,QMHess))
+  {
+    LICHEMRemoveFiles(call.str());
+    return QMHess;
+  }
   //Run calculation
   call.str("");
   if (Ncpus > 1)
@@ -416,11 +452,13 @@ MatrixXd NWChemHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     call << "mpirun -n " << Ncpus << " ";
   }
   call << "nwchem LICHM_" << Bead << ".nw";
-  call << " > LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  string cmd = call.str(); //Command to run
+  call.str("");
+  call << "LICHM_" << Bead << ".log";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Parse output for Hessian
   call.str("");
-  call << "LICHM_" << Bead << ".hess";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".hess";
   QMlog.open(call.str().c_str(),ios_base::in);
   bool HessDone = 0;
   if (QMlog.good())
@@ -452,26 +490,30 @@ MatrixXd NWChemHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     cerr.flush(); //Print warning immediately
     //Delete checkpoint
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".movecs";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".movecs";
+    LICHEMRemoveFiles(call.str());
   }
   //Clean up files
   call.str("");
-  call << "rm -f ";
-  call << "LICHM_" << Bead << ".b*" << " ";
-  call << "LICHM_" << Bead << ".c*" << " ";
-  call << "LICHM_" << Bead << ".d*" << " ";
-  call << "LICHM_" << Bead << ".f*" << " ";
-  call << "LICHM_" << Bead << ".g*" << " ";
-  call << "LICHM_" << Bead << ".h*" << " ";
-  call << "LICHM_" << Bead << ".l*" << " ";
-  call << "LICHM_" << Bead << ".n*" << " ";
-  call << "LICHM_" << Bead << ".p*" << " ";
-  call << "LICHM_" << Bead << ".q*" << " ";
-  call << "LICHM_" << Bead << ".x*" << " ";
-  call << "LICHM_" << Bead << ".z*";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".b*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".c*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".d*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".f*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".g*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".h*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".l*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".n*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".p*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".q*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".x*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".z*";
+  LICHEMRemoveFiles(call.str());
   //Return Hessian
+  if (HessDone)
+  {
+    //Save the Hessian for later simulations
+    QMStore.SaveHessian(StoreKey,QMHess);
+  }
   return QMHess;
 };
 
@@ -495,11 +537,13 @@ double NWChemOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
     call << "mpirun -n " << Ncpus << " ";
   }
   call << "nwchem LICHM_" << Bead << ".nw";
-  call << " > LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
-  //Parse output
+  string cmd = call.str(); //Command to run
   call.str("");
   call << "LICHM_" << Bead << ".log";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
+  //Parse output
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
   ifile.open(call.str().c_str(),ios_base::in);
   bool QMfinished = 0;
   while (!ifile.eof())
@@ -523,25 +567,23 @@ double NWChemOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   ifile.close();
   //Parse output for charges
   call.str("");
-  call << "LICHM_" << Bead << ".q";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".q";
   ifile.open(call.str().c_str(),ios_base::in);
   if (ifile.good())
   {
     getline(ifile,dummy);
-    for (int i=0;i<Natoms;i++)
+    for (int p=0;p<(Nqm+Npseudo);p++)
     {
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        //Read charges
-        stringstream line;
-        getline(ifile,dummy);
-        line.str(dummy);
-        //Clear junk
-        line >> dummy >> dummy;
-        line >> dummy >> dummy;
-        //Save charge
-        line >> Struct[i].MP[Bead].q;
-      }
+      int i = QMPBList[p]; //Atom ID
+      //Read charges
+      stringstream line;
+      getline(ifile,dummy);
+      line.str(dummy);
+      //Clear junk
+      line >> dummy >> dummy;
+      line >> dummy >> dummy;
+      //Save charge
+      line >> Struct[i].MP[Bead].q;
     }
   }
   ifile.close();
@@ -556,25 +598,24 @@ double NWChemOpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
     cerr.flush(); //Print warning immediately
     //Remove checkpoint file
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".movecs";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".movecs";
+    LICHEMRemoveFiles(call.str());
   }
   //Clean up files
   call.str("");
-  call << "rm -f ";
-  call << "LICHM_" << Bead << ".b*" << " ";
-  call << "LICHM_" << Bead << ".c*" << " ";
-  call << "LICHM_" << Bead << ".d*" << " ";
-  call << "LICHM_" << Bead << ".f*" << " ";
-  call << "LICHM_" << Bead << ".g*" << " ";
-  call << "LICHM_" << Bead << ".h*" << " ";
-  call << "LICHM_" << Bead << ".l*" << " ";
-  call << "LICHM_" << Bead << ".n*" << " ";
-  call << "LICHM_" << Bead << ".p*" << " ";
-  call << "LICHM_" << Bead << ".q*" << " ";
-  call << "LICHM_" << Bead << ".x*" << " ";
-  call << "LICHM_" << Bead << ".z*";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".b*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".c*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".d*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".f*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".g*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".h*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".l*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".n*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".p*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".q*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".x*" << " ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".z*";
+  LICHEMRemoveFiles(call.str());
   //Change units and return
   E *= Har2eV;
   return E;
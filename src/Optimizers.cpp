@@ -19,6 +19,30 @@
 */
 
 //Convergence test functions
+double DistMatRMSDiff(VectorXd& Xnew, VectorXd& Ynew, VectorXd& Znew,
+                      VectorXd& Xold, VectorXd& Yold, VectorXd& Zold)
+{
+  //Sum of the squared changes in the distance matrix
+  double SumDiff = 0; //Squared deviations
+  int Npts = Xnew.size(); //Number of atoms
+  #pragma omp parallel for schedule(dynamic) reduction(+:SumDiff)
+  for (int i=1;i<Npts;i++)
+  {
+    //Displacements to all atoms j < i
+    VectorXd Dx = Xnew.head(i).array()-Xnew(i);
+    VectorXd Dy = Ynew.head(i).array()-Ynew(i);
+    VectorXd Dz = Znew.head(i).array()-Znew(i);
+    VectorXd Rnew = MinImageDist2(Dx,Dy,Dz).cwiseSqrt();
+    Dx = Xold.head(i).array()-Xold(i);
+    Dy = Yold.head(i).array()-Yold(i);
+    Dz = Zold.head(i).array()-Zold(i);
+    VectorXd Rold = MinImageDist2(Dx,Dy,Dz).cwiseSqrt();
+    //Update sum
+    SumDiff += (Rnew-Rold).squaredNorm();
+  }
+  return SumDiff;
+};
+
 bool OptConverged(vector<QMMMAtom>& Struct, vector<QMMMAtom>& OldStruct,
                   VectorXd& Forces, int stepct, QMMMSettings& QMMMOpts,
                   int Bead, bool QMregion)
@@ -40,32 +64,22 @@ bool OptConverged(vector<QMMMAtom>& Struct, vector<QMMMAtom>& OldStruct,
       MAXforce = abs(Forces.minCoeff());
     }
     RMSforce = sqrt(Forces.squaredNorm()/Ndof);
-    #pragma omp parallel for schedule(dynamic) reduction(+:RMSdiff)
-    for (int i=0;i<Natoms;i++)
-    {
-      //Calculate QM-QM distance matrix
-      double RMStmp = 0; //Store a local sum
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        for (int j=0;j<i;j++)
-        {
-          if (Struct[j].QMregion or Struct[j].PBregion)
-          {
-            double Rnew = 0;
-            double Rold = 0;
-            Rnew = CoordDist2(Struct[i].P[Bead],Struct[j].P[Bead]).VecMag();
-            Rold = CoordDist2(OldStruct[i].P[Bead],
-                              OldStruct[j].P[Bead]).VecMag();
-            Rnew = sqrt(Rnew);
-            Rold = sqrt(Rold);
-            //Update local sum
-            RMStmp += (Rnew-Rold)*(Rnew-Rold);
-          }
-        }
-      }
-      //Update sum
-      RMSdiff += RMStmp;
-    }
+    //Collect QM and PB coordinates
+    int Nact = Nqm+Npseudo; //Number of QM and PB atoms
+    VectorXd Xnew(Nact),Ynew(Nact),Znew(Nact); //Current positions
+    VectorXd Xold(Nact),Yold(Nact),Zold(Nact); //Previous positions
+    for (int p=0;p<(Nqm+Npseudo);p++)
+    {
+      int i = QMPBList[p]; //Atom ID
+      Xnew(p) = Struct[i].P[Bead].x;
+      Ynew(p) = Struct[i].P[Bead].y;
+      Znew(p) = Struct[i].P[Bead].z;
+      Xold(p) = OldStruct[i].P[Bead].x;
+      Yold(p) = OldStruct[i].P[Bead].y;
+      Zold(p) = OldStruct[i].P[Bead].z;
+    }
+    //Calculate QM-QM distance matrix
+    RMSdiff = DistMatRMSDiff(Xnew,Ynew,Znew,Xold,Yold,Zold);
     RMSdiff /= (Nqm+Npseudo)*(Nqm+Npseudo-1)/2;
     RMSdiff = sqrt(RMSdiff);
     //Print progress
@@ -103,7 +117,7 @@ bool OptConverged(vector<QMMMAtom>& Struct, vector<QMMMAtom>& OldStruct,
       SumE += PSI4Energy(Struct,QMMMOpts,Bead);
       QMTime += (unsigned)time(0)-tstart;
       //Delete annoying useless files
-      GlobalSys = system("rm -f psi.* timer.*");
+      PSI4Cleanup(Bead);
     }
     if (NWChem)
     {
@@ -130,27 +144,93 @@ bool OptConverged(vector<QMMMAtom>& Struct, vector<QMMMAtom>& OldStruct,
       SumE += LAMMPSEnergy(Struct,QMMMOpts,Bead);
       MMTime += (unsigned)time(0)-tstart;
     }
-    //Calculate RMS displacement (distance matrix)
-    #pragma omp parallel for schedule(dynamic) reduction(+:RMSdiff)
-    for (int i=0;i<Natoms;i++)
+    //Calculate RMS displacement
+    double QMRMSdiff = 0; //RMS deviation of the QM-QM distance matrix
+    if (QMMMOpts.OptMetric == "DistMat")
     {
-      double RMStmp = 0; //Store a local sum
-      for (int j=0;j<i;j++)
+      //Compare the full distance matrix
+      VectorXd Xnew(Natoms),Ynew(Natoms),Znew(Natoms); //Current positions
+      VectorXd Xold(Natoms),Yold(Natoms),Zold(Natoms); //Previous positions
+      for (int i=0;i<Natoms;i++)
+      {
+        Xnew(i) = Struct[i].P[Bead].x;
+        Ynew(i) = Struct[i].P[Bead].y;
+        Znew(i) = Struct[i].P[Bead].z;
+        Xold(i) = OldStruct[i].P[Bead].x;
+        Yold(i) = OldStruct[i].P[Bead].y;
+        Zold(i) = OldStruct[i].P[Bead].z;
+      }
+      RMSdiff = DistMatRMSDiff(Xnew,Ynew,Znew,Xold,Yold,Zold);
+      int Npairs = (Natoms-Nfreeze)*(Natoms-Nfreeze-1)/2; //Active pairs
+      if (Npairs > 0)
       {
-        double Rnew = 0;
-        double Rold = 0;
-        Rnew = CoordDist2(Struct[i].P[Bead],Struct[j].P[Bead]).VecMag();
-        Rold = CoordDist2(OldStruct[i].P[Bead],OldStruct[j].P[Bead]).VecMag();
-        Rnew = sqrt(Rnew);
-        Rold = sqrt(Rold);
-        //Update local sum
-        RMStmp += (Rnew-Rold)*(Rnew-Rold);
+        RMSdiff /= Npairs;
       }
-      //Update sum
-      RMSdiff += RMStmp;
+      RMSdiff = sqrt(RMSdiff);
+    }
+    else
+    {
+      //Compare the positions of the active atoms
+      int Nact = Natoms-Nfreeze; //Number of active atoms
+      VectorXd Dx(Nact),Dy(Nact),Dz(Nact); //Displacements
+      for (int p=0;p<Nact;p++)
+      {
+        int i = ActiveList[p]; //Atom ID
+        Dx(p) = Struct[i].P[Bead].x-OldStruct[i].P[Bead].x;
+        Dy(p) = Struct[i].P[Bead].y-OldStruct[i].P[Bead].y;
+        Dz(p) = Struct[i].P[Bead].z-OldStruct[i].P[Bead].z;
+      }
+      //Remove jumps across the periodic box
+      RMSdiff = MinImageDist2(Dx,Dy,Dz).sum();
+      if ((QMMMOpts.OptMetric == "Kabsch") and (Nact > 0))
+      {
+        //Remove overall translation and rotation
+        MatrixXd Anew(Nact,3); //Unwrapped current positions
+        MatrixXd Aold(Nact,3); //Previous positions
+        for (int p=0;p<Nact;p++)
+        {
+          int i = ActiveList[p]; //Atom ID
+          Aold(p,0) = OldStruct[i].P[Bead].x;
+          Aold(p,1) = OldStruct[i].P[Bead].y;
+          Aold(p,2) = OldStruct[i].P[Bead].z;
+          Anew(p,0) = Aold(p,0)+Dx(p);
+          Anew(p,1) = Aold(p,1)+Dy(p);
+          Anew(p,2) = Aold(p,2)+Dz(p);
+        }
+        RMSdiff = KabschDisplacement(Anew,Aold,Nact).squaredNorm();
+      }
+      if (Nact > 0)
+      {
+        //Avoid dividing by zero when every atom is frozen
+        RMSdiff /= Nact;
+      }
+      RMSdiff = sqrt(RMSdiff);
+      //Use the pairwise test only for the QM region
+      int Nqmpb = Nqm+Npseudo; //Number of QM and PB atoms
+      if (Nqmpb > 1)
+      {
+        VectorXd Xnew(Nqmpb),Ynew(Nqmpb),Znew(Nqmpb); //Current positions
+        VectorXd Xold(Nqmpb),Yold(Nqmpb),Zold(Nqmpb); //Previous positions
+        for (int p=0;p<(Nqm+Npseudo);p++)
+        {
+          int i = QMPBList[p]; //Atom ID
+          Xnew(p) = Struct[i].P[Bead].x;
+          Ynew(p) = Struct[i].P[Bead].y;
+          Znew(p) = Struct[i].P[Bead].z;
+          Xold(p) = OldStruct[i].P[Bead].x;
+          Yold(p) = OldStruct[i].P[Bead].y;
+          Zold(p) = OldStruct[i].P[Bead].z;
+        }
+        QMRMSdiff = DistMatRMSDiff(Xnew,Ynew,Znew,Xold,Yold,Zold);
+        QMRMSdiff /= Nqmpb*(Nqmpb-1)/2;
+        QMRMSdiff = sqrt(QMRMSdiff);
+      }
+    }
+    if (QMRMSdiff > RMSdiff)
+    {
+      //Use the largest deviation
+      RMSdiff = QMRMSdiff;
     }
-    RMSdiff /= (Natoms-Nfreeze)*(Natoms-Nfreeze-1)/2;
-    RMSdiff = sqrt(RMSdiff);
     //Print progress
     cout << " | Opt. step: ";
     cout << stepct << " | Energy: ";
@@ -219,7 +299,7 @@ void LICHEMSteepest(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
       E += PSI4Forces(Struct,Forces,QMMMOpts,Bead);
       QMTime += (unsigned)time(0)-tstart;
       //Delete annoying useless files
-      GlobalSys = system("rm -f psi.* timer.*");
+      PSI4Cleanup(Bead);
     }
     if (NWChem)
     {
@@ -282,16 +362,14 @@ void LICHEMSteepest(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     }
     //Determine new structure
     int ct = 0; //Counter
-    for (int i=0;i<Natoms;i++)
+    for (int p=0;p<(Nqm+Npseudo);p++)
     {
       //Move QM atoms
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        Struct[i].P[Bead].x += stepsize*Forces(ct);
-        Struct[i].P[Bead].y += stepsize*Forces(ct+1);
-        Struct[i].P[Bead].z += stepsize*Forces(ct+2);
-        ct += 3;
-      }
+      int i = QMPBList[p]; //Atom ID
+      Struct[i].P[Bead].x += stepsize*Forces(ct);
+      Struct[i].P[Bead].y += stepsize*Forces(ct+1);
+      Struct[i].P[Bead].z += stepsize*Forces(ct+2);
+      ct += 3;
     }
     //Print structure
     Print_traj(Struct,qmfile,QMMMOpts);
@@ -308,9 +386,9 @@ void LICHEMSteepest(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   }
   //Clean up files
   call.str("");
-  call << "rm -f QMOpt_" << Bead << ".xyz";
-  call << " MMCharges_" << Bead << ".txt";
-  GlobalSys = system(call.str().c_str());
+  call << "QMOpt_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "MMCharges_" << Bead << ".txt";
+  LICHEMRemoveFiles(call.str());
   //Finish and return
   return;
 };
@@ -362,7 +440,7 @@ void LICHEMQuickMin(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
       E += PSI4Forces(Struct,Forces,QMMMOpts,Bead);
       QMTime += (unsigned)time(0)-tstart;
       //Delete annoying useless files
-      GlobalSys = system("rm -f psi.* timer.*");
+      PSI4Cleanup(Bead);
     }
     if (NWChem)
     {
@@ -440,16 +518,14 @@ void LICHEMQuickMin(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     cout << '\n'; //Print a black line after printing the update method
     //Determine new structure
     int ct = 0; //Counter
-    for (int i=0;i<Natoms;i++)
+    for (int p=0;p<(Nqm+Npseudo);p++)
     {
       //Move QM atoms
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        Struct[i].P[Bead].x += TimeStep*QMVel(ct);
-        Struct[i].P[Bead].y += TimeStep*QMVel(ct+1);
-        Struct[i].P[Bead].z += TimeStep*QMVel(ct+2);
-        ct += 3;
-      }
+      int i = QMPBList[p]; //Atom ID
+      Struct[i].P[Bead].x += TimeStep*QMVel(ct);
+      Struct[i].P[Bead].y += TimeStep*QMVel(ct+1);
+      Struct[i].P[Bead].z += TimeStep*QMVel(ct+2);
+      ct += 3;
     }
     //Print structure
     Print_traj(Struct,qmfile,QMMMOpts);
@@ -461,9 +537,9 @@ void LICHEMQuickMin(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   }
   //Clean up files
   call.str("");
-  call << "rm -f QMOpt_" << Bead << ".xyz";
-  call << " MMCharges_" << Bead << ".txt";
-  GlobalSys = system(call.str().c_str());
+  call << "QMOpt_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "MMCharges_" << Bead << ".txt";
+  LICHEMRemoveFiles(call.str());
   //Finish and return
   return;
 };
@@ -517,7 +593,7 @@ void LICHEMDFP(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
     E += PSI4Forces(Struct,Forces,QMMMOpts,Bead);
     QMTime += (unsigned)time(0)-tstart;
     //Delete annoying useless files
-    GlobalSys = system("rm -f psi.* timer.*");
+    PSI4Cleanup(Bead);
   }
   if (NWChem)
   {
@@ -586,16 +662,14 @@ void LICHEMDFP(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
     }
     //Update positions
     int ct = 0; //Counter
-    for (int i=0;i<Natoms;i++)
+    for (int p=0;p<(Nqm+Npseudo);p++)
     {
       //Move QM atoms
-      if (Struct[i].QMregion or Struct[i].PBregion)
-      {
-        Struct[i].P[Bead].x += OptVec(ct);
-        Struct[i].P[Bead].y += OptVec(ct+1);
-        Struct[i].P[Bead].z += OptVec(ct+2);
-        ct += 3;
-      }
+      int i = QMPBList[p]; //Atom ID
+      Struct[i].P[Bead].x += OptVec(ct);
+      Struct[i].P[Bead].y += OptVec(ct+1);
+      Struct[i].P[Bead].z += OptVec(ct+2);
+      ct += 3;
     }
     //Print structure
     Print_traj(Struct,qmfile,QMMMOpts);
@@ -613,7 +687,7 @@ void LICHEMDFP(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
       E += PSI4Forces(Struct,Forces,QMMMOpts,Bead);
       QMTime += (unsigned)time(0)-tstart;
       //Delete annoying useless files
-      GlobalSys = system("rm -f psi.* timer.*");
+      PSI4Cleanup(Bead);
     }
     if (NWChem)
     {
@@ -758,9 +832,9 @@ void LICHEMDFP(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   }
   //Clean up files
   call.str("");
-  call << "rm -f QMOpt_" << Bead << ".xyz";
-  call << " MMCharges_" << Bead << ".txt";
-  GlobalSys = system(call.str().c_str());
+  call << "QMOpt_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "MMCharges_" << Bead << ".txt";
+  LICHEMRemoveFiles(call.str());
   //Finish and return
   return;
 };
@@ -811,7 +885,7 @@ void EnsembleSD(vector<QMMMAtom>& Struct, fstream& traj,
       SumE += PSI4Forces(Struct,Forces,QMMMOpts,Bead);
       QMTime += (unsigned)time(0)-tstart;
       //Delete annoying useless files
-      GlobalSys = system("rm -f psi.* timer.*");
+      PSI4Cleanup(Bead);
     }
     if (NWChem)
     {
@@ -848,37 +922,35 @@ void EnsembleSD(vector<QMMMAtom>& Struct, fstream& traj,
     }
     //Determine new structure
     int ct = 0; //Counter for QM and PB atoms
-    for (int i=0;i<Natoms;i++)
+    for (int p=0;p<(Nqm+Npseudo);p++)
     {
       //Move QM atoms
-      if (Struct[i].QMregion or Struct[i].PBregion)
+      int i = QMPBList[p]; //Atom ID
+      //Check X step size
+      stepsize = StepScale*Forces(ct);
+      if (abs(stepsize) > QMMMOpts.MaxStep)
       {
-        //Check X step size
-        stepsize = StepScale*Forces(ct);
-        if (abs(stepsize) > QMMMOpts.MaxStep)
-        {
-          //Scale step
-          stepsize *= QMMMOpts.MaxStep/abs(stepsize);
-        }
-        Struct[i].P[Bead].x += stepsize;
-        //Check Y step size
-        stepsize = StepScale*Forces(ct+1);
-        if (abs(stepsize) > QMMMOpts.MaxStep)
-        {
-          //Scale step
-          stepsize *= QMMMOpts.MaxStep/abs(stepsize);
-        }
-        Struct[i].P[Bead].y += stepsize;
-        //Check Z step size
-        stepsize = StepScale*Forces(ct+2);
-        if (abs(stepsize) > QMMMOpts.MaxStep)
-        {
-          //Scale step
-          stepsize *= QMMMOpts.MaxStep/abs(stepsize);
-        }
-        Struct[i].P[Bead].z += stepsize;
-        ct += 3;
+        //Scale step
+        stepsize *= QMMMOpts.MaxStep/abs(stepsize);
+      }
+      Struct[i].P[Bead].x += stepsize;
+      //Check Y step size
+      stepsize = StepScale*Forces(ct+1);
+      if (abs(stepsize) > QMMMOpts.MaxStep)
+      {
+        //Scale step
+        stepsize *= QMMMOpts.MaxStep/abs(stepsize);
+      }
+      Struct[i].P[Bead].y += stepsize;
+      //Check Z step size
+      stepsize = StepScale*Forces(ct+2);
+      if (abs(stepsize) > QMMMOpts.MaxStep)
+      {
+        //Scale step
+        stepsize *= QMMMOpts.MaxStep/abs(stepsize);
       }
+      Struct[i].P[Bead].z += stepsize;
+      ct += 3;
     }
     //Print structure and energy
     stepct += 1;
@@ -892,8 +964,8 @@ void EnsembleSD(vector<QMMMAtom>& Struct, fstream& traj,
   }
   //Clean up files and return
   call.str("");
-  call << "rm -f LICHM_" << Bead << ".dyn";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dyn";
+  LICHEMRemoveFiles(call.str());
   return;
 };
 
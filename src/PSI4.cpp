@@ -17,6 +17,16 @@
 */
 
 //QM utility functions
+void PSI4Cleanup(int Bead)
+{
+  //Function to delete the PSI4 scratch and timer files of a bead
+  stringstream call; //List of files
+  call.str("");
+  call << LICHEMJobDir(Bead) << "psi.* ";
+  call << LICHEMJobDir(Bead) << "timer.*";
+  LICHEMRemoveFiles(call.str());
+  return;
+};
 
 //QM wrapper functions
 void PSI4Charges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
@@ -29,7 +39,7 @@ void PSI4Charges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   //Check if there is a checkpoint file
   bool UseCheckPoint;
   call.str("");
-  call << "LICHM_" << Bead << ".180";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".180";
   UseCheckPoint = CheckFile(call.str());
   //Set up charge calculation
   call.str("");
@@ -48,21 +58,23 @@ void PSI4Charges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   WritePSI4Input(Struct,call.str(),QMMMOpts,Bead);
   //Call PSI4
   call.str("");
-  call << "psi4 -n " << Ncpus << "-i ";
+  call << "psi4 -n " << Ncpus << " -i ";
   call << "LICHM_" << Bead << ".dat -o ";
-  call << "LICHM_" << Bead << ".out > ";
+  call << "LICHM_" << Bead << ".out";
+  string cmd = call.str(); //Command to run
+  call.str("");
   call << "LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Save checkpoint file for the next calculation
   call.str("");
-  call << "mv *.LICHM_" << Bead << ".180 ";
-  call << "LICHM_" << Bead << ".180 ";
-  call << "2> LICHM_" << Bead << ".trash; ";
-  call << "rm -f LICHM_" << Bead << ".trash";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "*.LICHM_" << Bead << ".180";
+  dummy = call.str(); //PSI4 adds a process ID to the file name
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".180";
+  LICHEMMoveFile(dummy,call.str());
   //Extract charges
   call.str("");
-  call << "LICHM_" << Bead << ".out";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out";
   ifile.open(call.str().c_str(),ios_base::in);
   while (!ifile.eof())
   {
@@ -75,17 +87,15 @@ void PSI4Charges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
       if (dummy == "Charges:")
       {
         getline(ifile,dummy);
-        for (int i=0;i<Natoms;i++)
+        for (int p=0;p<(Nqm+Npseudo);p++)
         {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> dummy >> dummy;
-            line >> dummy;
-            line >> Struct[i].MP[Bead].q;
-          }
+          int i = QMPBList[p]; //Atom ID
+          getline(ifile,dummy);
+          stringstream line(dummy);
+          line >> dummy >> dummy;
+          line >> dummy >> dummy;
+          line >> dummy;
+          line >> Struct[i].MP[Bead].q;
         }
       }
     }
@@ -93,11 +103,10 @@ void PSI4Charges(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   ifile.close();
   //Clean up files
   call.str("");
-  call << "rm -f ";
-  call << "LICHM_" << Bead << ".dat ";
-  call << "LICHM_" << Bead << ".out ";
-  call << "LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dat ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  LICHEMRemoveFiles(call.str());
   return;
 };
 
@@ -109,10 +118,17 @@ double PSI4Energy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   stringstream call; //Stream for system calls and reading/writing files
   call.copyfmt(cout); //Copy settings from cout
   double E = 0.0;
+  //Use a saved result for repeated structures
+  uint64_t CacheKey; //Hash of the inputs
+  CacheKey = SavedResults.GetKey("PSI4",Struct,QMMMOpts,Bead,1,0);
+  if (SavedResults.FindEnergy(CacheKey,Struct,Bead,E))
+  {
+    return E;
+  }
   //Check if there is a checkpoint file
   bool UseCheckPoint;
   call.str("");
-  call << "LICHM_" << Bead << ".180";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".180";
   UseCheckPoint = CheckFile(call.str());
   //Set up energy calculation
   call.str("");
@@ -130,79 +146,75 @@ double PSI4Energy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
     call << "oeprop(qmwfn,'MULLIKEN_CHARGES')" << '\n';
   }
   WritePSI4Input(Struct,call.str(),QMMMOpts,Bead);
+  //Use a saved result from an earlier simulation
+  uint64_t StoreKey; //Hash of the QM input
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dat";
+  StoreKey = QMStore.GetKey(call.str(),Bead);
+  if (QMStore.FindEnergy(StoreKey,Struct,Bead,E))
+  {
+    LICHEMRemoveFiles(call.str());
+    SavedResults.SaveEnergy(CacheKey,Struct,Bead,E);
+    return E;
+  }
   //Call PSI4
   call.str("");
-  call << "psi4 -n " << Ncpus << "-i ";
+  call << "psi4 -n " << Ncpus << " -i ";
   call << "LICHM_" << Bead << ".dat -o ";
-  call << "LICHM_" << Bead << ".out > ";
+  call << "LICHM_" << Bead << ".out";
+  string cmd = call.str(); //Command to run
+  call.str("");
   call << "LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Save checkpoint file for the next calculation
   call.str("");
-  call << "mv *.LICHM_" << Bead << ".180 ";
-  call << "LICHM_" << Bead << ".180 ";
-  call << "2> LICHM_" << Bead << ".trash; ";
-  call << "rm -f LICHM_" << Bead << ".trash";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "*.LICHM_" << Bead << ".180";
+  dummy = call.str(); //PSI4 adds a process ID to the file name
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".180";
+  LICHEMMoveFile(dummy,call.str());
   //Read energy
   call.str("");
-  call << "LICHM_" << Bead << ".out";
-  ifile.open(call.str().c_str(),ios_base::in);
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out";
+  QMLogFile QMlog; //Output file
+  QMlog.Open(call.str());
+  QMlog.AddMarker("Mulliken Charges:",1);
+  QMlog.AddMarker("Final Energy:",0);
   bool QMfinished = 0;
-  while (!ifile.eof())
+  int Section = QMlog.NextMarker(); //Marker which was found
+  while (Section >= 0)
   {
-    getline(ifile,dummy);
-    stringstream line(dummy);
-    line >> dummy;
-    if (dummy == "Mulliken")
+    if (Section == 0)
     {
-      line >> dummy;
-      if (dummy == "Charges:")
+      QMlog.NextLine(); //Clear junk
+      QMlog.NextLine(); //Ditto
+      for (int p=0;p<(Nqm+Npseudo);p++)
       {
-        getline(ifile,dummy);
-        for (int i=0;i<Natoms;i++)
-        {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> dummy >> dummy;
-            line >> dummy;
-            line >> Struct[i].MP[Bead].q;
-          }
-        }
+        int i = QMPBList[p]; //Atom ID
+        QMlog.SkipWords(5); //Clear junk
+        QMlog.ReadDouble(Struct[i].MP[Bead].q);
+        QMlog.NextLine();
       }
     }
-    line >> dummy; //Get rid of junk
-    if (dummy == "Final")
+    if (Section == 1)
     {
-      line >> dummy; //Check property
-      if (dummy == "Energy:")
-      {
-        //Read energy
-        line >> E; //Read energy
-        QMfinished = 1;
-      }
+      //Read energy
+      QMlog.ReadDouble(E);
+      QMfinished = 1;
     }
+    Section = QMlog.NextMarker();
   }
-  ifile.close();
   //Collect energy (post-SCF)
   call.str("");
-  call << "LICHM_" << Bead << ".log";
-  ifile.open(call.str().c_str(),ios_base::in);
-  while (!ifile.eof())
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  QMlog.Open(call.str());
+  QMlog.AddMarker("Energy:",1);
+  while (QMlog.NextMarker() >= 0)
   {
-    getline(ifile,dummy);
-    stringstream line(dummy);
-    line >> dummy;
-    if (dummy == "Energy:")
-    {
-      line >> E; //Read post-SCF energy
-      QMfinished = 1;
-    }
+    QMlog.ReadDouble(E); //Read post-SCF energy
+    QMfinished = 1;
   }
-  ifile.close();
+  QMlog.Close();
   //Check for errors
   if (!QMfinished)
   {
@@ -214,27 +226,27 @@ double PSI4Energy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
     cerr.flush(); //Print warning immediately
     //Delete checkpoint
     call.str("");
-    call << "rm -f *LICHM_" << Bead << ".180";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "*LICHM_" << Bead << ".180";
+    LICHEMRemoveFiles(call.str());
   }
   //Clean up files
-  call.str("");
   if (CheckFile("BACKUPQM"))
   {
     //Save old files
-    call << "cp LICHM_" << Bead << ".* ";
-    call << QMMMOpts.BackDir << "/.";
-    call << " 2> LICHM_" << Bead << ".trash; ";
-    call << "rm -f LICHM_" << Bead << ".trash";
-    call << " "; //Extra blank space before the next command
+    call.str("");
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".*";
+    LICHEMCopyFile(call.str(),QMMMOpts.BackDir);
   }
-  call << "rm -f ";
-  call << "LICHM_" << Bead << ".dat ";
-  call << "LICHM_" << Bead << ".out ";
-  call << "LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dat ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  LICHEMRemoveFiles(call.str());
   //Change units
   E *= Har2eV;
+  //Save the result for repeated structures and later simulations
+  SavedResults.SaveEnergy(CacheKey,Struct,Bead,E);
+  QMStore.SaveEnergy(StoreKey,Struct,Bead,E);
   return E;
 };
 
@@ -247,10 +259,18 @@ double PSI4Forces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   stringstream call; //Stream for system calls and reading/writing files
   call.copyfmt(cout); //Copy settings from cout
   double E = 0;
+  //Use a saved result for repeated structures
+  uint64_t CacheKey; //Hash of the inputs
+  CacheKey = SavedResults.GetKey("PSI4",Struct,QMMMOpts,Bead,1,0);
+  if (SavedResults.FindForces(CacheKey,Struct,Forces,Bead,E))
+  {
+    return E;
+  }
+  VectorXd OldForces = Forces; //Forces from other wrappers
   //Check if there is a checkpoint file
   bool UseCheckPoint;
   call.str("");
-  call << "LICHM_" << Bead << ".180";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".180";
   UseCheckPoint = CheckFile(call.str());
   //Set up force calculation
   call.str("");
@@ -271,23 +291,36 @@ double PSI4Forces(vector<QMMMAtom>& Struct, VectorXd& Forces,
     call << "oeprop(qmwfn,'MULLIKEN_CHARGES')" << '\n';
   }
   WritePSI4Input(Struct,call.str(),QMMMOpts,Bead);
+  //Use a saved result from an earlier simulation
+  uint64_t StoreKey; //Hash of the QM input
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dat";
+  StoreKey = QMStore.GetKey(call.str(),Bead);
+  if (QMStore.FindForces(StoreKey,Struct,Forces,Bead,E))
+  {
+    LICHEMRemoveFiles(call.str());
+    SavedResults.SaveForces(CacheKey,Struct,Forces-OldForces,Bead,E);
+    return E;
+  }
   //Call PSI4
   call.str("");
-  call << "psi4 -n " << Ncpus << "-i ";
+  call << "psi4 -n " << Ncpus << " -i ";
   call << "LICHM_" << Bead << ".dat -o ";
-  call << "LICHM_" << Bead << ".out > ";
+  call << "LICHM_" << Bead << ".out";
+  string cmd = call.str(); //Command to run
+  call.str("");
   call << "LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Save checkpoint file for the next calculation
   call.str("");
-  call << "mv *.LICHM_" << Bead << ".180 ";
-  call << "LICHM_" << Bead << ".180 ";
-  call << "2> LICHM_" << Bead << ".trash; ";
-  call << "rm -f LICHM_" << Bead << ".trash";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "*.LICHM_" << Bead << ".180";
+  dummy = call.str(); //PSI4 adds a process ID to the file name
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".180";
+  LICHEMMoveFile(dummy,call.str());
   //Extract forces
   call.str("");
-  call << "LICHM_" << Bead << ".out";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out";
   ifile.open(call.str().c_str(),ios_base::in);
   while (!ifile.eof())
   {
@@ -300,17 +333,15 @@ double PSI4Forces(vector<QMMMAtom>& Struct, VectorXd& Forces,
       if (dummy == "Charges:")
       {
         getline(ifile,dummy);
-        for (int i=0;i<Natoms;i++)
+        for (int p=0;p<(Nqm+Npseudo);p++)
         {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> dummy >> dummy;
-            line >> dummy;
-            line >> Struct[i].MP[Bead].q;
-          }
+          int i = QMPBList[p]; //Atom ID
+          getline(ifile,dummy);
+          stringstream line(dummy);
+          line >> dummy >> dummy;
+          line >> dummy >> dummy;
+          line >> dummy;
+          line >> Struct[i].MP[Bead].q;
         }
       }
     }
@@ -357,7 +388,7 @@ double PSI4Forces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   ifile.close();
   //Collect energy (post-SCF)
   call.str("");
-  call << "LICHM_" << Bead << ".log";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
   ifile.open(call.str().c_str(),ios_base::in);
   while (!ifile.eof())
   {
@@ -372,13 +403,15 @@ double PSI4Forces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   ifile.close();
   //Clean up files
   call.str("");
-  call << "rm -f ";
-  call << "LICHM_" << Bead << ".dat ";
-  call << "LICHM_" << Bead << ".out ";
-  call << "LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dat ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  LICHEMRemoveFiles(call.str());
   //Change units
   E *= Har2eV;
+  //Save the result for repeated structures and later simulations
+  SavedResults.SaveForces(CacheKey,Struct,Forces-OldForces,Bead,E);
+  QMStore.SaveForces(StoreKey,Struct,Forces-OldForces,Bead,E);
   return E;
 };
 
@@ -395,7 +428,7 @@ MatrixXd PSI4Hessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   //Check if there is a checkpoint file
   bool UseCheckPoint;
   call.str("");
-  call << "LICHM_" << Bead << ".180";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".180";
   UseCheckPoint = CheckFile(call.str());
   //Calculate Hessian
   call.str("");
@@ -417,23 +450,35 @@ MatrixXd PSI4Hessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
     call << "oeprop(qmwfn,'MULLIKEN_CHARGES')" << '\n';
   }
   WritePSI4Input(Struct,call.str(),QMMMOpts,Bead);
+  //Use a saved result from an earlier simulation
+  uint64_t StoreKey; //Hash of the QM input
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dat";
+  StoreKey = QMStore.GetKey(call.str(),Bead);
+  if (QMStore.FindHessian(StoreKey,QMHess))
+  {
+    LICHEMRemoveFiles(call.str());
+    return QMHess;
+  }
   //Call PSI4
   call.str("");
-  call << "psi4 -n " << Ncpus << "-i ";
+  call << "psi4 -n " << Ncpus << " -i ";
   call << "LICHM_" << Bead << ".dat -o ";
-  call << "LICHM_" << Bead << ".out > ";
+  call << "LICHM_" << Bead << ".out";
+  string cmd = call.str(); //Command to run
+  call.str("");
   call << "LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Save checkpoint file for the next calculation
   call.str("");
-  call << "mv *.LICHM_" << Bead << ".180 ";
-  call << "LICHM_" << Bead << ".180 ";
-  call << "2> LICHM_" << Bead << ".trash; ";
-  call << "rm -f LICHM_" << Bead << ".trash";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "*.LICHM_" << Bead << ".180";
+  dummy = call.str(); //PSI4 adds a process ID to the file name
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".180";
+  LICHEMMoveFile(dummy,call.str());
   //Extract Hessian
   call.str("");
-  call << "LICHM_" << Bead << ".out";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out";
   ifile.open(call.str().c_str(),ios_base::in);
   bool HessDone = 0;
   while (!ifile.eof())
@@ -447,17 +492,15 @@ MatrixXd PSI4Hessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
       if (dummy == "Charges:")
       {
         getline(ifile,dummy);
-        for (int i=0;i<Natoms;i++)
+        for (int p=0;p<(Nqm+Npseudo);p++)
         {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> dummy >> dummy;
-            line >> dummy;
-            line >> Struct[i].MP[Bead].q;
-          }
+          int i = QMPBList[p]; //Atom ID
+          getline(ifile,dummy);
+          stringstream line(dummy);
+          line >> dummy >> dummy;
+          line >> dummy >> dummy;
+          line >> dummy;
+          line >> Struct[i].MP[Bead].q;
         }
       }
     }
@@ -501,16 +544,20 @@ MatrixXd PSI4Hessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
     cerr.flush(); //Print warning immediately
     //Delete checkpoint
     call.str("");
-    call << "rm -f LICHM_" << Bead << ".180";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".180";
+    LICHEMRemoveFiles(call.str());
   }
   //Clean up files
   call.str("");
-  call << "rm -f ";
-  call << "LICHM_" << Bead << ".dat ";
-  call << "LICHM_" << Bead << ".out ";
-  call << "LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dat ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  LICHEMRemoveFiles(call.str());
+  if (HessDone)
+  {
+    //Save the Hessian for later simulations
+    QMStore.SaveHessian(StoreKey,QMHess);
+  }
   return QMHess;
 };
 
@@ -537,21 +584,23 @@ double PSI4Opt(vector<QMMMAtom>& Struct,
   WritePSI4Input(Struct,call.str(),QMMMOpts,Bead);
   //Call PSI4
   call.str("");
-  call << "psi4 -n " << Ncpus << "-i ";
+  call << "psi4 -n " << Ncpus << " -i ";
   call << "LICHM_" << Bead << ".dat -o ";
-  call << "LICHM_" << Bead << ".out > ";
+  call << "LICHM_" << Bead << ".out";
+  string cmd = call.str(); //Command to run
+  call.str("");
   call << "LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Save checkpoint file for the next calculation
   call.str("");
-  call << "mv *.LICHM_" << Bead << ".180 ";
-  call << "LICHM_" << Bead << ".180 ";
-  call << "2> LICHM_" << Bead << ".trash; ";
-  call << "rm -f LICHM_" << Bead << ".trash";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "*.LICHM_" << Bead << ".180";
+  dummy = call.str(); //PSI4 adds a process ID to the file name
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".180";
+  LICHEMMoveFile(dummy,call.str());
   //Read energy and structure
   call.str("");
-  call << "LICHM_" << Bead << ".out";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out";
   ifile.open(call.str().c_str(),ios_base::in);
   bool QMfinished = 0;
   bool Optfinished = 0;
@@ -591,17 +640,15 @@ double PSI4Opt(vector<QMMMAtom>& Struct,
       if (dummy == "Charges:")
       {
         getline(ifile,dummy);
-        for (int i=0;i<Natoms;i++)
+        for (int p=0;p<(Nqm+Npseudo);p++)
         {
-          if (Struct[i].QMregion or Struct[i].PBregion)
-          {
-            getline(ifile,dummy);
-            stringstream line(dummy);
-            line >> dummy >> dummy;
-            line >> dummy >> dummy;
-            line >> dummy;
-            line >> Struct[i].MP[Bead].q;
-          }
+          int i = QMPBList[p]; //Atom ID
+          getline(ifile,dummy);
+          stringstream line(dummy);
+          line >> dummy >> dummy;
+          line >> dummy >> dummy;
+          line >> dummy;
+          line >> Struct[i].MP[Bead].q;
         }
       }
     }
@@ -620,7 +667,7 @@ double PSI4Opt(vector<QMMMAtom>& Struct,
   ifile.close();
   //Collect energy (post-SCF)
   call.str("");
-  call << "LICHM_" << Bead << ".log";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
   ifile.open(call.str().c_str(),ios_base::in);
   while (!ifile.eof())
   {
@@ -645,8 +692,8 @@ double PSI4Opt(vector<QMMMAtom>& Struct,
     cerr.flush(); //Print warning immediately
     //Delete checkpoint
     call.str("");
-    call << "rm -f *LICHM_" << Bead << ".180";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "*LICHM_" << Bead << ".180";
+    LICHEMRemoveFiles(call.str());
   }
   if (!Optfinished)
   {
@@ -659,16 +706,15 @@ double PSI4Opt(vector<QMMMAtom>& Struct,
     cerr.flush(); //Print warning immediately
     //Delete checkpoint
     call.str("");
-    call << "rm -f *LICHM_" << Bead << ".180";
-    GlobalSys = system(call.str().c_str());
+    call << LICHEMJobDir(Bead) << "*LICHM_" << Bead << ".180";
+    LICHEMRemoveFiles(call.str());
   }
   //Clean up files
   call.str("");
-  call << "rm -f ";
-  call << "LICHM_" << Bead << ".dat ";
-  call << "LICHM_" << Bead << ".out ";
-  call << "LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dat ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".out ";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  LICHEMRemoveFiles(call.str());
   //Change units
   E *= Har2eV;
   return E;
@@ -16,154 +16,555 @@
 */
 
 //Path integral Monte Carlo functions
+double Get_PI_AtomEspring(QMMMAtom& Atom, QMMMSettings& QMMMOpts)
+{
+  //Calculate the harmonic PI ring energy of a single atom
+  double E = 0.0;
+  double w = 1/(QMMMOpts.Beta*hbar);
+  w *= w*ToeV*QMMMOpts.Nbeads*Atom.m;
+  VectorXd Dx(QMMMOpts.Nbeads); //Bead displacements
+  VectorXd Dy(QMMMOpts.Nbeads); //Bead displacements
+  VectorXd Dz(QMMMOpts.Nbeads); //Bead displacements
+  for (int j=0;j<QMMMOpts.Nbeads;j++)
+  {
+    //Bead displacement, one bond to avoid double counting
+    int j2 = j-1;
+    if (j2 == -1)
+    {
+      j2 = QMMMOpts.Nbeads-1; //Ring PBC
+    }
+    Dx(j) = Atom.P[j].x-Atom.P[j2].x;
+    Dy(j) = Atom.P[j].y-Atom.P[j2].y;
+    Dz(j) = Atom.P[j].z-Atom.P[j2].z;
+  }
+  //Calculate displacements with PBC
+  E = 0.5*w*MinImageDist2(Dx,Dy,Dz).sum(); //Harmonic energy
+  return E;
+};
+
 double Get_PI_Espring(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
 {
-  //Calculate total harmonic PI ring energy
+  //Calculate total harmonic PI ring energy and save the atomic terms
   double E = 0.0;
-  double w0 = 1/(QMMMOpts.Beta*hbar);
-  w0 *= w0*ToeV*QMMMOpts.Nbeads;
   #pragma omp parallel for schedule(dynamic) reduction(+:E)
   for (int i=0;i<Natoms;i++)
   {
-    Struct[i].Ep = 0.0;
-    double w = w0*Struct[i].m;
-    for (int j=0;j<QMMMOpts.Nbeads;j++)
+    double Ep = Get_PI_AtomEspring(Struct[i],QMMMOpts);
+    Struct[i].Ep = Ep; //Save atomic energy
+    E += Ep;
+  }
+  QMMMOpts.Espring = E; //Save total energy
+  return E;
+};
+
+MatrixXd Get_PI_Contraction(QMMMSettings& QMMMOpts)
+{
+  //Matrix which contracts the ring to QMBeads beads by removing the high
+  //frequency normal modes
+  //NB: Element (k,j) is the weight of bead j in contracted bead k. Both
+  //rings use the same real normal modes, so the centroid and the lowest
+  //modes are kept exactly.
+  int Nb = QMMMOpts.Nbeads; //Number of beads
+  int Nc = QMMMOpts.QMBeads; //Number of contracted beads
+  MatrixXd T(Nc,Nb);
+  for (int k=0;k<Nc;k++)
+  {
+    for (int j=0;j<Nb;j++)
     {
-      //Bead energy, one bond to avoid double counting
-      int j2 = j-1;
-      if (j2 == -1)
+      //Centroid
+      double Tkj = 1.0;
+      //Cosine and sine modes
+      for (int n=1;(2*n)<Nc;n++)
       {
-        j2 = QMMMOpts.Nbeads-1; //Ring PBC
+        Tkj += 2*cos(2*pi*n*((((double)k)/Nc)-(((double)j)/Nb)));
       }
-      //Calculate displacement with PBC
-      double dr2 = CoordDist2(Struct[i].P[j],Struct[i].P[j2]).VecMag();
-      Struct[i].Ep += 0.5*w*dr2; //Harmonic energy
+      if ((Nc%2) == 0)
+      {
+        //Alternating mode of the contracted ring
+        Tkj += sqrt2*(1-2*(k%2))*cos(pi*Nc*j/((double)Nb));
+      }
+      T(k,j) = Tkj/Nb;
+    }
+  }
+  return T;
+};
+
+void PIUnwrapRing(QMMMAtom& Atom, QMMMSettings& QMMMOpts, VectorXd& Dx,
+                  VectorXd& Dy, VectorXd& Dz)
+{
+  //Bead positions relative to the first bead without PBC jumps
+  int Nb = QMMMOpts.Nbeads; //Number of beads
+  Dx.resize(Nb);
+  Dy.resize(Nb);
+  Dz.resize(Nb);
+  for (int j=0;j<Nb;j++)
+  {
+    int j2 = (j+Nb-1)%Nb; //Previous bead
+    Dx(j) = Atom.P[j].x-Atom.P[j2].x;
+    Dy(j) = Atom.P[j].y-Atom.P[j2].y;
+    Dz(j) = Atom.P[j].z-Atom.P[j2].z;
+  }
+  MinImageDist2(Dx,Dy,Dz); //Apply PBC to the bonds
+  Dx(0) = 0;
+  Dy(0) = 0;
+  Dz(0) = 0;
+  for (int j=1;j<Nb;j++)
+  {
+    Dx(j) += Dx(j-1);
+    Dy(j) += Dy(j-1);
+    Dz(j) += Dz(j-1);
+  }
+  return;
+};
+
+void PIContractRing(vector<QMMMAtom>& Struct, vector<QMMMAtom>& Ring,
+                    QMMMSettings& QMMMOpts)
+{
+  //Function to update a copy of the atoms with a contracted ring polymer
+  //NB: The copy and the contraction matrix are only built on the first
+  //call, later calls overwrite the positions and multipoles
+  int Nb = QMMMOpts.Nbeads; //Number of beads
+  int Nc = QMMMOpts.QMBeads; //Number of contracted beads
+  MatrixXd& T = QMMMOpts.PIRingT; //Contraction matrix
+  if ((T.rows() != Nc) or (T.cols() != Nb))
+  {
+    T = Get_PI_Contraction(QMMMOpts);
+  }
+  if ((int)Ring.size() != Natoms)
+  {
+    //Copy the topology and force field
+    Ring = Struct;
+    for (int i=0;i<Natoms;i++)
+    {
+      Ring[i].P.resize(Nc);
+      Ring[i].MP.resize(Nc);
+      Ring[i].PC.resize(Nc);
+    }
+  }
+  #pragma omp parallel for schedule(dynamic)
+  for (int i=0;i<Natoms;i++)
+  {
+    //Unwrap the ring of the atom
+    VectorXd Dx,Dy,Dz; //Bead positions relative to the first bead
+    PIUnwrapRing(Struct[i],QMMMOpts,Dx,Dy,Dz);
+    //Contract the ring
+    VectorXd Cx = T*Dx;
+    VectorXd Cy = T*Dy;
+    VectorXd Cz = T*Dz;
+    for (int k=0;k<Nc;k++)
+    {
+      //Use the charges of the nearest bead in imaginary time
+      int j = (k*Nb)/Nc; //Bead ID
+      Ring[i].P[k].x = Struct[i].P[0].x+Cx(k);
+      Ring[i].P[k].y = Struct[i].P[0].y+Cy(k);
+      Ring[i].P[k].z = Struct[i].P[0].z+Cz(k);
+      Ring[i].MP[k] = Struct[i].MP[j];
+      Ring[i].PC[k] = Struct[i].PC[j];
     }
-    E += Struct[i].Ep; //Save energy
   }
+  return;
+};
+
+double Get_PI_BeadTI(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                     VectorXd& Forces)
+{
+  //Takahashi-Imada correction to the potential of a single bead
+  //NB: Only the forces on the QM and PB atoms are included
+  double E = 0.0;
+  if (Forces.size() != (3*(Nqm+Npseudo)))
+  {
+    //No forces for this bead
+    return E;
+  }
+  for (int p=0;p<(Nqm+Npseudo);p++)
+  {
+    int i = QMPBList[p]; //Atom ID
+    double F2 = 0; //Squared force
+    F2 += Forces(3*p)*Forces(3*p);
+    F2 += Forces(3*p+1)*Forces(3*p+1);
+    F2 += Forces(3*p+2)*Forces(3*p+2);
+    E += F2/Struct[i].m;
+  }
+  double Tau = QMMMOpts.Beta*hbar/QMMMOpts.Nbeads; //Imaginary time step
+  E *= Tau*Tau/(24*ToeV);
   return E;
 };
 
-double Get_PI_Epot(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
+double Get_PI_ETI(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
 {
-  //Potential for all beads
+  //Average Takahashi-Imada correction of the saved beads
+  //NB: The correction scales with the square of the temperature, so the
+  //energy estimator counts it three times
   double E = 0.0;
-  //Fix parallel for classical MC
-  int MCThreads = Nthreads;
-  if (QMMMOpts.Nbeads == 1)
+  for (unsigned int j=0;j<QMMMOpts.BeadForces.size();j++)
   {
-    MCThreads = 1;
+    E += Get_PI_BeadTI(Struct,QMMMOpts,QMMMOpts.BeadForces[j]);
   }
-  //Calculate energy
-  #pragma omp parallel for schedule(dynamic) num_threads(MCThreads) \
-          reduction(+:E,QMTime,MMTime)
+  E /= QMMMOpts.Nbeads;
+  return E;
+};
+
+double Get_PI_Kvirial(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
+{
+  //Centroid virial kinetic energy using the saved bead forces
+  //NB: The primitive estimator is used for atoms without forces. Get_PI_Espring
+  //must be called first to save the atomic ring energies.
+  int Nb = QMMMOpts.Nbeads; //Number of beads
+  double E = 0.0;
+  vector<int> ForceID(Natoms,-1); //Position in the force vectors
+  for (int p=0;p<(Nqm+Npseudo);p++)
+  {
+    ForceID[QMPBList[p]] = p;
+  }
+  #pragma omp parallel for schedule(dynamic) reduction(+:E)
+  for (int i=0;i<Natoms;i++)
+  {
+    int p = ForceID[i]; //Force ID
+    bool HasForces = (p >= 0);
+    for (int j=0;j<Nb;j++)
+    {
+      if (QMMMOpts.BeadForces[j].size() != (3*(Nqm+Npseudo)))
+      {
+        HasForces = 0;
+      }
+    }
+    if (!HasForces)
+    {
+      //Primitive estimator
+      E += 3*Nb/(2*QMMMOpts.Beta)-Struct[i].Ep;
+      continue;
+    }
+    //Centroid virial estimator
+    VectorXd Dx,Dy,Dz; //Bead positions relative to the first bead
+    PIUnwrapRing(Struct[i],QMMMOpts,Dx,Dy,Dz);
+    Dx.array() -= Dx.mean();
+    Dy.array() -= Dy.mean();
+    Dz.array() -= Dz.mean();
+    double Vir = 0; //Virial of the atom
+    for (int j=0;j<Nb;j++)
+    {
+      Vir += Dx(j)*QMMMOpts.BeadForces[j](3*p);
+      Vir += Dy(j)*QMMMOpts.BeadForces[j](3*p+1);
+      Vir += Dz(j)*QMMMOpts.BeadForces[j](3*p+2);
+    }
+    E += 3/(2*QMMMOpts.Beta)-Vir/(2*Nb);
+  }
+  return E;
+};
+
+double Get_PI_Epot(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts)
+{
+  //Potential for all beads, resets the saved bead energies
+  vector<bool> Dirty(QMMMOpts.Nbeads,1); //Recalculate every bead
+  QMMMOpts.BeadEpot.assign(QMMMOpts.Nbeads,0.0);
+  QMMMOpts.BeadForces.assign(QMMMOpts.Nbeads,VectorXd());
+  return Get_PI_Epot(Struct,QMMMOpts,QMMMOpts.BeadEpot,QMMMOpts.BeadForces,
+                     Dirty);
+};
+
+double Get_PI_Epot(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                   vector<double>& Ebeads, vector<VectorXd>& Fbeads,
+                   vector<bool>& Dirty)
+{
+  //Potential for all beads, only beads flagged as dirty are recalculated
+  //NB: The forces on the QM and PB atoms are saved in Fbeads when they are
+  //needed for the Takahashi-Imada potential or the virial estimator
+  double E = 0.0;
+  double Ering = 0.0; //Average QM energy of the contracted ring
+  //Find the beads which changed
+  vector<int> Todo; //List of dirty beads
   for (int i=0;i<QMMMOpts.Nbeads;i++)
   {
-    //Run the wrappers for all beads
-    double Es = 0.0;
-    //Timer variables
-    int t_qm_start = 0;
-    int t_mm_start = 0;
-    int Times_qm = 0;
-    int Times_mm = 0;
-    //Calculate QM energy
-    if (Gaussian)
+    if (Dirty[i])
     {
-      t_qm_start = (unsigned)time(0);
-      Es += GaussianEnergy(Struct,QMMMOpts,i);
-      Times_qm += (unsigned)time(0)-t_qm_start;
+      Todo.push_back(i);
     }
-    if (PSI4)
+  }
+  bool Contract = ((QMMM or QMonly) and (QMMMOpts.QMBeads > 0) and
+                  (QMMMOpts.QMBeads < QMMMOpts.Nbeads)); //Contract the ring
+  if (Contract)
+  {
+    //The QM energy of the contracted ring is calculated for every move
+    //NB: Ebeads only holds the MM energies when the ring is contracted
+    vector<QMMMAtom>& Ring = QMMMOpts.PIRing; //Contracted ring polymer
+    PIContractRing(Struct,Ring,QMMMOpts);
+    vector<double> Eqm(QMMMOpts.QMBeads,0.0); //Contracted QM energies
+    vector<double> Emm(QMMMOpts.Nbeads,0.0); //MM energies
+    LICHEMRingEnergies(Struct,Ring,QMMMOpts,Todo,Eqm,Emm);
+    QMMMOpts.MCStat.QMCalls += QMMMOpts.QMBeads;
+    for (unsigned int p=0;p<Todo.size();p++)
     {
-      t_qm_start = (unsigned)time(0);
-      Es += PSI4Energy(Struct,QMMMOpts,i);
-      Times_qm += (unsigned)time(0)-t_qm_start;
-      //Delete annoying useless files
-      GlobalSys = system("rm -f psi.* timer.*");
+      int i = Todo[p]; //Bead ID
+      Ebeads[i] = Emm[i];
     }
-    if (NWChem)
+    for (int i=0;i<QMMMOpts.QMBeads;i++)
     {
-      t_qm_start = (unsigned)time(0);
-      Es += NWChemEnergy(Struct,QMMMOpts,i);
-      Times_qm += (unsigned)time(0)-t_qm_start;
+      //Average QM energy of the contracted beads
+      Ering += Eqm[i]/QMMMOpts.QMBeads;
     }
-    //Calculate MM energy
-    if (TINKER)
+  }
+  else
+  {
+    if (QMMM or QMonly)
     {
-      t_mm_start = (unsigned)time(0);
-      Es += TINKEREnergy(Struct,QMMMOpts,i);
-      Times_mm += (unsigned)time(0)-t_mm_start;
+      //Count the QM calculations for the Monte Carlo statistics
+      QMMMOpts.MCStat.QMCalls += Todo.size();
     }
-    if (AMBER)
+    //Calculate energy
+    vector<double> Eqm(QMMMOpts.Nbeads,0.0); //QM energies
+    vector<double> Emm(QMMMOpts.Nbeads,0.0); //MM energies
+    bool UseTI = (QMMMOpts.PIFactor == "TI"); //Higher-order potential
+    if ((QMMM or QMonly) and (UseTI or QMMMOpts.PIVirial))
     {
-      t_mm_start = (unsigned)time(0);
-      Es += AMBEREnergy(Struct,QMMMOpts,i);
-      Times_mm += (unsigned)time(0)-t_mm_start;
+      LICHEMBeadForces(Struct,QMMMOpts,Todo,Eqm,Emm,Fbeads);
     }
-    if (LAMMPS)
+    else
     {
-      t_mm_start = (unsigned)time(0);
-      Es += LAMMPSEnergy(Struct,QMMMOpts,i);
-      Times_mm += (unsigned)time(0)-t_mm_start;
+      LICHEMBeadEnergies(Struct,QMMMOpts,Todo,Eqm,Emm);
+      UseTI = 0; //No forces
     }
-    //Add temp variables to the totals
-    E += Es;
-    QMTime += Times_qm;
-    MMTime += Times_mm;
+    //Save the bead energies
+    for (unsigned int p=0;p<Todo.size();p++)
+    {
+      int i = Todo[p]; //Bead ID
+      Ebeads[i] = Eqm[i]+Emm[i];
+      if (UseTI)
+      {
+        //Add the Takahashi-Imada correction
+        Ebeads[i] += Get_PI_BeadTI(Struct,QMMMOpts,Fbeads[i]);
+      }
+    }
+  }
+  //Sum the energies of all beads
+  for (int i=0;i<QMMMOpts.Nbeads;i++)
+  {
+    E += Ebeads[i];
   }
   E /= QMMMOpts.Nbeads;
+  E += Ering;
   return E;
 };
 
+void MCSeedStreams(QMMMSettings& QMMMOpts, int Chain)
+{
+  //Start the random number streams of a Monte Carlo chain
+  QMMMOpts.Chain = Chain;
+  QMMMOpts.MCRand.Seed(RandSeed,Chain,RandMoves,0);
+  QMMMOpts.BeadRand.resize(QMMMOpts.Nbeads);
+  for (int i=0;i<QMMMOpts.Nbeads;i++)
+  {
+    QMMMOpts.BeadRand[i].Seed(RandSeed,Chain,RandBeads,i);
+  }
+  return;
+};
+
+void MCStagingMove(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                   MCUndoLog& Journal, int p)
+{
+  //Regenerate a segment of the ring polymer of atom p from the free
+  //particle distribution (Levy construction)
+  //NB: The end points of the segment are fixed and the StageLen-1 beads
+  //between them are replaced, so only those beads need new energies
+  int Len = QMMMOpts.StageLen; //Number of bonds in the segment
+  double w = 1/(QMMMOpts.Beta*hbar);
+  w *= w*ToeV*QMMMOpts.Nbeads*Struct[p].m;
+  double Var = 1/(QMMMOpts.Beta*w); //Variance of a single bond
+  //Pick the first bead and find the bonds of the segment
+  int j0 = QMMMOpts.MCRand.Integer(QMMMOpts.Nbeads); //First bead
+  VectorXd Dx(Len); //Bond displacements
+  VectorXd Dy(Len); //Bond displacements
+  VectorXd Dz(Len); //Bond displacements
+  for (int k=0;k<Len;k++)
+  {
+    int j = (j0+k)%QMMMOpts.Nbeads; //Bead ID
+    int j2 = (j0+k+1)%QMMMOpts.Nbeads; //Next bead ID
+    Dx(k) = Struct[p].P[j2].x-Struct[p].P[j].x;
+    Dy(k) = Struct[p].P[j2].y-Struct[p].P[j].y;
+    Dz(k) = Struct[p].P[j2].z-Struct[p].P[j].z;
+  }
+  MinImageDist2(Dx,Dy,Dz); //Apply PBC to the bonds
+  //Position of the last bead relative to the first bead
+  double Ex = Dx.sum();
+  double Ey = Dy.sum();
+  double Ez = Dz.sum();
+  //Generate new beads
+  Coord Start = Struct[p].P[j0]; //Position of the first bead
+  double x = 0; //Position of the previous bead
+  double y = 0; //Position of the previous bead
+  double z = 0; //Position of the previous bead
+  for (int k=1;k<Len;k++)
+  {
+    int j = (j0+k)%QMMMOpts.Nbeads; //Bead ID
+    double Nleft = Len-k+1; //Bonds between the previous and last beads
+    double Sig = sqrt(Var*(Nleft-1)/Nleft); //Standard deviation
+    x += ((Ex-x)/Nleft)+Sig*QMMMOpts.BeadRand[j].Normal();
+    y += ((Ey-y)/Nleft)+Sig*QMMMOpts.BeadRand[j].Normal();
+    z += ((Ez-z)/Nleft)+Sig*QMMMOpts.BeadRand[j].Normal();
+    Journal.SaveBead(Struct,p,j);
+    Struct[p].P[j].x = Start.x+x;
+    Struct[p].P[j].y = Start.y+y;
+    Struct[p].P[j].z = Start.z+z;
+  }
+  return;
+};
+
+void MCNormalModeMove(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                      MCUndoLog& Journal, int p)
+{
+  //Regenerate the ring polymer of atom p from the free particle
+  //distribution while keeping the centroid fixed
+  //NB: The ring energy is 0.5*w*sum(lambda*q^2) for the real normal modes
+  //of the ring, so each mode is an independent Gaussian number
+  int Nb = QMMMOpts.Nbeads; //Number of beads
+  double w = 1/(QMMMOpts.Beta*hbar);
+  w *= w*ToeV*Nb*Struct[p].m;
+  //Unwrap the ring and find the centroid
+  VectorXd Dx(Nb-1); //Bond displacements
+  VectorXd Dy(Nb-1); //Bond displacements
+  VectorXd Dz(Nb-1); //Bond displacements
+  for (int j=0;j<(Nb-1);j++)
+  {
+    Dx(j) = Struct[p].P[j+1].x-Struct[p].P[j].x;
+    Dy(j) = Struct[p].P[j+1].y-Struct[p].P[j].y;
+    Dz(j) = Struct[p].P[j+1].z-Struct[p].P[j].z;
+  }
+  MinImageDist2(Dx,Dy,Dz); //Apply PBC to the bonds
+  Coord Start = Struct[p].P[0]; //Position of the first bead
+  double Cx = 0; //Centroid relative to the first bead
+  double Cy = 0; //Centroid relative to the first bead
+  double Cz = 0; //Centroid relative to the first bead
+  double x = 0; //Position of bead j+1 relative to the first bead
+  double y = 0; //Position of bead j+1 relative to the first bead
+  double z = 0; //Position of bead j+1 relative to the first bead
+  for (int j=0;j<(Nb-1);j++)
+  {
+    x += Dx(j);
+    y += Dy(j);
+    z += Dz(j);
+    Cx += x;
+    Cy += y;
+    Cz += z;
+  }
+  Cx /= Nb;
+  Cy /= Nb;
+  Cz /= Nb;
+  //Sample the normal modes
+  VectorXd Fx(Nb); //Displacements from the centroid
+  VectorXd Fy(Nb); //Displacements from the centroid
+  VectorXd Fz(Nb); //Displacements from the centroid
+  Fx.setZero();
+  Fy.setZero();
+  Fz.setZero();
+  for (int n=1;n<=(Nb/2);n++)
+  {
+    double Lam = 2*sin(pi*n/Nb); //Square root of the mode eigenvalue
+    double Sig = 1/(Lam*sqrt(QMMMOpts.Beta*w)); //Standard deviation
+    if ((2*n) == Nb)
+    {
+      //Alternating mode
+      double qx = Sig*QMMMOpts.MCRand.Normal();
+      double qy = Sig*QMMMOpts.MCRand.Normal();
+      double qz = Sig*QMMMOpts.MCRand.Normal();
+      for (int j=0;j<Nb;j++)
+      {
+        double Sign = (1-2*(j%2))/sqrt(Nb); //Mode vector
+        Fx(j) += qx*Sign;
+        Fy(j) += qy*Sign;
+        Fz(j) += qz*Sign;
+      }
+    }
+    else
+    {
+      //Cosine and sine modes
+      double qcx = Sig*QMMMOpts.MCRand.Normal();
+      double qcy = Sig*QMMMOpts.MCRand.Normal();
+      double qcz = Sig*QMMMOpts.MCRand.Normal();
+      double qsx = Sig*QMMMOpts.MCRand.Normal();
+      double qsy = Sig*QMMMOpts.MCRand.Normal();
+      double qsz = Sig*QMMMOpts.MCRand.Normal();
+      for (int j=0;j<Nb;j++)
+      {
+        double Arg = 2*pi*n*j/Nb; //Phase of the bead
+        double Cos = sqrt(2.0/Nb)*cos(Arg); //Mode vector
+        double Sin = sqrt(2.0/Nb)*sin(Arg); //Mode vector
+        Fx(j) += qcx*Cos+qsx*Sin;
+        Fy(j) += qcy*Cos+qsy*Sin;
+        Fz(j) += qcz*Cos+qsz*Sin;
+      }
+    }
+  }
+  //Update positions
+  for (int j=0;j<Nb;j++)
+  {
+    Journal.SaveBead(Struct,p,j);
+    Struct[p].P[j].x = Start.x+Cx+Fx(j);
+    Struct[p].P[j].y = Start.y+Cy+Fy(j);
+    Struct[p].P[j].z = Start.z+Cz+Fz(j);
+  }
+  return;
+};
+
 bool MCMove(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, double& Emc)
 {
   //Function to perform Monte Carlo moves and accept/reject the moves
   bool acc = 0; //Accept or reject
-  //Copy Struct
-  vector<QMMMAtom> Struct2;
-  Struct2 = Struct;
+  //Moves are applied in place and recorded for a possible rejection
+  MCUndoLog Journal; //Old positions and box lengths
+  Journal.Clear();
+  VectorXd Used(Nmoves); //Types of moves in this step
+  Used.setZero();
   //Pick random move and apply PBC
-  double randnum = (((double)rand())/((double)RAND_MAX));
-  if (randnum > (1-CentProb))
+  double randnum = QMMMOpts.MCRand.Uniform();
+  //Check for a move which samples the ring polymer springs exactly
+  //NB: These moves are not combined with other moves, so only the change in
+  //the potential energy is used in the Metropolis test
+  bool RingMove = 0; //Flag for staging and normal mode moves
+  if ((randnum < BeadProb) and (QMMMOpts.Nbeads > 1) and
+     (QMMMOpts.BeadMove != "Uniform"))
+  {
+    RingMove = 1;
+  }
+  if ((randnum > (1-CentProb)) and (!RingMove))
   {
+    Used(MoveCent) = 1;
     //Move a centroid
     int p;
     bool FrozenAt = 1;
     while (FrozenAt)
     {
       //Make sure the atom is not frozen
-      p = (rand()%Natoms);
-      if (Struct2[p].Frozen == 0)
+      p = QMMMOpts.MCRand.Integer(Natoms);
+      if (Struct[p].Frozen == 0)
       {
         FrozenAt = 0;
       }
     }
-    double randx = (((double)rand())/((double)RAND_MAX));
-    double randy = (((double)rand())/((double)RAND_MAX));
-    double randz = (((double)rand())/((double)RAND_MAX));
-    double dx = 2*(randx-0.5)*mcstep*CentRatio;
-    double dy = 2*(randy-0.5)*mcstep*CentRatio;
-    double dz = 2*(randz-0.5)*mcstep*CentRatio;
+    double randx = QMMMOpts.MCRand.Uniform();
+    double randy = QMMMOpts.MCRand.Uniform();
+    double randz = QMMMOpts.MCRand.Uniform();
+    double dx = 2*(randx-0.5)*QMMMOpts.MCStep*CentRatio;
+    double dy = 2*(randy-0.5)*QMMMOpts.MCStep*CentRatio;
+    double dz = 2*(randz-0.5)*QMMMOpts.MCStep*CentRatio;
     //Update positions
+    Journal.SaveAtom(Struct,p,QMMMOpts.Nbeads);
     #pragma omp parallel
     {
       #pragma omp for nowait schedule(dynamic)
       for (int i=0;i<QMMMOpts.Nbeads;i++)
       {
-        Struct2[p].P[i].x += dx;
+        Struct[p].P[i].x += dx;
       }
       #pragma omp for nowait schedule(dynamic)
       for (int i=0;i<QMMMOpts.Nbeads;i++)
       {
-        Struct2[p].P[i].y += dy;
+        Struct[p].P[i].y += dy;
       }
       #pragma omp for nowait schedule(dynamic)
       for (int i=0;i<QMMMOpts.Nbeads;i++)
       {
-        Struct2[p].P[i].z += dz;
+        Struct[p].P[i].z += dz;
       }
     }
-    #pragma omp barrier
   }
   if (randnum < BeadProb)
   {
@@ -173,24 +574,42 @@ bool MCMove(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, double& Emc)
     while (FrozenAt)
     {
       //Make sure the atom is not frozen
-      p = (rand()%Natoms);
-      if (Struct2[p].Frozen == 0)
+      p = QMMMOpts.MCRand.Integer(Natoms);
+      if (Struct[p].Frozen == 0)
       {
         FrozenAt = 0;
       }
     }
-    for (int i=0;i<QMMMOpts.Nbeads;i++)
+    if (RingMove and (QMMMOpts.BeadMove == "Staging"))
+    {
+      //Regenerate part of the ring polymer
+      Used(MoveStage) = 1;
+      MCStagingMove(Struct,QMMMOpts,Journal,p);
+    }
+    if (RingMove and (QMMMOpts.BeadMove == "NormalModes"))
     {
-      //Randomly displace each bead
-      double randx = (((double)rand())/((double)RAND_MAX));
-      double randy = (((double)rand())/((double)RAND_MAX));
-      double randz = (((double)rand())/((double)RAND_MAX));
-      double dx = 2*(randx-0.5)*mcstep;
-      double dy = 2*(randy-0.5)*mcstep;
-      double dz = 2*(randz-0.5)*mcstep;
-      Struct2[p].P[i].x += dx;
-      Struct2[p].P[i].y += dy;
-      Struct2[p].P[i].z += dz;
+      //Regenerate the ring polymer around the centroid
+      Used(MoveModes) = 1;
+      MCNormalModeMove(Struct,QMMMOpts,Journal,p);
+    }
+    if (!RingMove)
+    {
+      //Displace each bead independently
+      Used(MoveBead) = 1;
+      for (int i=0;i<QMMMOpts.Nbeads;i++)
+      {
+        //Randomly displace each bead
+        double randx = QMMMOpts.BeadRand[i].Uniform();
+        double randy = QMMMOpts.BeadRand[i].Uniform();
+        double randz = QMMMOpts.BeadRand[i].Uniform();
+        double dx = 2*(randx-0.5)*QMMMOpts.MCStep;
+        double dy = 2*(randy-0.5)*QMMMOpts.MCStep;
+        double dz = 2*(randz-0.5)*QMMMOpts.MCStep;
+        Journal.SaveBead(Struct,p,i);
+        Struct[p].P[i].x += dx;
+        Struct[p].P[i].y += dy;
+        Struct[p].P[i].z += dz;
+      }
     }
   }
   //Initialize energies
@@ -201,245 +620,139 @@ bool MCMove(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, double& Emc)
   double LySave = Ly;
   double LzSave = Lz;
   //Attempt a volume move
-  randnum = (((double)rand())/((double)RAND_MAX));
-  if (randnum < VolProb)
+  randnum = QMMMOpts.MCRand.Uniform();
+  if ((randnum < VolProb) and (!RingMove))
   {
+    Used(MoveVol) = 1;
+    Journal.SaveAll(Struct,QMMMOpts.Nbeads); //All atoms will move
     //Anisotropic volume change
     if (Isotrop == 0)
     {
       //Assumes that MM cutoffs are safe
-      randnum = (((double)rand())/((double)RAND_MAX));
-      Lx += 2*(randnum-0.5)*mcstep;
-      randnum = (((double)rand())/((double)RAND_MAX));
-      Ly += 2*(randnum-0.5)*mcstep;
-      randnum = (((double)rand())/((double)RAND_MAX));
-      Lz += 2*(randnum-0.5)*mcstep;
+      randnum = QMMMOpts.MCRand.Uniform();
+      Lx += 2*(randnum-0.5)*QMMMOpts.MCStep;
+      randnum = QMMMOpts.MCRand.Uniform();
+      Ly += 2*(randnum-0.5)*QMMMOpts.MCStep;
+      randnum = QMMMOpts.MCRand.Uniform();
+      Lz += 2*(randnum-0.5)*QMMMOpts.MCStep;
     }
     //Isotropic volume change
     if (Isotrop == 1)
     {
       //Assumes that MM cutoffs are safe
-      randnum = (((double)rand())/((double)RAND_MAX));
-      Lx += 2*(randnum-0.5)*mcstep;
-      Ly += 2*(randnum-0.5)*mcstep;
-      Lz += 2*(randnum-0.5)*mcstep;
+      randnum = QMMMOpts.MCRand.Uniform();
+      Lx += 2*(randnum-0.5)*QMMMOpts.MCStep;
+      Ly += 2*(randnum-0.5)*QMMMOpts.MCStep;
+      Lz += 2*(randnum-0.5)*QMMMOpts.MCStep;
     }
     //Decide how to scale the centroids
     bool ScaleRing = 0; //Shift the ring
-    randnum = (((double)rand())/((double)RAND_MAX));
+    randnum = QMMMOpts.MCRand.Uniform();
     if (randnum >= 0.5)
     {
       //Evenly scale the size of the ring
       ScaleRing = 1;
     }
-    //Scale positions
-    if (ScaleRing)
+    //Organize the data by axis
+    double Coord::*Axes[3] = {&Coord::x,&Coord::y,&Coord::z}; //Components
+    double Lnew[3] = {Lx,Ly,Lz}; //New box lengths
+    double Lold[3] = {LxSave,LySave,LzSave}; //Old box lengths
+    //Scale positions in place
+    #pragma omp parallel for schedule(dynamic)
+    for (int i=0;i<Natoms;i++)
     {
-      #pragma omp parallel
+      vector<Coord>& P = Struct[i].P; //Bead positions
+      for (int k=0;k<3;k++)
       {
-        #pragma omp for nowait schedule(dynamic)
-        for (int i=0;i<Natoms;i++)
+        double L = Lnew[k]; //Box length
+        double Scale = (Lnew[k]/Lold[k])-1; //Scale factor
+        double Cent = 0; //Centroid position
+        if (!ScaleRing)
         {
+          //Find the centroid
           for (int j=0;j<QMMMOpts.Nbeads;j++)
           {
-            double shift;
-            shift = Struct2[i].P[j].x;
-            //Check PBC without wrapping the molecules
-            bool check = 1; //Continue the PBC checks
-            while (check)
-            {
-              //Check the value
-              check = 0;
-              if (shift > Lx)
-              {
-                shift -= Lx;
-                check = 1;
-              }
-              if (shift < 0)
-              {
-                shift += Lx;
-                check = 1;
-              }
-            }
-            shift = ((Lx/LxSave)-1)*shift;
-            Struct2[i].P[j].x += shift;
-          }
-        }
-        #pragma omp for nowait schedule(dynamic)
-        for (int i=0;i<Natoms;i++)
-        {
-          for (int j=0;j<QMMMOpts.Nbeads;j++)
-          {
-            double shift;
-            shift = Struct2[i].P[j].y;
-            //Check PBC without wrapping the molecules
-            bool check = 1; //Continue the PBC checks
-            while (check)
-            {
-              //Check the value
-              check = 0;
-              if (shift > Ly)
-              {
-                shift -= Ly;
-                check = 1;
-              }
-              if (shift < 0)
-              {
-                shift += Ly;
-                check = 1;
-              }
-            }
-            shift = ((Ly/LySave)-1)*shift;
-            Struct2[i].P[j].y += shift;
+            Cent += P[j].*Axes[k];
           }
+          Cent /= QMMMOpts.Nbeads;
         }
-        #pragma omp for nowait schedule(dynamic)
-        for (int i=0;i<Natoms;i++)
+        for (int j=0;j<QMMMOpts.Nbeads;j++)
         {
-          for (int j=0;j<QMMMOpts.Nbeads;j++)
+          double shift = Cent; //Position to scale
+          if (ScaleRing)
           {
-            double shift;
-            shift = Struct2[i].P[j].z;
-            //Check PBC without wrapping the molecules
-            bool check = 1; //Continue the PBC checks
-            while (check)
-            {
-              //Check the value
-              check = 0;
-              if (shift > Lz)
-              {
-                shift -= Lz;
-                check = 1;
-              }
-              if (shift < 0)
-              {
-                shift += Lz;
-                check = 1;
-              }
-            }
-            shift = ((Lz/LzSave)-1)*shift;
-            Struct2[i].P[j].z += shift;
+            shift = P[j].*Axes[k];
           }
-        }
-      }
-      #pragma omp barrier
-    }
-    else
-    {
-      #pragma omp parallel
-      {
-        #pragma omp for nowait schedule(dynamic)
-        for (int i=0;i<Natoms;i++)
-        {
-          //Find centroids
-          double shift = 0; //Change of position for the centroid
-          for (int j=0;j<QMMMOpts.Nbeads;j++)
-          {
-            shift += Struct2[i].P[j].x; //Add to the position sum
-          }
-          shift /= QMMMOpts.Nbeads; //Average position
-          //Check PBC without wrapping the molecules
-          bool check = 1; //Continue the PBC checks
-          while (check)
-          {
-            //Check the value
-            check = 0;
-            if (shift > Lx)
-            {
-              shift -= Lx;
-              check = 1;
-            }
-            if (shift < 0)
-            {
-              shift += Lx;
-              check = 1;
-            }
-          }
-          //Calculate the change in position
-          shift = ((Lx/LxSave)-1)*shift;
-          for (int j=0;j<QMMMOpts.Nbeads;j++)
-          {
-            //Update the position
-            Struct2[i].P[j].x += shift;
-          }
-        }
-        #pragma omp for nowait schedule(dynamic)
-        for (int i=0;i<Natoms;i++)
-        {
-          //Find centroids
-          double shift = 0; //Change of position for the centroid
-          for (int j=0;j<QMMMOpts.Nbeads;j++)
-          {
-            shift += Struct2[i].P[j].y; //Add to the position sum
-          }
-          shift /= QMMMOpts.Nbeads; //Average position
-          //Check PBC without wrapping the molecules
-          bool check = 1; //Continue the PBC checks
-          while (check)
-          {
-            //Check the value
-            check = 0;
-            if (shift > Ly)
-            {
-              shift -= Ly;
-              check = 1;
-            }
-            if (shift < 0)
-            {
-              shift += Ly;
-              check = 1;
-            }
-          }
-          //Calculate the change in position
-          shift = ((Ly/LySave)-1)*shift;
-          for (int j=0;j<QMMMOpts.Nbeads;j++)
-          {
-            //Update the position
-            Struct2[i].P[j].y += shift;
-          }
-        }
-        #pragma omp for nowait schedule(dynamic)
-        for (int i=0;i<Natoms;i++)
-        {
-          //Find centroids
-          double shift = 0; //Change of position for the centroid
-          for (int j=0;j<QMMMOpts.Nbeads;j++)
-          {
-            shift += Struct2[i].P[j].z; //Add to the position sum
-          }
-          shift /= QMMMOpts.Nbeads; //Average position
           //Check PBC without wrapping the molecules
           bool check = 1; //Continue the PBC checks
           while (check)
           {
             //Check the value
             check = 0;
-            if (shift > Lz)
+            if (shift > L)
             {
-              shift -= Lz;
+              shift -= L;
               check = 1;
             }
             if (shift < 0)
             {
-              shift += Lz;
+              shift += L;
               check = 1;
             }
           }
-          //Calculate the change in position
-          shift = ((Lz/LzSave)-1)*shift;
-          for (int j=0;j<QMMMOpts.Nbeads;j++)
-          {
-            //Update the position
-            Struct2[i].P[j].z += shift;
-          }
+          //Update the position
+          P[j].*Axes[k] += Scale*shift;
         }
       }
-      #pragma omp barrier
     }
   }
   //Update energies
-  Enew += Get_PI_Epot(Struct2,QMMMOpts);
-  Enew += Get_PI_Espring(Struct2,QMMMOpts);
+  vector<bool> Dirty; //Beads that need new energies
+  Journal.FlagBeads(Dirty,QMMMOpts.Nbeads);
+  if (QMMMOpts.BeadEpot.size() != (unsigned)QMMMOpts.Nbeads)
+  {
+    //No saved energies, recalculate everything
+    Dirty.assign(QMMMOpts.Nbeads,1);
+    QMMMOpts.BeadEpot.assign(QMMMOpts.Nbeads,0.0);
+  }
+  if (QMMMOpts.BeadForces.size() != (unsigned)QMMMOpts.Nbeads)
+  {
+    QMMMOpts.BeadForces.assign(QMMMOpts.Nbeads,VectorXd());
+  }
+  vector<double> Ebeads = QMMMOpts.BeadEpot; //Trial bead energies
+  vector<VectorXd> Fbeads = QMMMOpts.BeadForces; //Trial bead forces
+  Enew += Get_PI_Epot(Struct,QMMMOpts,Ebeads,Fbeads,Dirty);
+  //Update the ring energy of the moved atoms
+  vector<int> Moved; //Atoms displaced by the move
+  vector<double> EpNew; //New atomic ring energies
+  double Espring = QMMMOpts.Espring; //Trial ring energy
+  bool MovedAll = Journal.MovedAtoms(Moved);
+  if (MovedAll)
+  {
+    //Every atom changed, find all atomic energies
+    Moved.clear();
+    for (int i=0;i<Natoms;i++)
+    {
+      Moved.push_back(i);
+    }
+    Espring = 0; //Avoid accumulating round-off errors
+  }
+  EpNew.resize(Moved.size());
+  int Nmoved = Moved.size(); //Number of moved atoms
+  #pragma omp parallel for schedule(dynamic) reduction(+:Espring) \
+          if(MovedAll)
+  for (int k=0;k<Nmoved;k++)
+  {
+    int i = Moved[k]; //Atom ID
+    EpNew[k] = Get_PI_AtomEspring(Struct[i],QMMMOpts);
+    Espring += EpNew[k];
+    if (!MovedAll)
+    {
+      //Remove the old atomic energy
+      Espring -= Struct[i].Ep;
+    }
+  }
+  Enew += Espring;
   if (QMMMOpts.Ensemble == "NPT")
   {
     //Add PV energy term
@@ -447,6 +760,11 @@ bool MCMove(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, double& Emc)
   }
   //Accept or reject
   double dE = QMMMOpts.Beta*(Enew-Eold);
+  if (RingMove)
+  {
+    //Remove the ring energy, which was sampled by the move
+    dE -= QMMMOpts.Beta*(Espring-QMMMOpts.Espring);
+  }
   if (QMMMOpts.Ensemble == "NPT")
   {
     //Add Nln(V) term
@@ -458,11 +776,18 @@ bool MCMove(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, double& Emc)
     dE -= VolTerm; //Subtract from the energy
   }
   double Prob = exp(-1*dE);
-  randnum = (((double)rand())/((double)RAND_MAX));
+  randnum = QMMMOpts.MCRand.Uniform();
   if (randnum <= Prob)
   {
     //Accept
-    Struct = Struct2;
+    QMMMOpts.BeadEpot.swap(Ebeads); //Keep the new bead energies
+    QMMMOpts.BeadForces.swap(Fbeads); //Keep the new bead forces
+    for (int k=0;k<Nmoved;k++)
+    {
+      //Keep the new atomic ring energies
+      Struct[Moved[k]].Ep = EpNew[k];
+    }
+    QMMMOpts.Espring = Espring;
     Emc = Enew;
     QMMMOpts.Eold = Enew;
     acc = 1;
@@ -471,12 +796,283 @@ bool MCMove(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, double& Emc)
   {
     //Reject
     Emc = Eold;
-    //Revert to old box sizes
-    Lx = LxSave;
-    Ly = LySave;
-    Lz = LzSave;
+    //Revert to the old positions and box sizes
+    Journal.Undo(Struct);
+  }
+  //Update statistics
+  QMMMOpts.MCStat.Tries += Used;
+  if (acc)
+  {
+    QMMMOpts.MCStat.Accepts += Used;
   }
   //Return decision
   return acc;
 };
 
+
+void MCPrintLine(QMMMSettings& QMMMOpts, stringstream& Line)
+{
+  //Function to print a line of Monte Carlo output and clear the stream
+  //NB: The output of a chain is labeled when several chains run at the
+  //same time
+  stringstream Label; //Chain ID
+  if (QMMMOpts.Nchains > 1)
+  {
+    Label << " | Chain: " << setw(LICHEMCount(QMMMOpts.Nchains-1));
+    Label << QMMMOpts.Chain;
+  }
+  #pragma omp critical(LICHEMChainOutput)
+  {
+    cout << Label.str() << Line.str() << '\n';
+    cout.flush();
+  }
+  Line.str("");
+  return;
+};
+
+void MCRunChain(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                fstream& traj)
+{
+  //Function to run the equilibration and production steps of a Monte Carlo
+  //chain and save the averages in the chain statistics
+  //NB: A chain only changes its own atoms and settings, so chains with a
+  //fixed box can run at the same time
+  MCStats& Stats = QMMMOpts.MCStat; //Shorter name
+  bool OneChain = (QMMMOpts.Nchains == 1); //Flag to print the headers
+  stringstream Line; //Output of the chain
+  double Ek = 0; //PIMC kinietic energy
+  if (QMMMOpts.Nbeads > 1)
+  {
+    //Set kinetic energy
+    Ek = 3*Natoms*QMMMOpts.Nbeads/(2*QMMMOpts.Beta);
+  }
+  int Nct = 0; //Step counter
+  int ct = 0; //Secondary counter
+  double Nacc = 0; //Number of accepted moves
+  double Nrej = 0; //Number of rejected moves
+  double Emc = 0; //Monte Carlo energy
+  double Et = 0; //Total energy for printing
+  bool acc; //Flag for accepting a step
+  //Find the number of characters to print for the step counter
+  int SimCharLen;
+  SimCharLen = QMMMOpts.Neq+QMMMOpts.Nsteps;
+  SimCharLen = LICHEMCount(SimCharLen);
+  //Start equilibration run and calculate initial energy
+  if (OneChain)
+  {
+    cout << '\n';
+    cout << "Monte Carlo equilibration:" << '\n';
+    cout.flush();
+  }
+  QMMMOpts.Eold = 0;
+  QMMMOpts.Eold += Get_PI_Epot(Struct,QMMMOpts);
+  QMMMOpts.Eold += Get_PI_Espring(Struct,QMMMOpts);
+  if (VolProb > 0)
+  {
+    //Add PV term
+    QMMMOpts.Eold += QMMMOpts.Press*Lx*Ly*Lz;
+  }
+  Emc = QMMMOpts.Eold; //Needed if equilibration is skipped
+  Nct = 0;
+  while (Nct < QMMMOpts.Neq)
+  {
+    Emc = 0;
+    //Check step size
+    if(ct == Acc_Check)
+    {
+      if ((Nacc/(Nrej+Nacc)) > QMMMOpts.accratio)
+      {
+        //Increase step size
+        double randval;
+        randval = QMMMOpts.MCRand.Uniform();
+        //Use random values to keep from cycling up and down
+        if (randval >= 0.5)
+        {
+          QMMMOpts.MCStep *= 1.10;
+        }
+        else
+        {
+          QMMMOpts.MCStep *= 1.09;
+        }
+      }
+      if ((Nacc/(Nrej+Nacc)) < QMMMOpts.accratio)
+      {
+        //Decrease step size
+        double randval;
+        randval = QMMMOpts.MCRand.Uniform();
+        //Use random values to keep from cycling up and down
+        if (randval >= 0.5)
+        {
+          QMMMOpts.MCStep *= 0.90;
+        }
+        else
+        {
+          QMMMOpts.MCStep *= 0.91;
+        }
+      }
+      if (QMMMOpts.MCStep < StepMin)
+      {
+        //Set to minimum
+        QMMMOpts.MCStep = StepMin;
+      }
+      if (QMMMOpts.MCStep > StepMax)
+      {
+        //Set to maximum
+        QMMMOpts.MCStep = StepMax;
+      }
+      //Statistics
+      Line << " | Step: " << setw(SimCharLen) << Nct;
+      Line << " | Step size: ";
+      Line << LICHEMFormFloat(QMMMOpts.MCStep,6);
+      Line << " | Accept ratio: ";
+      Line << LICHEMFormFloat((Nacc/(Nrej+Nacc)),6);
+      MCPrintLine(QMMMOpts,Line); //Print stats
+      //Reset counters
+      ct = 0;
+      Nacc = 0;
+      Nrej = 0;
+    }
+    //Continue simulation
+    ct += 1;
+    acc = MCMove(Struct,QMMMOpts,Emc);
+    if (acc)
+    {
+      Nct += 1;
+      Nacc += 1;
+    }
+    else
+    {
+      Nrej += 1;
+    }
+  }
+  if (!OneChain)
+  {
+    Line << " |";
+  }
+  Line << " Equilibration complete.";
+  MCPrintLine(QMMMOpts,Line);
+  //Start production run
+  Nct = 0;
+  Nacc = 0;
+  Nrej = 0;
+  Stats.Clear(); //Only count the production steps
+  if (OneChain)
+  {
+    cout << '\n';
+    cout << "Monte Carlo production:" << '\n';
+    cout.flush();
+  }
+  //Print starting conditions
+  Et = Ek+Emc; //Calculate total energy using previous saved energy
+  Et -= 2*QMMMOpts.Espring;
+  if (QMMMOpts.PIFactor == "TI")
+  {
+    //Complete the Takahashi-Imada energy estimator
+    Et += 2*Get_PI_ETI(Struct,QMMMOpts);
+  }
+  #pragma omp critical(LICHEMChainOutput)
+  {
+    Print_traj(Struct,traj,QMMMOpts,0,Et);
+  }
+  Line << " | Step: " << setw(SimCharLen) << 0;
+  Line << " | Energy: " << LICHEMFormFloat(Et,12);
+  Line << " eV";
+  if (QMMMOpts.Ensemble == "NPT")
+  {
+    double rho;
+    rho = LICHEMDensity(Struct,QMMMOpts);
+    Line << " | Density: ";
+    Line << LICHEMFormFloat(rho,8);
+    Line << " g/cm\u00B3";
+  }
+  MCPrintLine(QMMMOpts,Line); //Print results
+  //Continue simulation
+  while (Nct < QMMMOpts.Nsteps)
+  {
+    Emc = 0; //Set energy to zero
+    acc = MCMove(Struct,QMMMOpts,Emc);
+    if (acc and (((Nct+1)%QMMMOpts.Nprint) == 0))
+    {
+      //Compare the saved ring energy to a full calculation
+      double Edrift = -1*QMMMOpts.Espring;
+      Edrift += Get_PI_Espring(Struct,QMMMOpts); //Resets the energy
+      if (abs(Edrift) > 1e-6)
+      {
+        Line << " Warning: The ring polymer energy drifted by ";
+        Line << LICHEMFormFloat(Edrift,12) << " eV";
+        MCPrintLine(QMMMOpts,Line);
+      }
+      QMMMOpts.Eold += Edrift;
+      Emc = QMMMOpts.Eold;
+    }
+    //Update averages
+    Et = 0;
+    Et += Ek+Emc;
+    Et -= 2*QMMMOpts.Espring;
+    if (QMMMOpts.PIFactor == "TI")
+    {
+      //Complete the Takahashi-Imada energy estimator
+      Et += 2*Get_PI_ETI(Struct,QMMMOpts);
+    }
+    if (QMMMOpts.PIVirial)
+    {
+      //Replace the primitive kinetic energy
+      double Ev = Et-Ek+QMMMOpts.Espring; //Virial energy
+      Ev += Get_PI_Kvirial(Struct,QMMMOpts);
+      Stats.Evirial.push_back(Ev);
+    }
+    Stats.DenAvg += LICHEMDensity(Struct,QMMMOpts);
+    Stats.LxAvg += Lx;
+    Stats.LyAvg += Ly;
+    Stats.LzAvg += Lz;
+    Stats.Energies.push_back(Et);
+    //Update counters and print output
+    if (acc)
+    {
+      //Increase counters
+      Nct += 1;
+      Nacc += 1;
+      //Print trajectory and instantaneous energies
+      if ((Nct%QMMMOpts.Nprint) == 0)
+      {
+        //Print progress
+        #pragma omp critical(LICHEMChainOutput)
+        {
+          Print_traj(Struct,traj,QMMMOpts,Nct,Et);
+        }
+        Line << " | Step: " << setw(SimCharLen) << Nct;
+        Line << " | Energy: " << LICHEMFormFloat(Et,12);
+        Line << " eV";
+        if (QMMMOpts.Ensemble == "NPT")
+        {
+          double rho;
+          rho = LICHEMDensity(Struct,QMMMOpts);
+          Line << " | Density: ";
+          Line << LICHEMFormFloat(rho,8);
+          Line << " g/cm\u00B3";
+        }
+        MCPrintLine(QMMMOpts,Line); //Print results
+      }
+    }
+    else
+    {
+      Nrej += 1;
+    }
+  }
+  if ((Nct%QMMMOpts.Nprint) != 0)
+  {
+    //Print final geometry if it was not already written
+    #pragma omp critical(LICHEMChainOutput)
+    {
+      Print_traj(Struct,traj,QMMMOpts,Nct,Et);
+    }
+  }
+  //Save the averages
+  Stats.Nacc = Nacc;
+  Stats.Nrej = Nrej;
+  Stats.DenAvg /= Nrej+Nacc; //Average density
+  Stats.LxAvg /= Nrej+Nacc; //Average box size
+  Stats.LyAvg /= Nrej+Nacc; //Average box size
+  Stats.LzAvg /= Nrej+Nacc; //Average box size
+  return;
+};
@@ -0,0 +1,948 @@
+/*
+
+###############################################################################
+#                                                                             #
+#                 LICHEM: Layered Interacting CHEmical Models                 #
+#                              By: Eric G. Kratz                              #
+#                                                                             #
+#                      Symbiotic Computational Chemistry                      #
+#                                                                             #
+###############################################################################
+
+ Functions for launching external programs and managing files without a
+ shell.
+
+ NB: Programs are started with posix_spawn and the file operations use POSIX
+ calls, so the wrappers do not create a new /bin/sh process for each step.
+ C libraries older than glibc 2.29 cannot change directories in posix_spawn,
+ so fork and exec are used instead.
+ Wildcards are expanded with glob() and only match files in the pattern's
+ directory.
+
+ NB: When a scratch root is set, each bead has a private directory under
+ ScratchTop. LICHEM reads and writes the bead files with LICHEMJobDir() in
+ front of the names, and the programs are started inside the directory, so
+ the names in commands and input files stay relative.
+
+ NB: The job control functions run the QM and MM wrappers of a bead. The
+ processors of a job are set with the affinity of the thread, which is
+ inherited by the programs it starts.
+
+*/
+
+//Process control functions
+vector<string> LICHEMSplitArgs(const string& Cmd)
+{
+  //Function to split a command into the program name and arguments
+  vector<string> Args; //Program name and arguments
+  stringstream line(Cmd);
+  string dummy; //Generic string
+  while (line >> dummy)
+  {
+    Args.push_back(dummy);
+  }
+  return Args;
+};
+
+int LICHEMStartProc(pid_t& ProcID, vector<char*>& ArgV,
+                    const string& WorkDir, const string& InFile,
+                    const string& OutFile)
+{
+  //Function to start a program without waiting for it
+  //NB: The program runs in WorkDir and the file names are relative to
+  //WorkDir. Empty names keep the current directory, stdin, or stdout.
+  //Returns zero or an error number from posix_spawn or fork.
+#ifdef LICHEM_SPAWN_CHDIR
+  //Set up the redirection
+  posix_spawn_file_actions_t Redirect;
+  posix_spawn_file_actions_init(&Redirect);
+  if (WorkDir != "")
+  {
+    //Change directory before opening the files
+    posix_spawn_file_actions_addchdir_np(&Redirect,WorkDir.c_str());
+  }
+  if (InFile != "")
+  {
+    posix_spawn_file_actions_addopen(&Redirect,STDIN_FILENO,
+                                     InFile.c_str(),O_RDONLY,0);
+  }
+  if (OutFile != "")
+  {
+    posix_spawn_file_actions_addopen(&Redirect,STDOUT_FILENO,
+                                     OutFile.c_str(),
+                                     O_WRONLY|O_CREAT|O_TRUNC,0644);
+  }
+  int SpawnErr = posix_spawnp(&ProcID,ArgV[0],&Redirect,NULL,&ArgV[0],
+                              environ);
+  posix_spawn_file_actions_destroy(&Redirect);
+  return SpawnErr;
+#else
+  //Older C libraries cannot change directories in posix_spawn
+  //NB: Only system calls are used between fork and exec, so the child is
+  //safe to create from a threaded process
+  ProcID = fork();
+  if (ProcID < 0)
+  {
+    return errno;
+  }
+  if (ProcID == 0)
+  {
+    //Set up the child and replace it with the program
+    if ((WorkDir != "") and (chdir(WorkDir.c_str()) != 0))
+    {
+      _exit(127);
+    }
+    if (InFile != "")
+    {
+      int FileID = open(InFile.c_str(),O_RDONLY);
+      if ((FileID < 0) or (dup2(FileID,STDIN_FILENO) < 0))
+      {
+        _exit(127);
+      }
+      close(FileID);
+    }
+    if (OutFile != "")
+    {
+      int FileID = open(OutFile.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+      if ((FileID < 0) or (dup2(FileID,STDOUT_FILENO) < 0))
+      {
+        _exit(127);
+      }
+      close(FileID);
+    }
+    execvp(ArgV[0],&ArgV[0]);
+    _exit(127); //Same value as a shell that cannot find a program
+  }
+  return 0;
+#endif
+};
+
+int LICHEMSpawn(const string& Cmd, const string& WorkDir,
+                const string& InFile, const string& OutFile, double& WallTime)
+{
+  //Function to run a program and wait for it to finish
+  //NB: Cmd is split into arguments at white space and the program is found
+  //with PATH. The program runs in WorkDir, and the file names are relative
+  //to WorkDir. Empty names keep the current directory, stdin, or stdout. The
+  //exit status is returned, or 127 if the program could not be started.
+  vector<string> Args = LICHEMSplitArgs(Cmd); //Program name and arguments
+  WallTime = 0;
+  if (Args.size() == 0)
+  {
+    //Nothing to run
+    return 0;
+  }
+  vector<char*> ArgV; //Null terminated list for posix_spawn
+  for (unsigned int i=0;i<Args.size();i++)
+  {
+    ArgV.push_back(&Args[i][0]);
+  }
+  ArgV.push_back(NULL);
+  //Run the program
+  int ExitStatus = 127; //Same value as a shell that cannot find a program
+  pid_t ProcID;
+  chrono::steady_clock::time_point tstart = chrono::steady_clock::now();
+  int SpawnErr = LICHEMStartProc(ProcID,ArgV,WorkDir,InFile,OutFile);
+  if (SpawnErr == 0)
+  {
+    //Wait for the program to finish
+    int Status = 0;
+    while (waitpid(ProcID,&Status,0) < 0)
+    {
+      if (errno != EINTR)
+      {
+        break;
+      }
+    }
+    if (WIFEXITED(Status))
+    {
+      ExitStatus = WEXITSTATUS(Status);
+    }
+    else if (WIFSIGNALED(Status))
+    {
+      ExitStatus = 128+WTERMSIG(Status);
+    }
+  }
+  else
+  {
+    cerr << "Error: Could not start " << Args[0] << "!!!";
+    cerr << '\n';
+    cerr.flush();
+  }
+  WallTime = chrono::duration<double>(chrono::steady_clock::now()-
+                                      tstart).count();
+  //Update statistics
+  #pragma omp critical(LICHEMSpawnStats)
+  {
+    Nlaunches += 1;
+    LaunchTime += WallTime;
+    if (ExitStatus != 0)
+    {
+      LaunchFails += 1;
+    }
+  }
+  return ExitStatus;
+};
+
+int LICHEMSpawn(const string& Cmd, const string& WorkDir,
+                const string& InFile, const string& OutFile)
+{
+  //Function to run a program when the wall time is not needed
+  double WallTime; //Discarded
+  return LICHEMSpawn(Cmd,WorkDir,InFile,OutFile,WallTime);
+};
+
+//File management functions
+vector<string> LICHEMMatchFiles(const string& Pattern)
+{
+  //Function to list the existing files that match a name or a pattern
+  vector<string> Files; //Matching files
+  if (Pattern.find_first_of("*?[") == string::npos)
+  {
+    //Simple file name
+    if (CheckFile(Pattern))
+    {
+      Files.push_back(Pattern);
+    }
+    return Files;
+  }
+  glob_t Matches;
+  if (glob(Pattern.c_str(),0,NULL,&Matches) == 0)
+  {
+    for (size_t i=0;i<Matches.gl_pathc;i++)
+    {
+      Files.push_back(string(Matches.gl_pathv[i]));
+    }
+  }
+  globfree(&Matches);
+  return Files;
+};
+
+string LICHEMDestName(const string& Src, const string& Dest)
+{
+  //Function to find the name of a copied or moved file
+  struct stat buffer;
+  if ((stat(Dest.c_str(),&buffer) == 0) and S_ISDIR(buffer.st_mode))
+  {
+    //Keep the file name when the destination is a directory
+    size_t NameStart = Src.find_last_of('/');
+    if (NameStart == string::npos)
+    {
+      NameStart = 0;
+    }
+    else
+    {
+      NameStart += 1;
+    }
+    return Dest+"/"+Src.substr(NameStart);
+  }
+  return Dest;
+};
+
+string LICHEMFullPath(const string& Name)
+{
+  //Function to find the absolute name of a file in the working directory
+  if ((Name == "") or (Name[0] == '/'))
+  {
+    //Already absolute
+    return Name;
+  }
+  char WorkDir[4096]; //Working directory
+  if (getcwd(WorkDir,sizeof(WorkDir)) == NULL)
+  {
+    //Keep the relative name
+    return Name;
+  }
+  if (Name == ".")
+  {
+    //Working directory
+    return string(WorkDir);
+  }
+  return string(WorkDir)+"/"+Name;
+};
+
+bool LICHEMCopyFile(const string& Src, const string& Dest)
+{
+  //Function to copy files, equivalent to "cp -f Src Dest"
+  //NB: Src can be a pattern if Dest is a directory
+  bool AllCopied = 1; //Flag for errors
+  vector<string> Files = LICHEMMatchFiles(Src);
+  if (Files.size() == 0)
+  {
+    return 0;
+  }
+  for (unsigned int i=0;i<Files.size();i++)
+  {
+    string NewName = LICHEMDestName(Files[i],Dest);
+    ifstream ifile(Files[i].c_str(),ios_base::in|ios_base::binary);
+    ofstream ofile(NewName.c_str(),
+                   ios_base::out|ios_base::trunc|ios_base::binary);
+    if ((!ifile.good()) or (!ofile.good()))
+    {
+      AllCopied = 0;
+      continue;
+    }
+    if (ifile.peek() != char_traits<char>::eof())
+    {
+      //Empty files do not need to be copied
+      ofile << ifile.rdbuf();
+    }
+    ofile.close();
+    ifile.close();
+  }
+  return AllCopied;
+};
+
+string LICHEMReadFile(const string& FileName)
+{
+  //Function to read the whole contents of a file
+  ifstream ifile(FileName.c_str(),ios_base::in|ios_base::binary);
+  stringstream Text; //File contents
+  if (ifile.good() and (ifile.peek() != char_traits<char>::eof()))
+  {
+    Text << ifile.rdbuf();
+  }
+  ifile.close();
+  return Text.str();
+};
+
+bool LICHEMMoveFile(const string& Src, const string& Dest)
+{
+  //Function to move files, equivalent to "mv -f Src Dest"
+  //NB: Src can be a pattern, and only the first match is used unless Dest
+  //is a directory
+  bool AllMoved = 1; //Flag for errors
+  vector<string> Files = LICHEMMatchFiles(Src);
+  if (Files.size() == 0)
+  {
+    return 0;
+  }
+  for (unsigned int i=0;i<Files.size();i++)
+  {
+    string NewName = LICHEMDestName(Files[i],Dest);
+    if (rename(Files[i].c_str(),NewName.c_str()) != 0)
+    {
+      //Copy between file systems
+      if (LICHEMCopyFile(Files[i],NewName))
+      {
+        unlink(Files[i].c_str());
+      }
+      else
+      {
+        AllMoved = 0;
+      }
+    }
+    if (NewName == Dest)
+    {
+      //Only one file can be moved to a file name
+      break;
+    }
+  }
+  return AllMoved;
+};
+
+void LICHEMRemoveFiles(const string& FileList)
+{
+  //Function to delete files, equivalent to "rm -f FileList"
+  //NB: FileList is a space separated list of names and patterns
+  stringstream line(FileList);
+  string Pattern; //File name or pattern
+  while (line >> Pattern)
+  {
+    vector<string> Files = LICHEMMatchFiles(Pattern);
+    for (unsigned int i=0;i<Files.size();i++)
+    {
+      unlink(Files[i].c_str());
+    }
+  }
+  return;
+};
+
+int LICHEMRemoveTreeItem(const char* Path, const struct stat* Info,
+                         int Flag, struct FTW* Walk)
+{
+  //Callback to delete one file or empty directory for nftw
+  return remove(Path);
+};
+
+void LICHEMRemoveDir(const string& DirName)
+{
+  //Function to delete a directory, equivalent to "rm -rf DirName"
+  if (CheckFile(DirName))
+  {
+    nftw(DirName.c_str(),LICHEMRemoveTreeItem,16,FTW_DEPTH|FTW_PHYS);
+  }
+  return;
+};
+
+bool LICHEMMakeDir(const string& DirName)
+{
+  //Function to create a directory, equivalent to "mkdir -p DirName"
+  struct stat buffer;
+  if (mkdir(DirName.c_str(),0755) == 0)
+  {
+    return 1;
+  }
+  //Existing directories are not errors
+  if ((stat(DirName.c_str(),&buffer) == 0) and S_ISDIR(buffer.st_mode))
+  {
+    return 1;
+  }
+  return 0;
+};
+
+//Scratch directory functions
+string LICHEMJobDir(int Bead)
+{
+  //Function to find the directory for the files of a bead
+  //NB: The name ends with a slash so that it can be placed in front of a
+  //file name, and it is empty when the files are in the working directory.
+  //Monte Carlo chains after the first have their own bead directories.
+  if (ScratchTop == "")
+  {
+    return "";
+  }
+  stringstream call; //Directory name
+  call << ScratchTop << "/";
+  if (JobChain > 0)
+  {
+    call << "Chain_" << JobChain << "/";
+  }
+  call << "Bead_" << Bead << "/";
+  return call.str();
+};
+
+int LICHEMJobID(QMMMSettings& QMMMOpts, int Bead)
+{
+  //Function to find the position of a bead in the lists of MM programs
+  //and saved MM results, which are shared by all Monte Carlo chains
+  return QMMMOpts.Chain*QMMMOpts.Nbeads+Bead;
+};
+
+void LICHEMMakeScratch(QMMMSettings& QMMMOpts)
+{
+  //Function to create the private scratch directories of the beads
+  //NB: Restart files from a previous run are copied into the scratch
+  //directories, and LICHEMCloseScratch moves them back when LICHEM exits
+  if (QMMMOpts.ScratchDir == "")
+  {
+    //Use the working directory
+    return;
+  }
+  char HostName[256]; //Name of the node
+  if (gethostname(HostName,sizeof(HostName)) != 0)
+  {
+    HostName[0] = 0;
+  }
+  HostName[sizeof(HostName)-1] = 0;
+  stringstream call; //Generic stream for file names
+  call << QMMMOpts.ScratchDir << "/LICHEM_" << HostName << "_" << getpid();
+  ScratchTop = call.str();
+  if (!LICHEMMakeDir(ScratchTop))
+  {
+    //Quit if the scratch space cannot be used
+    cerr << "Error: Could not create the scratch directory ";
+    cerr << ScratchTop << "!!!";
+    cerr << '\n';
+    cerr.flush();
+    exit(0);
+  }
+  //Clean up on every exit
+  atexit(LICHEMCloseScratch);
+  //Create the bead directories of each Monte Carlo chain
+  for (int c=0;c<QMMMOpts.Nchains;c++)
+  {
+    JobChain = c;
+    call.str("");
+    call << ScratchTop << "/Chain_" << c;
+    if ((c > 0) and (!LICHEMMakeDir(call.str())))
+    {
+      cerr << "Error: Could not create the scratch directory ";
+      cerr << call.str() << "!!!";
+      cerr << '\n';
+      cerr.flush();
+      exit(0);
+    }
+    for (int i=0;i<QMMMOpts.Nbeads;i++)
+    {
+      if (!LICHEMMakeDir(LICHEMJobDir(i)))
+      {
+        cerr << "Error: Could not create the scratch directory ";
+        cerr << LICHEMJobDir(i) << "!!!";
+        cerr << '\n';
+        cerr.flush();
+        exit(0);
+      }
+      //Copy restart files (Gaussian, PSI4, and NWChem)
+      call.str("");
+      call << "LICHM_" << i << ".chk";
+      LICHEMCopyFile(call.str(),LICHEMJobDir(i));
+      call.str("");
+      call << "LICHM_" << i << ".180";
+      LICHEMCopyFile(call.str(),LICHEMJobDir(i));
+      call.str("");
+      call << "LICHM_" << i << ".movecs";
+      LICHEMCopyFile(call.str(),LICHEMJobDir(i));
+      call.str("");
+      call << "LICHM_" << i << ".db";
+      LICHEMCopyFile(call.str(),LICHEMJobDir(i));
+    }
+  }
+  JobChain = 0;
+  return;
+};
+
+void LICHEMCloseScratch()
+{
+  //Function to save the restart files and delete the scratch directories
+  if (ScratchTop == "")
+  {
+    //Nothing to clean up
+    return;
+  }
+  //Move the restart files back to the working directory
+  LICHEMMoveFile(ScratchTop+"/Bead_*/LICHM_*.chk",".");
+  LICHEMMoveFile(ScratchTop+"/Bead_*/LICHM_*.180",".");
+  LICHEMMoveFile(ScratchTop+"/Bead_*/LICHM_*.movecs",".");
+  LICHEMMoveFile(ScratchTop+"/Bead_*/LICHM_*.db",".");
+  //Delete everything else
+  LICHEMRemoveDir(ScratchTop);
+  ScratchTop = "";
+  return;
+};
+
+
+//Job control functions
+vector<int> LICHEMCoreList()
+{
+  //Function to list the processors which the calling thread can use
+  vector<int> Cores; //Processor IDs
+  cpu_set_t Mask; //Affinity of the thread
+  CPU_ZERO(&Mask);
+  if (sched_getaffinity(0,sizeof(Mask),&Mask) == 0)
+  {
+    for (int i=0;i<CPU_SETSIZE;i++)
+    {
+      if (CPU_ISSET(i,&Mask))
+      {
+        Cores.push_back(i);
+      }
+    }
+  }
+  return Cores;
+};
+
+bool LICHEMPinCores(const vector<int>& Cores)
+{
+  //Function to keep the calling thread on a set of processors
+  //NB: Programs started by the thread inherit the processors
+  if (Cores.size() == 0)
+  {
+    //Nothing to change
+    return 0;
+  }
+  cpu_set_t Mask; //New affinity of the thread
+  CPU_ZERO(&Mask);
+  for (unsigned int i=0;i<Cores.size();i++)
+  {
+    CPU_SET(Cores[i],&Mask);
+  }
+  return (sched_setaffinity(0,sizeof(Mask),&Mask) == 0);
+};
+
+bool LICHEMMMUsesQMCharges(QMMMSettings& QMMMOpts)
+{
+  //Function to check if the MM energy needs the charges from the QM energy
+  //NB: The MM energy inputs set the QM charges to zero, so only the TINKER
+  //polarization correction uses them. The unfinished AMBER and LAMMPS
+  //wrappers always wait for the QM calculation.
+  if (TINKER and (!AMOEBA) and (!GEM) and (!QMMMOpts.UseImpSolv))
+  {
+    return 0;
+  }
+  return 1;
+};
+
+double LICHEMQMEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                      int Bead)
+{
+  //Function to run the QM wrapper for an energy calculation
+  double E = 0;
+  if (Gaussian)
+  {
+    E += GaussianEnergy(Struct,QMMMOpts,Bead);
+  }
+  if (PSI4)
+  {
+    E += PSI4Energy(Struct,QMMMOpts,Bead);
+    //Delete annoying useless files
+    PSI4Cleanup(Bead);
+  }
+  if (NWChem)
+  {
+    E += NWChemEnergy(Struct,QMMMOpts,Bead);
+  }
+  return E;
+};
+
+double LICHEMMMEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                      int Bead)
+{
+  //Function to run the MM wrapper for an energy calculation
+  double E = 0;
+  if (TINKER)
+  {
+    E += TINKEREnergy(Struct,QMMMOpts,Bead);
+  }
+  if (AMBER)
+  {
+    E += AMBEREnergy(Struct,QMMMOpts,Bead);
+  }
+  if (LAMMPS)
+  {
+    E += LAMMPSEnergy(Struct,QMMMOpts,Bead);
+  }
+  return E;
+};
+
+double LICHEMQMForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
+                      QMMMSettings& QMMMOpts, int Bead)
+{
+  //Function to run the QM wrapper for a force calculation
+  double E = 0;
+  if (Gaussian)
+  {
+    E += GaussianForces(Struct,Forces,QMMMOpts,Bead);
+  }
+  if (PSI4)
+  {
+    E += PSI4Forces(Struct,Forces,QMMMOpts,Bead);
+    //Delete annoying useless files
+    PSI4Cleanup(Bead);
+  }
+  if (NWChem)
+  {
+    E += NWChemForces(Struct,Forces,QMMMOpts,Bead);
+  }
+  return E;
+};
+
+double LICHEMMMForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
+                      QMMMSettings& QMMMOpts, int Bead)
+{
+  //Function to run the MM wrapper for the forces on the QM and PB atoms
+  double E = 0;
+  if (TINKER)
+  {
+    E += TINKERForces(Struct,Forces,QMMMOpts,Bead);
+    if (AMOEBA or QMMMOpts.UseImpSolv)
+    {
+      //Forces from MM polarization
+      E += TINKERPolForces(Struct,Forces,QMMMOpts,Bead);
+    }
+  }
+  if (AMBER)
+  {
+    E += AMBERForces(Struct,Forces,QMMMOpts,Bead);
+  }
+  if (LAMMPS)
+  {
+    E += LAMMPSForces(Struct,Forces,QMMMOpts,Bead);
+  }
+  return E;
+};
+
+double LICHEMBeadEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                        int Bead, double& Eqm, double& Emm)
+{
+  //Function to calculate the QM and MM energies of a bead
+  /*
+    NB: The QM and MM programs run at the same time when the MM energy does
+    not need the new QM charges, otherwise the MM calculation starts after
+    the QM calculation. If the thread has more than Ncpus processors, the QM
+    program is kept on the first Ncpus processors and the MM program gets
+    the rest, so that the two programs do not compete for processors.
+  */
+  Eqm = 0;
+  Emm = 0;
+  int Tqm = 0; //QM wall time
+  int Tmm = 0; //MM wall time
+  bool Overlap = (QMMM and (!LICHEMMMUsesQMCharges(QMMMOpts)));
+  //Divide the processors
+  vector<int> Cores = LICHEMCoreList(); //Processors for the bead
+  vector<int> QMCores,MMCores; //Processors for each program
+  if (Overlap and ((int)Cores.size() > Ncpus))
+  {
+    QMCores.assign(Cores.begin(),Cores.begin()+Ncpus);
+    MMCores.assign(Cores.begin()+Ncpus,Cores.end());
+  }
+  //Run the wrappers
+  #pragma omp parallel sections num_threads(2) if(Overlap) copyin(JobChain)
+  {
+    #pragma omp section
+    {
+      //Calculate QM energy
+      vector<int> OldCores = LICHEMCoreList();
+      bool Pinned = LICHEMPinCores(QMCores);
+      int tstart = (unsigned)time(0);
+      Eqm = LICHEMQMEnergy(Struct,QMMMOpts,Bead);
+      Tqm = (unsigned)time(0)-tstart;
+      if (Pinned)
+      {
+        LICHEMPinCores(OldCores);
+      }
+    }
+    #pragma omp section
+    {
+      //Calculate MM energy
+      vector<int> OldCores = LICHEMCoreList();
+      bool Pinned = LICHEMPinCores(MMCores);
+      int tstart = (unsigned)time(0);
+      Emm = LICHEMMMEnergy(Struct,QMMMOpts,Bead);
+      Tmm = (unsigned)time(0)-tstart;
+      if (Pinned)
+      {
+        LICHEMPinCores(OldCores);
+      }
+    }
+  }
+  //Update timers
+  #pragma omp atomic
+  QMTime += Tqm;
+  #pragma omp atomic
+  MMTime += Tmm;
+  return Eqm+Emm;
+};
+
+double LICHEMBeadEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                        int Bead)
+{
+  //Function to calculate the total energy of a bead
+  double Eqm,Emm; //Discarded
+  return LICHEMBeadEnergy(Struct,QMMMOpts,Bead,Eqm,Emm);
+};
+
+void LICHEMBeadEnergies(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                        const vector<int>& Beads, vector<double>& Eqm,
+                        vector<double>& Emm)
+{
+  //Function to calculate the QM and MM energies of a set of beads
+  //NB: The energies are saved in Eqm and Emm at the bead IDs. The QM and
+  //MM calculations are separate jobs when the MM energy does not need the
+  //new QM charges.
+  int Nb = Beads.size(); //Number of beads
+  if (Nb == 0)
+  {
+    //Nothing to calculate
+    return;
+  }
+  if (Nb == 1)
+  {
+    //Divide the processors between the QM and MM programs
+    int p = Beads[0]; //Bead ID
+    BeadJobs.Order(Beads);
+    BeadJobs.Start(p);
+    LICHEMBeadEnergy(Struct,QMMMOpts,p,Eqm[p],Emm[p]);
+    BeadJobs.Finish(p);
+    return;
+  }
+  bool Overlap = (QMMM and (!LICHEMMMUsesQMCharges(QMMMOpts)));
+  int Njobs = Nb; //Number of wrapper calls
+  if (Overlap)
+  {
+    Njobs = 2*Nb;
+  }
+  vector<int> Order = BeadJobs.Order(Beads); //Most expensive beads first
+  int Tqm = 0; //QM wall time
+  int Tmm = 0; //MM wall time
+  #pragma omp parallel for schedule(dynamic) \
+          num_threads(BeadJobs.Slots(Njobs)) reduction(+:Tqm,Tmm) \
+          copyin(JobChain)
+  for (int j=0;j<Njobs;j++)
+  {
+    int p = Order[j%Nb]; //Bead ID
+    bool RunQM = ((!Overlap) or (j < Nb)); //QM job for the bead
+    bool RunMM = ((!Overlap) or (j >= Nb)); //MM job for the bead
+    if (RunQM)
+    {
+      //Only the QM calculations are used for the costs
+      BeadJobs.Start(p);
+    }
+    else
+    {
+      BeadJobs.Pin();
+    }
+    //Calculate QM energy
+    if (RunQM)
+    {
+      int tstart = (unsigned)time(0);
+      Eqm[p] = LICHEMQMEnergy(Struct,QMMMOpts,p);
+      Tqm += (unsigned)time(0)-tstart;
+    }
+    //Calculate MM energy
+    if (RunMM)
+    {
+      int tstart = (unsigned)time(0);
+      Emm[p] = LICHEMMMEnergy(Struct,QMMMOpts,p);
+      Tmm += (unsigned)time(0)-tstart;
+    }
+    if (RunQM)
+    {
+      BeadJobs.Finish(p);
+    }
+    else
+    {
+      BeadJobs.Unpin();
+    }
+  }
+  //Update timers
+  #pragma omp atomic
+  QMTime += Tqm;
+  #pragma omp atomic
+  MMTime += Tmm;
+  return;
+};
+
+void LICHEMBeadForces(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                      const vector<int>& Beads, vector<double>& Eqm,
+                      vector<double>& Emm, vector<VectorXd>& Forces)
+{
+  //Function to calculate the QM and MM energies of a set of beads and the
+  //forces on the QM and PB atoms
+  //NB: The results are saved at the bead IDs. The MM calculations of a
+  //bead start after the QM calculation.
+  int Nb = Beads.size(); //Number of beads
+  int Ndof = 3*(Nqm+Npseudo); //Number of QM and PB coordinates
+  vector<int> Order = BeadJobs.Order(Beads); //Most expensive beads first
+  int Tqm = 0; //QM wall time
+  int Tmm = 0; //MM wall time
+  #pragma omp parallel for schedule(dynamic) \
+          num_threads(BeadJobs.Slots(Nb)) reduction(+:Tqm,Tmm) \
+          copyin(JobChain)
+  for (int j=0;j<Nb;j++)
+  {
+    int p = Order[j]; //Bead ID
+    VectorXd F(Ndof); //Forces on the bead
+    F.setZero();
+    BeadJobs.Start(p);
+    //Calculate QM energy and forces
+    int tstart = (unsigned)time(0);
+    Eqm[p] = LICHEMQMForces(Struct,F,QMMMOpts,p);
+    Tqm += (unsigned)time(0)-tstart;
+    //Calculate MM energy and forces
+    tstart = (unsigned)time(0);
+    Emm[p] = LICHEMMMEnergy(Struct,QMMMOpts,p);
+    LICHEMMMForces(Struct,F,QMMMOpts,p);
+    Tmm += (unsigned)time(0)-tstart;
+    Forces[p] = F;
+    BeadJobs.Finish(p);
+  }
+  //Update timers
+  #pragma omp atomic
+  QMTime += Tqm;
+  #pragma omp atomic
+  MMTime += Tmm;
+  return;
+};
+
+void LICHEMRingEnergies(vector<QMMMAtom>& Struct, vector<QMMMAtom>& Ring,
+                        QMMMSettings& QMMMOpts, const vector<int>& Beads,
+                        vector<double>& Eqm, vector<double>& Emm)
+{
+  //Function to calculate the QM energies of every bead of a contracted
+  //ring and the MM energies of a set of beads of the full ring
+  //NB: The QM and MM calculations are always separate jobs, so the MM
+  //energy must not need the QM charges
+  int Nq = Eqm.size(); //Number of contracted beads
+  int Nb = Beads.size(); //Number of MM beads
+  int Njobs = Nq+Nb; //Number of wrapper calls
+  vector<int> QMBeads; //Contracted bead IDs
+  for (int p=0;p<Nq;p++)
+  {
+    QMBeads.push_back(p);
+  }
+  vector<int> Order = BeadJobs.Order(QMBeads); //Most expensive beads first
+  int Tqm = 0; //QM wall time
+  int Tmm = 0; //MM wall time
+  #pragma omp parallel for schedule(dynamic) \
+          num_threads(BeadJobs.Slots(Njobs)) reduction(+:Tqm,Tmm) \
+          copyin(JobChain)
+  for (int j=0;j<Njobs;j++)
+  {
+    if (j < Nq)
+    {
+      //Calculate QM energy of a contracted bead
+      int p = Order[j]; //Bead ID
+      BeadJobs.Start(p);
+      int tstart = (unsigned)time(0);
+      Eqm[p] = LICHEMQMEnergy(Ring,QMMMOpts,p);
+      Tqm += (unsigned)time(0)-tstart;
+      BeadJobs.Finish(p);
+    }
+    else
+    {
+      //Calculate MM energy of a bead
+      int p = Beads[j-Nq]; //Bead ID
+      BeadJobs.Pin();
+      int tstart = (unsigned)time(0);
+      Emm[p] = LICHEMMMEnergy(Struct,QMMMOpts,p);
+      Tmm += (unsigned)time(0)-tstart;
+      BeadJobs.Unpin();
+    }
+  }
+  //Update timers
+  #pragma omp atomic
+  QMTime += Tqm;
+  #pragma omp atomic
+  MMTime += Tmm;
+  return;
+};
+
+MatrixXd LICHEMBeadHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                           int Bead)
+{
+  //Function to calculate the QMMM Hessian of a bead
+  int Ndof = 3*(Nqm+Npseudo); //Number of degrees of freedom
+  MatrixXd QMMMHess(Ndof,Ndof);
+  QMMMHess.setZero();
+  int Tqm = 0; //QM wall time
+  int Tmm = 0; //MM wall time
+  //Calculate QM Hessian
+  int tstart = (unsigned)time(0);
+  if (Gaussian)
+  {
+    QMMMHess += GaussianHessian(Struct,QMMMOpts,Bead);
+  }
+  if (PSI4)
+  {
+    QMMMHess += PSI4Hessian(Struct,QMMMOpts,Bead);
+    //Delete annoying useless files
+    PSI4Cleanup(Bead);
+  }
+  if (NWChem)
+  {
+    QMMMHess += NWChemHessian(Struct,QMMMOpts,Bead);
+  }
+  Tqm = (unsigned)time(0)-tstart;
+  //Calculate MM Hessian
+  tstart = (unsigned)time(0);
+  if (TINKER)
+  {
+    QMMMHess += TINKERHessian(Struct,QMMMOpts,Bead);
+  }
+  if (AMBER)
+  {
+    QMMMHess += AMBERHessian(Struct,QMMMOpts,Bead);
+  }
+  if (LAMMPS)
+  {
+    QMMMHess += LAMMPSHessian(Struct,QMMMOpts,Bead);
+  }
+  Tmm = (unsigned)time(0)-tstart;
+  //Update timers
+  #pragma omp atomic
+  QMTime += Tqm;
+  #pragma omp atomic
+  MMTime += Tmm;
+  return QMMMHess;
+};
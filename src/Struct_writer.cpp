@@ -25,7 +25,7 @@ void WriteGauInput(vector<QMMMAtom>& Struct, string CalcTyp,
   //Check for a charge file
   bool UseChargeFile = 0;
   call.str("");
-  call << "MMCharges_" << Bead << ".txt";
+  call << LICHEMJobDir(Bead) << "MMCharges_" << Bead << ".txt";
   chrgfilename = call.str();
   UseChargeFile = CheckFile(call.str());
   if (Nmm == 0)
@@ -36,11 +36,13 @@ void WriteGauInput(vector<QMMMAtom>& Struct, string CalcTyp,
   //Initialize multipoles and center of mass
   bool FirstCharge = 1; //Always write the first charge
   Coord QMCOM;
+  VectorXd DxCOM,DyCOM,DzCOM; //Displacements from the QM COM
   if (!UseChargeFile)
   {
     if (PBCon or QMMMOpts.UseLREC)
     {
       QMCOM = FindQMCOM(Struct,QMMMOpts,Bead);
+      BeadDist2(Struct,QMCOM,Bead,DxCOM,DyCOM,DzCOM);
     }
     if (AMOEBA)
     {
@@ -53,7 +55,7 @@ void WriteGauInput(vector<QMMMAtom>& Struct, string CalcTyp,
   }
   //Construct g09 input
   call.str("");
-  call << "LICHM_" << Bead << ".com";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".com";
   ofile.open(call.str().c_str(),ios_base::out);
   call.str("");
   call << "%chk=LICHM_" << Bead << ".chk";
@@ -114,74 +116,74 @@ void WriteGauInput(vector<QMMMAtom>& Struct, string CalcTyp,
   {
     if (CHRG)
     {
-      for (int i=0;i<Natoms;i++)
+      for (unsigned int m=0;m<MMList.size();m++)
       {
-        if (Struct[i].MMregion)
+        int i = MMList[m]; //Atom ID
+        //Check PBC (minimum image convention)
+        Coord DistCent; //Distance from QM COM
+        double xshft = 0;
+        double yshft = 0;
+        double zshft = 0;
+        if (PBCon or QMMMOpts.UseLREC)
         {
-          //Check PBC (minimum image convention)
-          Coord DistCent; //Distance from QM COM
-          double xshft = 0;
-          double yshft = 0;
-          double zshft = 0;
-          if (PBCon or QMMMOpts.UseLREC)
+          //Initialize displacements
+          double dx,dy,dz; //Starting displacements
+          dx = Struct[i].P[Bead].x-QMCOM.x;
+          dy = Struct[i].P[Bead].y-QMCOM.y;
+          dz = Struct[i].P[Bead].z-QMCOM.z;
+          DistCent.x = DxCOM(i);
+          DistCent.y = DyCOM(i);
+          DistCent.z = DzCOM(i);
+          //Calculate the shift in positions
+          //NB: Generally this work out to be +/- {Lx,Ly,Lz}
+          if (PBCon)
           {
-            //Initialize displacements
-            double dx,dy,dz; //Starting displacements
-            dx = Struct[i].P[Bead].x-QMCOM.x;
-            dy = Struct[i].P[Bead].y-QMCOM.y;
-            dz = Struct[i].P[Bead].z-QMCOM.z;
-            DistCent = CoordDist2(Struct[i].P[Bead],QMCOM);
-            //Calculate the shift in positions
-            //NB: Generally this work out to be +/- {Lx,Ly,Lz}
-            if (PBCon)
-            {
-              xshft = DistCent.x-dx;
-              yshft = DistCent.y-dy;
-              zshft = DistCent.z-dz;
-            }
+            xshft = DistCent.x-dx;
+            yshft = DistCent.y-dy;
+            zshft = DistCent.z-dz;
           }
-          //Check for long-range corrections
-          double scrq = 1;
-          if (QMMMOpts.UseLREC)
+        }
+        //Check for long-range corrections
+        double scrq = 1;
+        if (QMMMOpts.UseLREC)
+        {
+          //Use the long-range correction
+          double rcom = 0; //Distance from center of mass
+          //Calculate the distance from the center of mass
+          rcom = DistCent.VecMag();
+          if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
           {
-            //Use the long-range correction
-            double rcom = 0; //Distance from center of mass
-            //Calculate the distance from the center of mass
-            rcom = DistCent.VecMag();
-            if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
-            {
-              //Scale the charge
-              rcom = sqrt(rcom);
-              double scrqA,scrqB; //Temporary variables
-              //Calculate temp. variables
-              scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
-              scrqB = -3*scrqA*scrqA;
-              scrqA *= 2*scrqA*scrqA;
-              //Combine temp. variables
-              scrqA += scrqB+1;
-              //Set the scale factor
-              scrq -= pow(scrqA,QMMMOpts.LRECPow);
-            }
-            else
-            {
-              //Delete the charge
-              scrq = 0;
-            }
+            //Scale the charge
+            rcom = sqrt(rcom);
+            double scrqA,scrqB; //Temporary variables
+            //Calculate temp. variables
+            scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
+            scrqB = -3*scrqA*scrqA;
+            scrqA *= 2*scrqA*scrqA;
+            //Combine temp. variables
+            scrqA += scrqB+1;
+            //Set the scale factor
+            scrq -= pow(scrqA,QMMMOpts.LRECPow);
           }
-          if ((scrq > 0) or FirstCharge)
+          else
           {
-            FirstCharge = 0; //Skips writing the remaining zeros
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].P[Bead].x+xshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].P[Bead].y+yshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].P[Bead].z+zshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].MP[Bead].q*scrq,16);
-            call << '\n';
+            //Delete the charge
+            scrq = 0;
           }
         }
+        if ((scrq > 0) or FirstCharge)
+        {
+          FirstCharge = 0; //Skips writing the remaining zeros
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].P[Bead].x+xshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].P[Bead].y+yshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].P[Bead].z+zshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].MP[Bead].q*scrq,16);
+          call << '\n';
+        }
       }
       if (Nmm > 0)
       {
@@ -190,119 +192,119 @@ void WriteGauInput(vector<QMMMAtom>& Struct, string CalcTyp,
     }
     if (AMOEBA)
     {
-      for (int i=0;i<Natoms;i++)
+      for (unsigned int m=0;m<MMList.size();m++)
       {
-        if (Struct[i].MMregion)
+        int i = MMList[m]; //Atom ID
+        //Check PBC (minimum image convention)
+        Coord DistCent; //Distance from QM COM
+        double xshft = 0;
+        double yshft = 0;
+        double zshft = 0;
+        if (PBCon or QMMMOpts.UseLREC)
         {
-          //Check PBC (minimum image convention)
-          Coord DistCent; //Distance from QM COM
-          double xshft = 0;
-          double yshft = 0;
-          double zshft = 0;
-          if (PBCon or QMMMOpts.UseLREC)
+          //Initialize displacements
+          double dx,dy,dz; //Starting displacements
+          dx = Struct[i].P[Bead].x-QMCOM.x;
+          dy = Struct[i].P[Bead].y-QMCOM.y;
+          dz = Struct[i].P[Bead].z-QMCOM.z;
+          DistCent.x = DxCOM(i);
+          DistCent.y = DyCOM(i);
+          DistCent.z = DzCOM(i);
+          //Calculate the shift in positions
+          //NB: Generally this work out to be +/- {Lx,Ly,Lz}
+          if (PBCon)
           {
-            //Initialize displacements
-            double dx,dy,dz; //Starting displacements
-            dx = Struct[i].P[Bead].x-QMCOM.x;
-            dy = Struct[i].P[Bead].y-QMCOM.y;
-            dz = Struct[i].P[Bead].z-QMCOM.z;
-            DistCent = CoordDist2(Struct[i].P[Bead],QMCOM);
-            //Calculate the shift in positions
-            //NB: Generally this work out to be +/- {Lx,Ly,Lz}
-            if (PBCon)
-            {
-              xshft = DistCent.x-dx;
-              yshft = DistCent.y-dy;
-              zshft = DistCent.z-dz;
-            }
+            xshft = DistCent.x-dx;
+            yshft = DistCent.y-dy;
+            zshft = DistCent.z-dz;
           }
-          //Check for long-range corrections
-          double scrq = 1;
-          if (QMMMOpts.UseLREC)
+        }
+        //Check for long-range corrections
+        double scrq = 1;
+        if (QMMMOpts.UseLREC)
+        {
+          //Use the long-range correction
+          double rcom = 0; //Distance from center of mass
+          //Calculate the distance from the center of mass
+          rcom = DistCent.VecMag();
+          if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
           {
-            //Use the long-range correction
-            double rcom = 0; //Distance from center of mass
-            //Calculate the distance from the center of mass
-            rcom = DistCent.VecMag();
-            if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
-            {
-              //Scale the charge
-              rcom = sqrt(rcom);
-              double scrqA,scrqB; //Temporary variables
-              //Calculate temp. variables
-              scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
-              scrqB = -3*scrqA*scrqA;
-              scrqA *= 2*scrqA*scrqA;
-              //Combine temp. variables
-              scrqA += scrqB+1;
-              //Set the scale factor
-              scrq -= pow(scrqA,QMMMOpts.LRECPow);
-            }
-            else
-            {
-              //Delete the charge
-              scrq = 0;
-            }
+            //Scale the charge
+            rcom = sqrt(rcom);
+            double scrqA,scrqB; //Temporary variables
+            //Calculate temp. variables
+            scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
+            scrqB = -3*scrqA*scrqA;
+            scrqA *= 2*scrqA*scrqA;
+            //Combine temp. variables
+            scrqA += scrqB+1;
+            //Set the scale factor
+            scrq -= pow(scrqA,QMMMOpts.LRECPow);
           }
-          if ((scrq > 0) or FirstCharge)
+          else
           {
-            FirstCharge = 0; //Skips writing the remaining zeros
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x1+xshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y1+yshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z1+zshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q1*scrq,16);
-            call << '\n';
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x2+xshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y2+yshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z2+zshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q2*scrq,16);
-            call << '\n';
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x3+xshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y3+yshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z3+zshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q3*scrq,16);
-            call << '\n';
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x4+xshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y4+yshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z4+zshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q4*scrq,16);
-            call << '\n';
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x5+xshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y5+yshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z5+zshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q5*scrq,16);
-            call << '\n';
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x6+xshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y6+yshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z6+zshft,16);
-            call << " ";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q6*scrq,16);
-            call << '\n';
+            //Delete the charge
+            scrq = 0;
           }
         }
+        if ((scrq > 0) or FirstCharge)
+        {
+          FirstCharge = 0; //Skips writing the remaining zeros
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x1+xshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y1+yshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z1+zshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q1*scrq,16);
+          call << '\n';
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x2+xshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y2+yshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z2+zshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q2*scrq,16);
+          call << '\n';
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x3+xshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y3+yshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z3+zshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q3*scrq,16);
+          call << '\n';
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x4+xshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y4+yshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z4+zshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q4*scrq,16);
+          call << '\n';
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x5+xshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y5+yshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z5+zshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q5*scrq,16);
+          call << '\n';
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x6+xshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y6+yshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z6+zshft,16);
+          call << " ";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q6*scrq,16);
+          call << '\n';
+        }
       }
       if (Nmm > 0)
       {
@@ -339,7 +341,7 @@ void WriteNWChemInput(vector<QMMMAtom>& Struct, string CalcTyp,
   //Check for a charge file
   bool UseChargeFile = 0;
   call.str("");
-  call << "MMCharges_" << Bead << ".txt";
+  call << LICHEMJobDir(Bead) << "MMCharges_" << Bead << ".txt";
   chrgfilename = call.str();
   UseChargeFile = CheckFile(call.str());
   if (Nmm == 0)
@@ -350,11 +352,13 @@ void WriteNWChemInput(vector<QMMMAtom>& Struct, string CalcTyp,
   //Initialize multipoles and center of mass
   bool FirstCharge = 1; //Always write the first charge
   Coord QMCOM;
+  VectorXd DxCOM,DyCOM,DzCOM; //Displacements from the QM COM
   if (!UseChargeFile)
   {
     if (PBCon or QMMMOpts.UseLREC)
     {
       QMCOM = FindQMCOM(Struct,QMMMOpts,Bead);
+      BeadDist2(Struct,QMCOM,Bead,DxCOM,DyCOM,DzCOM);
     }
     if (AMOEBA)
     {
@@ -367,10 +371,10 @@ void WriteNWChemInput(vector<QMMMAtom>& Struct, string CalcTyp,
   }
   //Create NWChem input
   call.str("");
-  call << "LICHM_" << Bead << ".nw";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".nw";
   ofile.open(call.str().c_str(),ios_base::out);
   call.str("");
-  call << "LICHM_" << Bead << ".db";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".db";
   if (CheckFile(call.str()))
   {
     ofile << "restart";
@@ -465,74 +469,74 @@ void WriteNWChemInput(vector<QMMMAtom>& Struct, string CalcTyp,
     {
       ofile << "set bq:max_nbq " << (Nmm+Nbound) << '\n';
       ofile << "bq mmchrg" << '\n';
-      for (int i=0;i<Natoms;i++)
+      for (unsigned int m=0;m<MMList.size();m++)
       {
-        if (Struct[i].MMregion)
+        int i = MMList[m]; //Atom ID
+        //Check PBC (minimum image convention)
+        Coord DistCent; //Distance from QM COM
+        double xshft = 0;
+        double yshft = 0;
+        double zshft = 0;
+        if (PBCon or QMMMOpts.UseLREC)
         {
-          //Check PBC (minimum image convention)
-          Coord DistCent; //Distance from QM COM
-          double xshft = 0;
-          double yshft = 0;
-          double zshft = 0;
-          if (PBCon or QMMMOpts.UseLREC)
+          //Initialize displacements
+          double dx,dy,dz; //Starting displacements
+          dx = Struct[i].P[Bead].x-QMCOM.x;
+          dy = Struct[i].P[Bead].y-QMCOM.y;
+          dz = Struct[i].P[Bead].z-QMCOM.z;
+          DistCent.x = DxCOM(i);
+          DistCent.y = DyCOM(i);
+          DistCent.z = DzCOM(i);
+          //Calculate the shift in positions
+          //NB: Generally this work out to be +/- {Lx,Ly,Lz}
+          if (PBCon)
           {
-            //Initialize displacements
-            double dx,dy,dz; //Starting displacements
-            dx = Struct[i].P[Bead].x-QMCOM.x;
-            dy = Struct[i].P[Bead].y-QMCOM.y;
-            dz = Struct[i].P[Bead].z-QMCOM.z;
-            DistCent = CoordDist2(Struct[i].P[Bead],QMCOM);
-            //Calculate the shift in positions
-            //NB: Generally this work out to be +/- {Lx,Ly,Lz}
-            if (PBCon)
-            {
-              xshft = DistCent.x-dx;
-              yshft = DistCent.y-dy;
-              zshft = DistCent.z-dz;
-            }
+            xshft = DistCent.x-dx;
+            yshft = DistCent.y-dy;
+            zshft = DistCent.z-dz;
           }
-          //Check for long-range corrections
-          double scrq = 1;
-          if (QMMMOpts.UseLREC)
+        }
+        //Check for long-range corrections
+        double scrq = 1;
+        if (QMMMOpts.UseLREC)
+        {
+          //Use the long-range correction
+          double rcom = 0; //Distance from center of mass
+          //Calculate the distance from the center of mass
+          rcom = DistCent.VecMag();
+          if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
           {
-            //Use the long-range correction
-            double rcom = 0; //Distance from center of mass
-            //Calculate the distance from the center of mass
-            rcom = DistCent.VecMag();
-            if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
-            {
-              //Scale the charge
-              rcom = sqrt(rcom);
-              double scrqA,scrqB; //Temporary variables
-              //Calculate temp. variables
-              scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
-              scrqB = -3*scrqA*scrqA;
-              scrqA *= 2*scrqA*scrqA;
-              //Combine temp. variables
-              scrqA += scrqB+1;
-              //Set the scale factor
-              scrq -= pow(scrqA,QMMMOpts.LRECPow);
-            }
-            else
-            {
-              //Delete the charge
-              scrq = 0;
-            }
+            //Scale the charge
+            rcom = sqrt(rcom);
+            double scrqA,scrqB; //Temporary variables
+            //Calculate temp. variables
+            scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
+            scrqB = -3*scrqA*scrqA;
+            scrqA *= 2*scrqA*scrqA;
+            //Combine temp. variables
+            scrqA += scrqB+1;
+            //Set the scale factor
+            scrq -= pow(scrqA,QMMMOpts.LRECPow);
           }
-          if ((scrq > 0) or FirstCharge)
+          else
           {
-            FirstCharge = 0; //Skips writing the remaining zeros
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].P[Bead].x+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].P[Bead].y+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].P[Bead].z+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].MP[Bead].q*scrq,16);
-            ofile << '\n';
+            //Delete the charge
+            scrq = 0;
           }
         }
+        if ((scrq > 0) or FirstCharge)
+        {
+          FirstCharge = 0; //Skips writing the remaining zeros
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].P[Bead].x+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].P[Bead].y+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].P[Bead].z+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].MP[Bead].q*scrq,16);
+          ofile << '\n';
+        }
       }
       ofile << "end" << '\n';
       ofile << "set bq mmchrg" << '\n';
@@ -541,119 +545,119 @@ void WriteNWChemInput(vector<QMMMAtom>& Struct, string CalcTyp,
     {
       ofile << "set bq:max_nbq " << (6*(Nmm+Nbound)) << '\n';
       ofile << "bq mmchrg" << '\n';
-      for (int i=0;i<Natoms;i++)
+      for (unsigned int m=0;m<MMList.size();m++)
       {
-        if (Struct[i].MMregion)
+        int i = MMList[m]; //Atom ID
+        //Check PBC (minimum image convention)
+        Coord DistCent; //Distance from QM COM
+        double xshft = 0;
+        double yshft = 0;
+        double zshft = 0;
+        if (PBCon or QMMMOpts.UseLREC)
         {
-          //Check PBC (minimum image convention)
-          Coord DistCent; //Distance from QM COM
-          double xshft = 0;
-          double yshft = 0;
-          double zshft = 0;
-          if (PBCon or QMMMOpts.UseLREC)
+          //Initialize displacements
+          double dx,dy,dz; //Starting displacements
+          dx = Struct[i].P[Bead].x-QMCOM.x;
+          dy = Struct[i].P[Bead].y-QMCOM.y;
+          dz = Struct[i].P[Bead].z-QMCOM.z;
+          DistCent.x = DxCOM(i);
+          DistCent.y = DyCOM(i);
+          DistCent.z = DzCOM(i);
+          //Calculate the shift in positions
+          //NB: Generally this work out to be +/- {Lx,Ly,Lz}
+          if (PBCon)
           {
-            //Initialize displacements
-            double dx,dy,dz; //Starting displacements
-            dx = Struct[i].P[Bead].x-QMCOM.x;
-            dy = Struct[i].P[Bead].y-QMCOM.y;
-            dz = Struct[i].P[Bead].z-QMCOM.z;
-            DistCent = CoordDist2(Struct[i].P[Bead],QMCOM);
-            //Calculate the shift in positions
-            //NB: Generally this work out to be +/- {Lx,Ly,Lz}
-            if (PBCon)
-            {
-              xshft = DistCent.x-dx;
-              yshft = DistCent.y-dy;
-              zshft = DistCent.z-dz;
-            }
+            xshft = DistCent.x-dx;
+            yshft = DistCent.y-dy;
+            zshft = DistCent.z-dz;
           }
-          //Check for long-range corrections
-          double scrq = 1;
-          if (QMMMOpts.UseLREC)
+        }
+        //Check for long-range corrections
+        double scrq = 1;
+        if (QMMMOpts.UseLREC)
+        {
+          //Use the long-range correction
+          double rcom = 0; //Distance from center of mass
+          //Calculate the distance from the center of mass
+          rcom = DistCent.VecMag();
+          if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
           {
-            //Use the long-range correction
-            double rcom = 0; //Distance from center of mass
-            //Calculate the distance from the center of mass
-            rcom = DistCent.VecMag();
-            if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
-            {
-              //Scale the charge
-              rcom = sqrt(rcom);
-              double scrqA,scrqB; //Temporary variables
-              //Calculate temp. variables
-              scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
-              scrqB = -3*scrqA*scrqA;
-              scrqA *= 2*scrqA*scrqA;
-              //Combine temp. variables
-              scrqA += scrqB+1;
-              //Set the scale factor
-              scrq -= pow(scrqA,QMMMOpts.LRECPow);
-            }
-            else
-            {
-              //Delete the charge
-              scrq = 0;
-            }
+            //Scale the charge
+            rcom = sqrt(rcom);
+            double scrqA,scrqB; //Temporary variables
+            //Calculate temp. variables
+            scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
+            scrqB = -3*scrqA*scrqA;
+            scrqA *= 2*scrqA*scrqA;
+            //Combine temp. variables
+            scrqA += scrqB+1;
+            //Set the scale factor
+            scrq -= pow(scrqA,QMMMOpts.LRECPow);
           }
-          if ((scrq > 0) or FirstCharge)
+          else
           {
-            FirstCharge = 0; //Skips writing the remaining zeros
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x1+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y1+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z1+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q1*scrq,16);
-            ofile << '\n';
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x2+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y2+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z2+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q2*scrq,16);
-            ofile << '\n';
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x3+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y3+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z3+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q3*scrq,16);
-            ofile << '\n';
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x4+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y4+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z4+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q4*scrq,16);
-            ofile << '\n';
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x5+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y5+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z5+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q5*scrq,16);
-            ofile << '\n';
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].x6+xshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].y6+yshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].z6+zshft,16);
-            ofile << " ";
-            ofile << LICHEMFormFloat(Struct[i].PC[Bead].q6*scrq,16);
-            ofile << '\n';
+            //Delete the charge
+            scrq = 0;
           }
         }
+        if ((scrq > 0) or FirstCharge)
+        {
+          FirstCharge = 0; //Skips writing the remaining zeros
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x1+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y1+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z1+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q1*scrq,16);
+          ofile << '\n';
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x2+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y2+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z2+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q2*scrq,16);
+          ofile << '\n';
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x3+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y3+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z3+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q3*scrq,16);
+          ofile << '\n';
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x4+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y4+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z4+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q4*scrq,16);
+          ofile << '\n';
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x5+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y5+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z5+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q5*scrq,16);
+          ofile << '\n';
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].x6+xshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].y6+yshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].z6+zshft,16);
+          ofile << " ";
+          ofile << LICHEMFormFloat(Struct[i].PC[Bead].q6*scrq,16);
+          ofile << '\n';
+        }
       }
       ofile << "end" << '\n';
       ofile << "set bq mmchrg" << '\n';
@@ -669,12 +673,12 @@ void WriteNWChemInput(vector<QMMMAtom>& Struct, string CalcTyp,
   ofile << " xc " << QMMMOpts.Func << '\n';
   //Use the checkpoint file
   call.str("");
-  call << "LICHM_" << Bead << ".movecs";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".movecs";
   if (CheckFile(call.str()))
   {
     //Tell the DFT module to read the initial vectors
     ofile << " vectors input ";
-    ofile << call.str(); //Defined above
+    ofile << "LICHM_" << Bead << ".movecs";
     ofile << '\n';
   }
   ofile << "end" << '\n';
@@ -697,7 +701,7 @@ void WritePSI4Input(vector<QMMMAtom>& Struct, string CalcTyp,
   //Check for a charge file
   bool UseChargeFile = 0;
   call.str("");
-  call << "MMCharges_" << Bead << ".txt";
+  call << LICHEMJobDir(Bead) << "MMCharges_" << Bead << ".txt";
   chrgfilename = call.str();
   UseChargeFile = CheckFile(call.str());
   if (Nmm == 0)
@@ -707,11 +711,13 @@ void WritePSI4Input(vector<QMMMAtom>& Struct, string CalcTyp,
   }
   //Initialize multipoles and center of mass
   Coord QMCOM;
+  VectorXd DxCOM,DyCOM,DzCOM; //Displacements from the QM COM
   if (!UseChargeFile)
   {
     if (PBCon or QMMMOpts.UseLREC)
     {
       QMCOM = FindQMCOM(Struct,QMMMOpts,Bead);
+      BeadDist2(Struct,QMCOM,Bead,DxCOM,DyCOM,DzCOM);
     }
     if (AMOEBA)
     {
@@ -725,7 +731,7 @@ void WritePSI4Input(vector<QMMMAtom>& Struct, string CalcTyp,
   //Check if there is a checkpoint file
   bool UseCheckPoint;
   call.str("");
-  call << "LICHM_" << Bead << ".180";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".180";
   UseCheckPoint = CheckFile(call.str());
   //Set up memory
   call.str("");
@@ -813,70 +819,70 @@ void WritePSI4Input(vector<QMMMAtom>& Struct, string CalcTyp,
     if (CHRG)
     {
       call << "Chrgfield = QMMM()" << '\n';
-      for (int i=0;i<Natoms;i++)
+      for (unsigned int m=0;m<MMList.size();m++)
       {
-        if (Struct[i].MMregion)
+        int i = MMList[m]; //Atom ID
+        //Check PBC (minimum image convention)
+        Coord DistCent; //Distance from QM COM
+        double xshft = 0;
+        double yshft = 0;
+        double zshft = 0;
+        if (PBCon or QMMMOpts.UseLREC)
         {
-          //Check PBC (minimum image convention)
-          Coord DistCent; //Distance from QM COM
-          double xshft = 0;
-          double yshft = 0;
-          double zshft = 0;
-          if (PBCon or QMMMOpts.UseLREC)
+          //Initialize displacements
+          double dx,dy,dz; //Starting displacements
+          dx = Struct[i].P[Bead].x-QMCOM.x;
+          dy = Struct[i].P[Bead].y-QMCOM.y;
+          dz = Struct[i].P[Bead].z-QMCOM.z;
+          DistCent.x = DxCOM(i);
+          DistCent.y = DyCOM(i);
+          DistCent.z = DzCOM(i);
+          //Calculate the shift in positions
+          //NB: Generally this work out to be +/- {Lx,Ly,Lz}
+          if (PBCon)
           {
-            //Initialize displacements
-            double dx,dy,dz; //Starting displacements
-            dx = Struct[i].P[Bead].x-QMCOM.x;
-            dy = Struct[i].P[Bead].y-QMCOM.y;
-            dz = Struct[i].P[Bead].z-QMCOM.z;
-            DistCent = CoordDist2(Struct[i].P[Bead],QMCOM);
-            //Calculate the shift in positions
-            //NB: Generally this work out to be +/- {Lx,Ly,Lz}
-            if (PBCon)
-            {
-              xshft = DistCent.x-dx;
-              yshft = DistCent.y-dy;
-              zshft = DistCent.z-dz;
-            }
+            xshft = DistCent.x-dx;
+            yshft = DistCent.y-dy;
+            zshft = DistCent.z-dz;
           }
-          //Check for long-range corrections
-          double scrq = 1;
-          if (QMMMOpts.UseLREC)
+        }
+        //Check for long-range corrections
+        double scrq = 1;
+        if (QMMMOpts.UseLREC)
+        {
+          //Use the long-range correction
+          double rcom = 0; //Distance from center of mass
+          //Calculate the distance from the center of mass
+          rcom = DistCent.VecMag();
+          if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
           {
-            //Use the long-range correction
-            double rcom = 0; //Distance from center of mass
-            //Calculate the distance from the center of mass
-            rcom = DistCent.VecMag();
-            if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
-            {
-              //Scale the charge
-              rcom = sqrt(rcom);
-              double scrqA,scrqB; //Temporary variables
-              //Calculate temp. variables
-              scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
-              scrqB = -3*scrqA*scrqA;
-              scrqA *= 2*scrqA*scrqA;
-              //Combine temp. variables
-              scrqA += scrqB+1;
-              //Set the scale factor
-              scrq -= pow(scrqA,QMMMOpts.LRECPow);
-            }
-            else
-            {
-              //Delete the charge
-              scrq = 0;
-            }
+            //Scale the charge
+            rcom = sqrt(rcom);
+            double scrqA,scrqB; //Temporary variables
+            //Calculate temp. variables
+            scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
+            scrqB = -3*scrqA*scrqA;
+            scrqA *= 2*scrqA*scrqA;
+            //Combine temp. variables
+            scrqA += scrqB+1;
+            //Set the scale factor
+            scrq -= pow(scrqA,QMMMOpts.LRECPow);
           }
-          if (scrq > 0)
+          else
           {
-            call << "Chrgfield.extern.addCharge(";
-            call << LICHEMFormFloat(Struct[i].MP[Bead].q*scrq,16) << ",";
-            call << LICHEMFormFloat(Struct[i].P[Bead].x+xshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].P[Bead].y+yshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].P[Bead].z+zshft,16);
-            call << ")" << '\n';
+            //Delete the charge
+            scrq = 0;
           }
         }
+        if (scrq > 0)
+        {
+          call << "Chrgfield.extern.addCharge(";
+          call << LICHEMFormFloat(Struct[i].MP[Bead].q*scrq,16) << ",";
+          call << LICHEMFormFloat(Struct[i].P[Bead].x+xshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].P[Bead].y+yshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].P[Bead].z+zshft,16);
+          call << ")" << '\n';
+        }
       }
       call << "psi4.set_global_option_python('EXTERN',Chrgfield.extern)";
       call << '\n' << '\n';
@@ -884,100 +890,100 @@ void WritePSI4Input(vector<QMMMAtom>& Struct, string CalcTyp,
     if (AMOEBA)
     {
       call << "Chrgfield = QMMM()" << '\n';
-      for (int i=0;i<Natoms;i++)
+      for (unsigned int m=0;m<MMList.size();m++)
       {
-        if (Struct[i].MMregion)
+        int i = MMList[m]; //Atom ID
+        //Check PBC (minimum image convention)
+        Coord DistCent; //Distance from QM COM
+        double xshft = 0;
+        double yshft = 0;
+        double zshft = 0;
+        if (PBCon or QMMMOpts.UseLREC)
         {
-          //Check PBC (minimum image convention)
-          Coord DistCent; //Distance from QM COM
-          double xshft = 0;
-          double yshft = 0;
-          double zshft = 0;
-          if (PBCon or QMMMOpts.UseLREC)
+          //Initialize displacements
+          double dx,dy,dz; //Starting displacements
+          dx = Struct[i].P[Bead].x-QMCOM.x;
+          dy = Struct[i].P[Bead].y-QMCOM.y;
+          dz = Struct[i].P[Bead].z-QMCOM.z;
+          DistCent.x = DxCOM(i);
+          DistCent.y = DyCOM(i);
+          DistCent.z = DzCOM(i);
+          //Calculate the shift in positions
+          //NB: Generally this work out to be +/- {Lx,Ly,Lz}
+          if (PBCon)
           {
-            //Initialize displacements
-            double dx,dy,dz; //Starting displacements
-            dx = Struct[i].P[Bead].x-QMCOM.x;
-            dy = Struct[i].P[Bead].y-QMCOM.y;
-            dz = Struct[i].P[Bead].z-QMCOM.z;
-            DistCent = CoordDist2(Struct[i].P[Bead],QMCOM);
-            //Calculate the shift in positions
-            //NB: Generally this work out to be +/- {Lx,Ly,Lz}
-            if (PBCon)
-            {
-              xshft = DistCent.x-dx;
-              yshft = DistCent.y-dy;
-              zshft = DistCent.z-dz;
-            }
+            xshft = DistCent.x-dx;
+            yshft = DistCent.y-dy;
+            zshft = DistCent.z-dz;
           }
-          //Check for long-range corrections
-          double scrq = 1;
-          if (QMMMOpts.UseLREC)
+        }
+        //Check for long-range corrections
+        double scrq = 1;
+        if (QMMMOpts.UseLREC)
+        {
+          //Use the long-range correction
+          double rcom = 0; //Distance from center of mass
+          //Calculate the distance from the center of mass
+          rcom = DistCent.VecMag();
+          if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
           {
-            //Use the long-range correction
-            double rcom = 0; //Distance from center of mass
-            //Calculate the distance from the center of mass
-            rcom = DistCent.VecMag();
-            if (rcom <= (QMMMOpts.LRECCut*QMMMOpts.LRECCut))
-            {
-              //Scale the charge
-              rcom = sqrt(rcom);
-              double scrqA,scrqB; //Temporary variables
-              //Calculate temp. variables
-              scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
-              scrqB = -3*scrqA*scrqA;
-              scrqA *= 2*scrqA*scrqA;
-              //Combine temp. variables
-              scrqA += scrqB+1;
-              //Set the scale factor
-              scrq -= pow(scrqA,QMMMOpts.LRECPow);
-            }
-            else
-            {
-              //Delete the charge
-              scrq = 0;
-            }
+            //Scale the charge
+            rcom = sqrt(rcom);
+            double scrqA,scrqB; //Temporary variables
+            //Calculate temp. variables
+            scrqA = (QMMMOpts.LRECCut-rcom)/QMMMOpts.LRECCut;
+            scrqB = -3*scrqA*scrqA;
+            scrqA *= 2*scrqA*scrqA;
+            //Combine temp. variables
+            scrqA += scrqB+1;
+            //Set the scale factor
+            scrq -= pow(scrqA,QMMMOpts.LRECPow);
           }
-          if (scrq > 0)
+          else
           {
-            call << "Chrgfield.extern.addCharge(";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q1*scrq,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x1+xshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y1+yshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z1+zshft,16);
-            call << ")" << '\n';
-            call << "Chrgfield.extern.addCharge(";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q2*scrq,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x2+xshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y2+yshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z2+zshft,16);
-            call << ")" << '\n';
-            call << "Chrgfield.extern.addCharge(";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q3*scrq,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x3+xshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y3+yshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z3+zshft,16);
-            call << ")" << '\n';
-            call << "Chrgfield.extern.addCharge(";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q4*scrq,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x4+xshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y4+yshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z4+zshft,16);
-            call << ")" << '\n';
-            call << "Chrgfield.extern.addCharge(";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q5*scrq,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x5+xshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y5+yshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z5+zshft,16);
-            call << ")" << '\n';
-            call << "Chrgfield.extern.addCharge(";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].q6*scrq,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].x6+xshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].y6+yshft,16) << ",";
-            call << LICHEMFormFloat(Struct[i].PC[Bead].z6+zshft,16);
-            call << ")" << '\n';
+            //Delete the charge
+            scrq = 0;
           }
         }
+        if (scrq > 0)
+        {
+          call << "Chrgfield.extern.addCharge(";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q1*scrq,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x1+xshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y1+yshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z1+zshft,16);
+          call << ")" << '\n';
+          call << "Chrgfield.extern.addCharge(";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q2*scrq,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x2+xshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y2+yshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z2+zshft,16);
+          call << ")" << '\n';
+          call << "Chrgfield.extern.addCharge(";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q3*scrq,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x3+xshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y3+yshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z3+zshft,16);
+          call << ")" << '\n';
+          call << "Chrgfield.extern.addCharge(";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q4*scrq,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x4+xshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y4+yshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z4+zshft,16);
+          call << ")" << '\n';
+          call << "Chrgfield.extern.addCharge(";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q5*scrq,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x5+xshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y5+yshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z5+zshft,16);
+          call << ")" << '\n';
+          call << "Chrgfield.extern.addCharge(";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].q6*scrq,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].x6+xshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].y6+yshft,16) << ",";
+          call << LICHEMFormFloat(Struct[i].PC[Bead].z6+zshft,16);
+          call << ")" << '\n';
+        }
       }
       call << "psi4.set_global_option_python('EXTERN',Chrgfield.extern)";
       call << '\n';
@@ -1009,7 +1015,7 @@ void WritePSI4Input(vector<QMMMAtom>& Struct, string CalcTyp,
   //Create file
   dummy = call.str(); //Store file as a temporary variable
   call.str("");
-  call << "LICHM_" << Bead << ".dat";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dat";
   ofile.open(call.str().c_str(),ios_base::out);
   ofile << dummy << '\n';
   ofile.flush();
@@ -1070,8 +1076,9 @@ void WriteQMConnect(int& argc,char**& argv)
       //Write connectivity line
       ofile << i << " "; //Index
       ofile << AtTyp << " "; //Element
-      ofile << PTable.RevTyping(AtTyp) << " "; //Atomic number
-      ofile << PTable.GetAtMass(AtTyp) << " "; //Mass
+      int Z = PTable.RevTyping(AtTyp); //Atomic number
+      ofile << Z << " "; //Atomic number
+      ofile << PTable.GetAtMass(Z) << " "; //Mass
       ofile << "0.00 0" << '\n'; //Charge and bonds
     }
     cout << "Connectivity data written to connect.inp";
@@ -17,6 +17,50 @@
 */
 
 //MM utility functions
+void TINKERCopyKey(const string& KeyName)
+{
+  //Function to copy tinker.key to the key file of a calculation
+  //NB: TINKER looks for the parameter file in the directory where it runs,
+  //so relative names are changed to absolute names in scratch directories
+  if (ScratchTop == "")
+  {
+    LICHEMCopyFile("tinker.key",KeyName);
+    return;
+  }
+  fstream ifile,ofile; //Generic file streams
+  string dummy; //Generic string
+  char WorkDir[4096]; //Working directory
+  if (getcwd(WorkDir,sizeof(WorkDir)) == NULL)
+  {
+    //Fall back to a plain copy
+    LICHEMCopyFile("tinker.key",KeyName);
+    return;
+  }
+  ifile.open("tinker.key",ios_base::in);
+  ofile.open(KeyName.c_str(),ios_base::out);
+  while (getline(ifile,dummy))
+  {
+    stringstream line(dummy);
+    string keyword,ParamFile; //Key file keyword and parameter file
+    line >> keyword >> ParamFile;
+    LICHEMLowerText(keyword);
+    if ((keyword == "parameters") and (ParamFile != "") and
+       (ParamFile[0] != '/'))
+    {
+      //Use the absolute path
+      ofile << "parameters " << WorkDir << "/" << ParamFile << '\n';
+    }
+    else
+    {
+      ofile << dummy << '\n';
+    }
+  }
+  ofile.flush();
+  ofile.close();
+  ifile.close();
+  return;
+};
+
 void FindTINKERClasses(vector<QMMMAtom>& Struct)
 {
   //Parses TINKER parameter files to find atom classes
@@ -115,7 +159,7 @@ void TINKERInduced(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   int ct; //Generic counter
   //Create TINKER xyz file
   call.str("");
-  call << "LICHM_" << Bead << ".xyz";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   ofile << Natoms << '\n';
   if (PBCon)
@@ -152,12 +196,12 @@ void TINKERInduced(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   ofile.close();
   //Create new TINKER key file
   call.str("");
-  call << "cp tinker.key LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
-  GlobalSys = system(call.str().c_str());
+  TINKERCopyKey(call.str());
   //Update key file
   call.str("");
-  call << "LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
   ofile.open(call.str().c_str(),ios_base::app|ios_base::out);
   ofile << '\n'; //Make sure current line is empty
@@ -275,11 +319,14 @@ void TINKERInduced(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   //Calculate induced dipoles using dynamic
   call.str("");
   call << "dynamic LICHM_" << Bead << ".xyz ";
-  call << "1 1e-4 1e-7 2 0 > LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  call << "1 1e-4 1e-7 2 0";
+  string cmd = call.str(); //Command to run
+  call.str("");
+  call << "LICHM_" << Bead << ".log";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Extract induced dipoles from the MD cycle file
   call.str("");
-  call << "LICHM_" << Bead << ".001u";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".001u";
   ifile.open(call.str().c_str(),ios_base::in);
   getline(ifile,dummy); //Clear number of atoms
   while (ifile.good())
@@ -305,14 +352,264 @@ void TINKERInduced(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   ifile.close();
   //Delete junk files
   call.str("");
-  call << "rm -f";
-  call << " LICHM_" << Bead << ".xyz";
-  call << " LICHM_" << Bead << ".key";
-  call << " LICHM_" << Bead << ".0*";
-  call << " LICHM_" << Bead << ".dyn";
-  call << " LICHM_" << Bead << ".log";
-  call << " LICHM_" << Bead << ".err";
-  GlobalSys = system(call.str().c_str());
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".key";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".0*";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dyn";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".err";
+  LICHEMRemoveFiles(call.str());
+  return;
+};
+
+bool TINKERPolShared(QMMMSettings& QMMMOpts, int Bead)
+{
+  //Check if the polarization energy and forces can use one calculation
+  /*
+    NB: For AMOEBA the energy and force keys only differ in the active
+    atoms. Induced dipoles are only placed on MM atoms, so running testgrad
+    with every atom active gives the same polarization energy as analyze
+    with the MM atoms active, and the same gradients on the QM atoms.
+    Implicit solvation terms depend on the active atoms, so GK calculations
+    still use separate runs.
+  */
+  if (AMOEBA and QMMM and (!QMMMOpts.UseImpSolv))
+  {
+    int Job = LICHEMJobID(QMMMOpts,Bead); //Position of the results
+    if ((Bead >= 0) and (Job < (int)TINKERPolResults.size()))
+    {
+      return 1;
+    }
+  }
+  return 0;
+};
+
+void TINKERPolGradient(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
+                       int Bead)
+{
+  //Calculates the polarization energy and QM forces with one testgrad run
+  fstream ofile,ifile; //Generic file streams
+  string dummy; //Generic string
+  stringstream call; //Stream for system calls and reading/writing files
+  call.copyfmt(cout); //Copy settings from cout
+  int Job = LICHEMJobID(QMMMOpts,Bead); //Position of the results
+  MMPolResult& Saved = TINKERPolResults[Job]; //Shorter name
+  Saved.Clear();
+  Saved.Forces.resize(3*(Nqm+Npseudo));
+  Saved.Forces.setZero();
+  //Create new TINKER key file
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_";
+  call << Bead << ".key";
+  TINKERCopyKey(call.str());
+  //Update key file
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_";
+  call << Bead << ".key";
+  ofile.open(call.str().c_str(),ios_base::app|ios_base::out);
+  ofile << '\n';
+  ofile << "#LICHEM QMMM keywords"; //Marks the changes
+  ofile << '\n';
+  if (QMMMOpts.UseLREC)
+  {
+    //Apply cutoff
+    if (QMMMOpts.UseEwald and PBCon)
+    {
+      //Use Ewald or PME
+      ofile << "ewald" << '\n';
+    }
+    else
+    {
+      //Use smoothing functions
+      ofile << "cutoff " << LICHEMFormFloat(QMMMOpts.LRECCut,12);
+      ofile << '\n';
+      ofile << "taper " << LICHEMFormFloat(0.90*QMMMOpts.LRECCut,12);
+      ofile << '\n';
+    }
+  }
+  ofile << "openmp-threads " << Ncpus << '\n';
+  ofile << "digits 12" << '\n'; //Increase precision
+  if (PBCon)
+  {
+    //PBC defined twice for safety
+    ofile << "a-axis " << LICHEMFormFloat(Lx,12) << '\n';
+    ofile << "b-axis " << LICHEMFormFloat(Ly,12) << '\n';
+    ofile << "c-axis " << LICHEMFormFloat(Lz,12) << '\n';
+    ofile << "alpha 90.0" << '\n';
+    ofile << "beta 90.0" << '\n';
+    ofile << "gamma 90.0" << '\n';
+  }
+  //Get rid of non-polarization interactions
+  ofile << "polarizeterm only" << '\n';
+  for (int i=0;i<Natoms;i++)
+  {
+    //Add nuclear charges
+    if (Struct[i].QMregion)
+    {
+      //Write new multipole definition for the atom ID
+      WriteTINKMpole(Struct,ofile,i,Bead);
+      ofile << "polarize -" << (Struct[i].id+1) << " 0.0 0.0";
+      ofile << '\n';
+    }
+    if (Struct[i].PBregion)
+    {
+      //Modify the charge to force charge balance with the boundaries
+      double qi = Struct[i].MP[Bead].q; //Save a copy
+      vector<int> Boundaries;
+      Boundaries = TraceBoundary(Struct,i);
+      double qnew = qi;
+      for (unsigned int j=0;j<Boundaries.size();j++)
+      {
+        //Subtract boundary atom charge
+        qnew -= Struct[Boundaries[j]].MP[Bead].q;
+      }
+      Struct[i].MP[Bead].q = qnew; //Save modified charge
+      WriteTINKMpole(Struct,ofile,i,Bead);
+      Struct[i].MP[Bead].q = qi; //Return to unmodified charge
+      ofile << "polarize -" << (Struct[i].id+1) << " 0.0 0.0";
+      ofile << '\n';
+    }
+    if (Struct[i].BAregion)
+    {
+      ofile << "polarize -" << (Struct[i].id+1) << " 0.0 0.0";
+      ofile << '\n';
+    }
+  }
+  ofile.flush();
+  ofile.close();
+  //Create TINKER xyz file from the structure
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
+  ofile.open(call.str().c_str(),ios_base::out);
+  //Write atoms to the xyz file
+  ofile << Natoms << '\n';
+  if (PBCon)
+  {
+    //Write box size
+    ofile << LICHEMFormFloat(Lx,12) << " ";
+    ofile << LICHEMFormFloat(Ly,12) << " ";
+    ofile << LICHEMFormFloat(Lz,12) << " ";
+    ofile << "90.0 90.0 90.0";
+    ofile << '\n';
+  }
+  for (int i=0;i<Natoms;i++)
+  {
+    ofile << setw(6) << (Struct[i].id+1);
+    ofile << " ";
+    ofile << setw(3) << Struct[i].MMTyp;
+    ofile << " ";
+    ofile << LICHEMFormFloat(Struct[i].P[Bead].x,16);
+    ofile << " ";
+    ofile << LICHEMFormFloat(Struct[i].P[Bead].y,16);
+    ofile << " ";
+    ofile << LICHEMFormFloat(Struct[i].P[Bead].z,16);
+    ofile << " ";
+    ofile << setw(4) << Struct[i].NumTyp;
+    for (unsigned int j=0;j<Struct[i].Bonds.size();j++)
+    {
+      ofile << " "; //Avoids trailing spaces
+      ofile << setw(6) << (Struct[i].Bonds[j]+1);
+    }
+    ofile << '\n';
+  }
+  ofile.flush();
+  ofile.close();
+  //Run MM
+  call.str("");
+  call << "testgrad ";
+  call << "LICHM_" << Bead << ".xyz";
+  call << " Y N N";
+  string cmd = call.str(); //Command to run
+  call.str("");
+  call << "LICHM_" << Bead << ".grad";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
+  //Find the QM and PB atoms in the list of gradients
+  vector<int> ForceID(Natoms,-1); //Position in the force vector
+  for (int p=0;p<(Nqm+Npseudo);p++)
+  {
+    ForceID[Struct[QMPBList[p]].id] = p;
+  }
+  //Collect the energy and forces
+  fstream MMgrad; //QMMM output
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".grad";
+  MMgrad.open(call.str().c_str(),ios_base::in);
+  bool Efound = 0;
+  bool GradDone = 0;
+  while ((!MMgrad.eof()) and (!GradDone))
+  {
+    getline(MMgrad,dummy);
+    stringstream line(dummy);
+    line >> dummy;
+    if (dummy == "Type")
+    {
+      line >> dummy >> dummy;
+      if (dummy == "dE/dX")
+      {
+        GradDone = 1;
+        getline(MMgrad,dummy);
+        for (int i=0;i<Natoms;i++)
+        {
+          //Every atom is active, so skip the MM atoms
+          int AtNum = 0; //TINKER atom ID
+          double Fx = 0;
+          double Fy = 0;
+          double Fz = 0;
+          getline(MMgrad,dummy);
+          stringstream line(dummy);
+          line >> dummy >> AtNum; //Clear junk
+          line >> Fx;
+          line >> Fy;
+          line >> Fz;
+          if ((AtNum < 1) or (AtNum > Natoms))
+          {
+            continue;
+          }
+          int p = ForceID[AtNum-1]; //Position in the force vector
+          if (p >= 0)
+          {
+            //Change from gradient to force and switch to eV/A
+            Saved.Forces(3*p) = -1*Fx*kcal2eV;
+            Saved.Forces(3*p+1) = -1*Fy*kcal2eV;
+            Saved.Forces(3*p+2) = -1*Fz*kcal2eV;
+          }
+        }
+      }
+    }
+    if (dummy == "Total")
+    {
+      line >> dummy >> dummy;
+      if (dummy == "Energy")
+      {
+        //Collect polarization energy
+        line >> dummy >> Saved.E;
+        Efound = 1;
+      }
+    }
+  }
+  MMgrad.close();
+  if (Efound and GradDone)
+  {
+    //Allow the energy and force calculations to share the results
+    Saved.Save(Struct,Bead);
+  }
+  else
+  {
+    //Warn user if no energy was found
+    cerr << "Warning: No MM energy found after a calculation!!!";
+    cerr << '\n';
+    cerr << " LICHEM will attempt to continue...";
+    cerr << '\n';
+    cerr.flush(); //Print warning immediately
+    Saved.Clear(); //Prevents errors when polarization is off
+  }
+  //Clean up files
+  call.str("");
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".key";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".grad";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".err";
+  LICHEMRemoveFiles(call.str());
   return;
 };
 
@@ -320,6 +617,16 @@ double TINKERPolEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
                        int Bead)
 {
   //Function to extract the polarization energy
+  if (TINKERPolShared(QMMMOpts,Bead))
+  {
+    int Job = LICHEMJobID(QMMMOpts,Bead); //Position of the results
+    //Reuse the forces calculation when the structure has not changed
+    if (!TINKERPolResults[Job].Match(Struct,Bead))
+    {
+      TINKERPolGradient(Struct,QMMMOpts,Bead);
+    }
+    return TINKERPolResults[Job].E;
+  }
   fstream ofile,ifile; //Generic file streams
   stringstream call; //Stream for system calls and reading/writing files
   call.copyfmt(cout); //Copy settings from cout
@@ -330,7 +637,7 @@ double TINKERPolEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   int ct; //Generic counter
   //Create TINKER xyz file
   call.str("");
-  call << "LICHM_" << Bead << ".xyz";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   ofile << Natoms << '\n';
   if (PBCon)
@@ -367,12 +674,12 @@ double TINKERPolEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   ofile.close();
   //Create new TINKER key file
   call.str("");
-  call << "cp tinker.key LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
-  GlobalSys = system(call.str().c_str());
+  TINKERCopyKey(call.str());
   //Update key file
   call.str("");
-  call << "LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
   ofile.open(call.str().c_str(),ios_base::app|ios_base::out);
   ofile << '\n';
@@ -499,12 +806,14 @@ double TINKERPolEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   //Calculate QMMM energy
   call.str("");
   call << "analyze LICHM_";
-  call << Bead << ".xyz E > LICHM_";
-  call << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
-  //Extract polarization energy
+  call << Bead << ".xyz E";
+  string cmd = call.str(); //Command to run
   call.str("");
   call << "LICHM_" << Bead << ".log";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
+  //Extract polarization energy
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
   ifile.open(call.str().c_str(),ios_base::in);
   bool Efound = 0;
   while (!ifile.eof())
@@ -546,12 +855,11 @@ double TINKERPolEnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   ifile.close();
   //Clean up files
   call.str("");
-  call << "rm -f";
-  call << " LICHM_" << Bead << ".xyz";
-  call << " LICHM_" << Bead << ".log";
-  call << " LICHM_" << Bead << ".key";
-  call << " LICHM_" << Bead << ".err";
-  GlobalSys = system(call.str().c_str());
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".key";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".err";
+  LICHEMRemoveFiles(call.str());
   //Return polarization and solvation energy in kcal/mol
   return Epol+Esolv;
 };
@@ -566,14 +874,22 @@ double TINKERForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   call.copyfmt(cout); //Copy settings from cout
   double Emm = 0.0;
   int ct; //Generic counter
+  //Use a saved result for repeated structures
+  uint64_t CacheKey; //Hash of the inputs
+  CacheKey = SavedResults.GetKey("TINKERForces",Struct,QMMMOpts,Bead,0,1);
+  if (SavedResults.FindForces(CacheKey,Struct,Forces,Bead,Emm))
+  {
+    return Emm;
+  }
+  VectorXd OldForces = Forces; //Forces from other wrappers
   //Construct MM forces input for TINKER
   call.str("");
-  call << "cp tinker.key LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
-  GlobalSys = system(call.str().c_str());
+  TINKERCopyKey(call.str());
   //Update key file
   call.str("");
-  call << "LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
   ofile.open(call.str().c_str(),ios_base::app|ios_base::out);
   ofile << '\n';
@@ -616,29 +932,27 @@ double TINKERForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
     ofile << "gamma 90.0" << '\n';
   }
   ct = 0; //Generic counter
-  for (int i=0;i<Natoms;i++)
+  for (int p=0;p<(Nqm+Npseudo);p++)
   {
     //Add active atoms
-    if (Struct[i].QMregion or Struct[i].PBregion)
+    int i = QMPBList[p]; //Atom ID
+    if (ct == 0)
     {
-      if (ct == 0)
-      {
-        //Start a new active line
-        ofile << "active ";
-      }
-      else
-      {
-        //Place a space to separate values
-        ofile << " ";
-      }
-      ofile << (Struct[i].id+1);
-      ct += 1;
-      if (ct == 10)
-      {
-        //terminate an active line
-        ct = 0;
-        ofile << '\n';
-      }
+      //Start a new active line
+      ofile << "active ";
+    }
+    else
+    {
+      //Place a space to separate values
+      ofile << " ";
+    }
+    ofile << (Struct[i].id+1);
+    ct += 1;
+    if (ct == 10)
+    {
+      //terminate an active line
+      ct = 0;
+      ofile << '\n';
     }
   }
   if (ct != 0)
@@ -648,29 +962,27 @@ double TINKERForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   }
   ofile << "group-inter" << '\n'; //Modify interactions
   ct = 0; //Generic counter
-  for (int i=0;i<Natoms;i++)
+  for (int p=0;p<(Nqm+Npseudo);p++)
   {
     //Add group 1 atoms
-    if (Struct[i].QMregion or Struct[i].PBregion)
+    int i = QMPBList[p]; //Atom ID
+    if (ct == 0)
     {
-      if (ct == 0)
-      {
-        //Start a new group line
-        ofile << "group 1 ";
-      }
-      else
-      {
-        //Place a space to separate values
-        ofile << " ";
-      }
-      ofile << (Struct[i].id+1);
-      ct += 1;
-      if (ct == 10)
-      {
-        //terminate a group line
-        ct = 0;
-        ofile << '\n';
-      }
+      //Start a new group line
+      ofile << "group 1 ";
+    }
+    else
+    {
+      //Place a space to separate values
+      ofile << " ";
+    }
+    ofile << (Struct[i].id+1);
+    ct += 1;
+    if (ct == 10)
+    {
+      //terminate a group line
+      ct = 0;
+      ofile << '\n';
     }
   }
   if (ct != 0)
@@ -714,7 +1026,7 @@ double TINKERForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   ofile.close();
   //Create TINKER xyz file from the structure
   call.str("");
-  call << "LICHM_" << Bead << ".xyz";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   //Write atoms to the xyz file
   ofile << Natoms << '\n';
@@ -754,14 +1066,16 @@ double TINKERForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   call.str("");
   call << "testgrad ";
   call << "LICHM_" << Bead << ".xyz";
-  call << " Y N N > ";
+  call << " Y N N";
+  string cmd = call.str(); //Command to run
+  call.str("");
   call << "LICHM_" << Bead << ".grad";
-  GlobalSys = system(call.str().c_str());
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Collect MM forces
   fstream MMgrad; //QMMM output
   //Open files
   call.str("");
-  call << "LICHM_" << Bead << ".grad";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".grad";
   MMgrad.open(call.str().c_str(),ios_base::in);
   //Read derivatives
   bool GradDone = 0;
@@ -813,14 +1127,15 @@ double TINKERForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   MMgrad.close();
   //Clean up files
   call.str("");
-  call << "rm -f";
-  call << " LICHM_" << Bead << ".xyz";
-  call << " LICHM_" << Bead << ".key";
-  call << " LICHM_" << Bead << ".grad";
-  call << " LICHM_" << Bead << ".err";
-  GlobalSys = system(call.str().c_str());
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".key";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".grad";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".err";
+  LICHEMRemoveFiles(call.str());
   //Return
   Emm *= kcal2eV;
+  //Save the result for repeated structures
+  SavedResults.SaveForces(CacheKey,Struct,Forces-OldForces,Bead,Emm);
   return Emm;
 };
 
@@ -837,12 +1152,12 @@ double TINKERMMForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   int ct; //Generic counter
   //Construct MM forces input for TINKER
   call.str("");
-  call << "cp tinker.key LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
-  GlobalSys = system(call.str().c_str());
+  TINKERCopyKey(call.str());
   //Update key file
   call.str("");
-  call << "LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
   ofile.open(call.str().c_str(),ios_base::app|ios_base::out);
   ofile << '\n';
@@ -965,7 +1280,7 @@ double TINKERMMForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   ofile.close();
   //Create TINKER xyz file from the structure
   call.str("");
-  call << "LICHM_" << Bead << ".xyz";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   //Write atoms to the xyz file
   ofile << Natoms << '\n';
@@ -1004,14 +1319,16 @@ double TINKERMMForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   call.str("");
   call << "testgrad ";
   call << "LICHM_" << Bead << ".xyz";
-  call << " Y N N > ";
+  call << " Y N N";
+  string cmd = call.str(); //Command to run
+  call.str("");
   call << "LICHM_" << Bead << ".grad";
-  GlobalSys = system(call.str().c_str());
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Collect MM forces
   fstream MMgrad; //QMMM output
   //Open files
   call.str("");
-  call << "LICHM_" << Bead << ".grad";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".grad";
   MMgrad.open(call.str().c_str(),ios_base::in);
   //Read derivatives
   bool GradDone = 0;
@@ -1068,12 +1385,11 @@ double TINKERMMForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   MMgrad.close();
   //Clean up files
   call.str("");
-  call << "rm -f";
-  call << " LICHM_" << Bead << ".xyz";
-  call << " LICHM_" << Bead << ".key";
-  call << " LICHM_" << Bead << ".grad";
-  call << " LICHM_" << Bead << ".err";
-  GlobalSys = system(call.str().c_str());
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".key";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".grad";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".err";
+  LICHEMRemoveFiles(call.str());
   //Return energy for error checking purposes
   return Emm;
 };
@@ -1082,6 +1398,17 @@ double TINKERPolForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
                        QMMMSettings& QMMMOpts, int Bead)
 {
   //Function for calculating the MM forces on a set of QM atoms
+  if (TINKERPolShared(QMMMOpts,Bead))
+  {
+    int Job = LICHEMJobID(QMMMOpts,Bead); //Position of the results
+    //Reuse the energy calculation when the structure has not changed
+    if (!TINKERPolResults[Job].Match(Struct,Bead))
+    {
+      TINKERPolGradient(Struct,QMMMOpts,Bead);
+    }
+    Forces += TINKERPolResults[Job].Forces;
+    return TINKERPolResults[Job].E*kcal2eV;
+  }
   fstream ofile,ifile; //Generic file streams
   string dummy; //Generic string
   stringstream call; //Stream for system calls and reading/writing files
@@ -1090,12 +1417,12 @@ double TINKERPolForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   int ct; //Generic counter
   //Construct MM forces input for TINKER
   call.str("");
-  call << "cp tinker.key LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
-  GlobalSys = system(call.str().c_str());
+  TINKERCopyKey(call.str());
   //Update key file
   call.str("");
-  call << "LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
   ofile.open(call.str().c_str(),ios_base::app|ios_base::out);
   ofile << '\n';
@@ -1150,29 +1477,27 @@ double TINKERPolForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
     ofile << '\n';
   }
   ct = 0; //Generic counter
-  for (int i=0;i<Natoms;i++)
+  for (int p=0;p<(Nqm+Npseudo);p++)
   {
     //Add active atoms
-    if (Struct[i].QMregion or Struct[i].PBregion)
+    int i = QMPBList[p]; //Atom ID
+    if (ct == 0)
     {
-      if (ct == 0)
-      {
-        //Start a new active line
-        ofile << "active ";
-      }
-      else
-      {
-        //Place a space to separate values
-        ofile << " ";
-      }
-      ofile << (Struct[i].id+1);
-      ct += 1;
-      if (ct == 10)
-      {
-        //terminate an active line
-        ct = 0;
-        ofile << '\n';
-      }
+      //Start a new active line
+      ofile << "active ";
+    }
+    else
+    {
+      //Place a space to separate values
+      ofile << " ";
+    }
+    ofile << (Struct[i].id+1);
+    ct += 1;
+    if (ct == 10)
+    {
+      //terminate an active line
+      ct = 0;
+      ofile << '\n';
     }
   }
   if (ct != 0)
@@ -1220,7 +1545,7 @@ double TINKERPolForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   ofile.close();
   //Create TINKER xyz file from the structure
   call.str("");
-  call << "LICHM_" << Bead << ".xyz";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   //Write atoms to the xyz file
   ofile << Natoms << '\n';
@@ -1260,14 +1585,16 @@ double TINKERPolForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   call.str("");
   call << "testgrad ";
   call << "LICHM_" << Bead << ".xyz";
-  call << " Y N N > ";
+  call << " Y N N";
+  string cmd = call.str(); //Command to run
+  call.str("");
   call << "LICHM_" << Bead << ".grad";
-  GlobalSys = system(call.str().c_str());
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Collect MM forces
   fstream MMgrad; //QMMM output
   //Open files
   call.str("");
-  call << "LICHM_" << Bead << ".grad";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".grad";
   MMgrad.open(call.str().c_str(),ios_base::in);
   //Read derivatives
   bool GradDone = 0;
@@ -1319,12 +1646,11 @@ double TINKERPolForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
   MMgrad.close();
   //Clean up files
   call.str("");
-  call << "rm -f";
-  call << " LICHM_" << Bead << ".xyz";
-  call << " LICHM_" << Bead << ".key";
-  call << " LICHM_" << Bead << ".grad";
-  call << " LICHM_" << Bead << ".err";
-  GlobalSys = system(call.str().c_str());
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".key";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".grad";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".err";
+  LICHEMRemoveFiles(call.str());
   //Return
   Emm *= kcal2eV;
   return Emm;
@@ -1333,21 +1659,31 @@ double TINKERPolForces(vector<QMMMAtom>& Struct, VectorXd& Forces,
 double TINKEREnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
 {
   //Runs TINKER MM energy calculations
+  //NB: The LICHMM_ names keep the files away from the QM wrappers, which
+  //can run at the same time in the same directory (see LICHEMBeadEnergy)
   fstream ofile,ifile; //Generic file streams
   stringstream call; //Stream for system calls and reading/writing files
   call.copyfmt(cout); //Copy settings from cout
   string dummy; //Generic string
   double E = 0;
+  bool Efound = 0;
   int ct; //Generic counter
-  call.str("");
+  //Use a saved result for repeated structures
+  uint64_t CacheKey; //Hash of the inputs
+  CacheKey = SavedResults.GetKey("TINKEREnergy",Struct,QMMMOpts,Bead,0,
+                                 LICHEMMMUsesQMCharges(QMMMOpts));
+  if (SavedResults.FindEnergy(CacheKey,Struct,Bead,E))
+  {
+    return E;
+  }
   //Copy the original key file and make changes
   call.str("");
-  call << "cp tinker.key LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHMM_";
   call << Bead << ".key";
-  GlobalSys = system(call.str().c_str());
+  TINKERCopyKey(call.str());
   //Update key file
   call.str("");
-  call << "LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHMM_";
   call << Bead << ".key";
   ofile.open(call.str().c_str(),ios_base::app|ios_base::out);
   ofile << '\n';
@@ -1471,7 +1807,7 @@ double TINKEREnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   ofile.close();
   //Create TINKER xyz file from the structure
   call.str("");
-  call << "LICHM_" << Bead << ".xyz";
+  call << LICHEMJobDir(Bead) << "LICHMM_" << Bead << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   //Write atoms to the xyz file
   ofile << Natoms << '\n';
@@ -1509,15 +1845,16 @@ double TINKEREnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   ofile.close();
   //Calculate MM potential energy
   call.str("");
-  call << "analyze LICHM_";
-  call << Bead << ".xyz E > LICHM_";
-  call << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  call << "analyze LICHMM_";
+  call << Bead << ".xyz E";
+  string cmd = call.str(); //Command to run
   call.str("");
-  call << "LICHM_" << Bead << ".log";
+  call << "LICHMM_" << Bead << ".log";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
+  call.str("");
+  call << LICHEMJobDir(Bead) << "LICHMM_" << Bead << ".log";
   ifile.open(call.str().c_str(),ios_base::in);
   //Read MM potential energy
-  bool Efound = 0;
   while (!ifile.eof())
   {
     ifile >> dummy;
@@ -1544,12 +1881,11 @@ double TINKEREnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   ifile.close();
   //Clean up files
   call.str("");
-  call << "rm -f";
-  call << " LICHM_" << Bead << ".xyz";
-  call << " LICHM_" << Bead << ".log";
-  call << " LICHM_" << Bead << ".key";
-  call << " LICHM_" << Bead << ".err";
-  GlobalSys = system(call.str().c_str());
+  call << " " << LICHEMJobDir(Bead) << "LICHMM_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "LICHMM_" << Bead << ".log";
+  call << " " << LICHEMJobDir(Bead) << "LICHMM_" << Bead << ".key";
+  call << " " << LICHEMJobDir(Bead) << "LICHMM_" << Bead << ".err";
+  LICHEMRemoveFiles(call.str());
   //Calculate polarization energy
   if ((AMOEBA or GEM or QMMMOpts.UseImpSolv) and QMMM)
   {
@@ -1558,6 +1894,11 @@ double TINKEREnergy(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   }
   //Change units
   E *= kcal2eV;
+  if (Efound)
+  {
+    //Save the result for repeated structures
+    SavedResults.SaveEnergy(CacheKey,Struct,Bead,E);
+  }
   return E;
 };
 
@@ -1573,12 +1914,12 @@ void TINKERDynamics(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call.str("");
   //Copy the original key file and make changes
   call.str("");
-  call << "cp tinker.key LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
-  GlobalSys = system(call.str().c_str());
+  TINKERCopyKey(call.str());
   //Update key file
   call.str("");
-  call << "LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
   ofile.open(call.str().c_str(),ios_base::app|ios_base::out);
   ofile << '\n';
@@ -1732,7 +2073,7 @@ void TINKERDynamics(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   ofile.close();
   //Create TINKER xyz file from the structure
   call.str("");
-  call << "LICHM_" << Bead << ".xyz";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   //Write atoms to the xyz file
   ofile << Natoms << '\n';
@@ -1776,11 +2117,13 @@ void TINKERDynamics(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call << QMMMOpts.dt << " ";
   call << (QMMMOpts.Nsteps*QMMMOpts.dt/1000) << " ";
   call << "2 " << QMMMOpts.Temp;
-  call << " > LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  string cmd = call.str(); //Command to run
+  call.str("");
+  call << "LICHM_" << Bead << ".log";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Read new structure
   call.str("");
-  call << "LICHM_" << Bead << ".001";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".001";
   ifile.open(call.str().c_str(),ios_base::in);
   if (ifile.good())
   {
@@ -1811,20 +2154,18 @@ void TINKERDynamics(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     cerr.flush();
     //Remove restart file
     call.str("");
-    call << "rm -f";
-    call << " LICHM_" << Bead << ".dyn";
-    GlobalSys = system(call.str().c_str());
+    call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".dyn";
+    LICHEMRemoveFiles(call.str());
   }
   ifile.close();
   //Clean up all files except the .dyn files
   call.str("");
-  call << "rm -f";
-  call << " LICHM_" << Bead << ".xyz";
-  call << " LICHM_" << Bead << ".log";
-  call << " LICHM_" << Bead << ".0*";
-  call << " LICHM_" << Bead << ".key";
-  call << " LICHM_" << Bead << ".err";
-  GlobalSys = system(call.str().c_str());
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".0*";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".key";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".err";
+  LICHEMRemoveFiles(call.str());
   return;
 };
 
@@ -1842,12 +2183,12 @@ MatrixXd TINKERHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   int ct; //Generic counter
   //Construct MM forces input for TINKER
   call.str("");
-  call << "cp tinker.key LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
-  GlobalSys = system(call.str().c_str());
+  TINKERCopyKey(call.str());
   //Update key file
   call.str("");
-  call << "LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
   ofile.open(call.str().c_str(),ios_base::app|ios_base::out);
   ofile << '\n';
@@ -1890,29 +2231,27 @@ MatrixXd TINKERHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
     ofile << "gamma 90.0" << '\n';
   }
   ct = 0; //Generic counter
-  for (int i=0;i<Natoms;i++)
+  for (int p=0;p<(Nqm+Npseudo);p++)
   {
     //Add active atoms
-    if (Struct[i].QMregion or Struct[i].PBregion)
+    int i = QMPBList[p]; //Atom ID
+    if (ct == 0)
     {
-      if (ct == 0)
-      {
-        //Start a new active line
-        ofile << "active ";
-      }
-      else
-      {
-        //Place a space to separate values
-        ofile << " ";
-      }
-      ofile << (Struct[i].id+1);
-      ct += 1;
-      if (ct == 10)
-      {
-        //terminate an active line
-        ct = 0;
-        ofile << '\n';
-      }
+      //Start a new active line
+      ofile << "active ";
+    }
+    else
+    {
+      //Place a space to separate values
+      ofile << " ";
+    }
+    ofile << (Struct[i].id+1);
+    ct += 1;
+    if (ct == 10)
+    {
+      //terminate an active line
+      ct = 0;
+      ofile << '\n';
     }
   }
   if (ct != 0)
@@ -1922,29 +2261,27 @@ MatrixXd TINKERHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   }
   ofile << "group-inter" << '\n'; //Modify interactions
   ct = 0; //Generic counter
-  for (int i=0;i<Natoms;i++)
+  for (int p=0;p<(Nqm+Npseudo);p++)
   {
     //Add group 1 atoms
-    if (Struct[i].QMregion or Struct[i].PBregion)
+    int i = QMPBList[p]; //Atom ID
+    if (ct == 0)
     {
-      if (ct == 0)
-      {
-        //Start a new group line
-        ofile << "group 1 ";
-      }
-      else
-      {
-        //Place a space to separate values
-        ofile << " ";
-      }
-      ofile << (Struct[i].id+1);
-      ct += 1;
-      if (ct == 10)
-      {
-        //terminate a group line
-        ct = 0;
-        ofile << '\n';
-      }
+      //Start a new group line
+      ofile << "group 1 ";
+    }
+    else
+    {
+      //Place a space to separate values
+      ofile << " ";
+    }
+    ofile << (Struct[i].id+1);
+    ct += 1;
+    if (ct == 10)
+    {
+      //terminate a group line
+      ct = 0;
+      ofile << '\n';
     }
   }
   if (ct != 0)
@@ -1988,7 +2325,7 @@ MatrixXd TINKERHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   ofile.close();
   //Create TINKER xyz file from the structure
   call.str("");
-  call << "LICHM_" << Bead << ".xyz";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   //Write atoms to the xyz file
   ofile << Natoms << '\n';
@@ -2028,12 +2365,14 @@ MatrixXd TINKERHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   call.str("");
   call << "testhess ";
   call << "LICHM_" << Bead << ".xyz";
-  call << " Y N > ";
+  call << " Y N";
+  string cmd = call.str(); //Command to run
+  call.str("");
   call << "LICHM_" << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Collect MM forces
   call.str("");
-  call << "LICHM_" << Bead << ".hes";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".hes";
   MMlog.open(call.str().c_str(),ios_base::in);
   //Read derivatives
   bool HessDone = 0;
@@ -2095,13 +2434,12 @@ MatrixXd TINKERHessian(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts,
   }
   //Clean up files
   call.str("");
-  call << "rm -f";
-  call << " LICHM_" << Bead << ".xyz";
-  call << " LICHM_" << Bead << ".key";
-  call << " LICHM_" << Bead << ".hes";
-  call << " LICHM_" << Bead << ".log";
-  call << " LICHM_" << Bead << ".err";
-  GlobalSys = system(call.str().c_str());
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".key";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".hes";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".err";
+  LICHEMRemoveFiles(call.str());
   //Return
   return MMHess;
 };
@@ -2118,12 +2456,12 @@ double TINKEROpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   call.str("");
   //Copy the original key file and make changes
   call.str("");
-  call << "cp tinker.key LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
-  GlobalSys = system(call.str().c_str());
+  TINKERCopyKey(call.str());
   //Update key file
   call.str("");
-  call << "LICHM_";
+  call << LICHEMJobDir(Bead) << "LICHM_";
   call << Bead << ".key";
   ofile.open(call.str().c_str(),ios_base::app|ios_base::out);
   ofile << '\n';
@@ -2297,7 +2635,7 @@ double TINKEROpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   ofile.close();
   //Create TINKER xyz file from the structure
   call.str("");
-  call << "LICHM_" << Bead << ".xyz";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
   ofile.open(call.str().c_str(),ios_base::out);
   //Write atoms to the xyz file
   ofile << Natoms << '\n';
@@ -2337,12 +2675,14 @@ double TINKEROpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   call.str("");
   call << "minimize LICHM_";
   call << Bead << ".xyz ";
-  call << QMMMOpts.MMOptTol << " > LICHM_";
-  call << Bead << ".log";
-  GlobalSys = system(call.str().c_str());
+  call << QMMMOpts.MMOptTol;
+  string cmd = call.str(); //Command to run
+  call.str("");
+  call << "LICHM_" << Bead << ".log";
+  GlobalSys = LICHEMSpawn(cmd,LICHEMJobDir(Bead),"",call.str());
   //Read new structure
   call.str("");
-  call << "LICHM_" << Bead << ".xyz_2";
+  call << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz_2";
   ifile.open(call.str().c_str(),ios_base::in);
   getline(ifile,dummy); //Discard number of atoms
   if (PBCon)
@@ -2363,13 +2703,12 @@ double TINKEROpt(vector<QMMMAtom>& Struct, QMMMSettings& QMMMOpts, int Bead)
   ifile.close();
   //Clean up files
   call.str("");
-  call << "rm -f";
-  call << " LICHM_" << Bead << ".xyz";
-  call << " LICHM_" << Bead << ".log";
-  call << " LICHM_" << Bead << ".xyz_*";
-  call << " LICHM_" << Bead << ".key";
-  call << " LICHM_" << Bead << ".err";
-  GlobalSys = system(call.str().c_str());
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".log";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".xyz_*";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".key";
+  call << " " << LICHEMJobDir(Bead) << "LICHM_" << Bead << ".err";
+  LICHEMRemoveFiles(call.str());
   //Change units
   E *= kcal2eV;
   return E;
@@ -17,25 +17,15 @@
 */
 
 //Number formatting functions
-template<typename T>
-string LICHEMFormFloat(T InpVal, int wid)
+int LICHEMFormFloatFix(char* text, int Nchars, int wid)
 {
-  //Resizes a floating-point number to a set number of characters
-  //NB: This was a product of my frustration with stream settings
-  stringstream oldvalue;
-  string newvalue;
-  //Initialize settings
-  oldvalue.str("");
-  oldvalue << fixed;
-  oldvalue.precision(wid);
-  //Save input value to the string
-  oldvalue << InpVal;
-  newvalue = oldvalue.str();
+  //Resizes the printf text of a number to a set number of characters
+  //NB: The text must have room for at least wid characters
   //Check for a decimal place
   bool HasDot = 0;
-  for (unsigned int i=0;i<newvalue.length();i++)
+  for (int i=0;i<Nchars;i++)
   {
-    if (newvalue[i] == '.')
+    if (text[i] == '.')
     {
       HasDot = 1;
     }
@@ -43,34 +33,164 @@ string LICHEMFormFloat(T InpVal, int wid)
   if (!HasDot)
   {
     //Fix integers
-    if (LICHEMCount(newvalue) < (wid-2))
+    if (Nchars < (wid-2))
     {
       //Add a decimal point
-      newvalue += ".";
+      text[Nchars] = '.';
+      Nchars += 1;
     }
     else
     {
       //Escape if the integer is too long
-      return newvalue;
+      return Nchars;
     }
   }
-  int Nchars = newvalue.length();
   //Resize string
   if (Nchars > wid)
   {
     //Delete characters
-    newvalue.erase(newvalue.begin()+wid,newvalue.end());
+    Nchars = wid;
   }
   else
   {
     //Pad with zeros
-    int diff = wid-Nchars;
-    for (int i=0;i<diff;i++)
+    while (Nchars < wid)
     {
       //Add a zero
-      newvalue += "0";
+      text[Nchars] = '0';
+      Nchars += 1;
+    }
+  }
+  return Nchars;
+};
+
+int LICHEMFormFloat(char* text, double InpVal, int wid)
+{
+  //Writes a floating-point number with a set number of characters to text
+  //and returns the number of characters written
+  //NB: The text is identical to printing the value with fixed notation and
+  //wid digits of precision, followed by padding or truncating to wid
+  //characters. The value is rounded exactly with integer math when it is
+  //small enough, otherwise snprintf is used.
+  static const unsigned long long Pow10[18] =
+  {
+    1ULL,10ULL,100ULL,1000ULL,10000ULL,100000ULL,1000000ULL,10000000ULL,
+    100000000ULL,1000000000ULL,10000000000ULL,100000000000ULL,
+    1000000000000ULL,10000000000000ULL,100000000000000ULL,
+    1000000000000000ULL,10000000000000000ULL,100000000000000000ULL
+  };
+  double AbsVal = fabs(InpVal);
+  if ((wid < 1) or (wid > 17) or (!(AbsVal < 9007199254740992.0)))
+  {
+    //Large values, NaN, and unusual widths use the printf text
+    //NB: Widths are limited by the size of the FloatText buffer
+    char tmp[512];
+    if (wid > 60)
+    {
+      wid = 60;
+    }
+    int Nchars = snprintf(tmp,sizeof(tmp),"%.*f",wid,InpVal);
+    if (Nchars > (int)(sizeof(tmp)-1))
+    {
+      Nchars = (int)(sizeof(tmp)-1);
+    }
+    Nchars = LICHEMFormFloatFix(tmp,Nchars,wid);
+    if (Nchars > 63)
+    {
+      Nchars = 63;
+    }
+    for (int i=0;i<Nchars;i++)
+    {
+      text[i] = tmp[i];
+    }
+    return Nchars;
+  }
+  //Split the value into an integer mantissa and a binary exponent
+  int Exp2;
+  double Frac = frexp(AbsVal,&Exp2);
+  unsigned long long Mant = (unsigned long long)ldexp(Frac,53);
+  int Shift = 53-Exp2; //Always positive since AbsVal < 2^53
+  //Scale by 10^wid and round to the nearest integer (ties to even)
+  unsigned __int128 Scaled = (unsigned __int128)Mant*Pow10[wid];
+  unsigned __int128 Digits = 0;
+  if (Shift == 0)
+  {
+    //The value is already an integer
+    Digits = Scaled;
+  }
+  else if (Shift < 120)
+  {
+    Digits = Scaled >> Shift;
+    unsigned __int128 Rem = Scaled-(Digits << Shift);
+    unsigned __int128 Half = ((unsigned __int128)1) << (Shift-1);
+    if ((Rem > Half) or ((Rem == Half) and (Digits & 1)))
+    {
+      Digits += 1;
     }
   }
+  //Split the digits at the decimal place
+  unsigned long long IntPart = (unsigned long long)(Digits/Pow10[wid]);
+  unsigned long long FracPart = (unsigned long long)(Digits%Pow10[wid]);
+  //Write the text in reverse order
+  char tmp[64];
+  int Nchars = 0;
+  for (int i=0;i<wid;i++)
+  {
+    tmp[Nchars] = (char)('0'+(FracPart%10));
+    FracPart /= 10;
+    Nchars += 1;
+  }
+  tmp[Nchars] = '.';
+  Nchars += 1;
+  do
+  {
+    tmp[Nchars] = (char)('0'+(IntPart%10));
+    IntPart /= 10;
+    Nchars += 1;
+  }
+  while (IntPart > 0);
+  if (signbit(InpVal))
+  {
+    tmp[Nchars] = '-';
+    Nchars += 1;
+  }
+  //Copy the leading characters
+  //NB: The text always has more than wid characters before truncation
+  for (int i=0;i<wid;i++)
+  {
+    text[i] = tmp[Nchars-1-i];
+  }
+  return wid;
+};
+
+template<typename T>
+FloatText LICHEMFormFloat(T InpVal, int wid)
+{
+  //Resizes a floating-point number to a set number of characters
+  //NB: This was a product of my frustration with stream settings
+  //NB: The text is at most 63 characters, see the FloatText class
+  FloatText newvalue;
+  if (is_integral<T>::value)
+  {
+    //Integers are printed without a decimal place
+    char tmp[64];
+    int Nchars = snprintf(tmp,sizeof(tmp),"%lld",(long long)InpVal);
+    if (wid > 60)
+    {
+      wid = 60;
+    }
+    Nchars = LICHEMFormFloatFix(tmp,Nchars,wid);
+    for (int i=0;i<Nchars;i++)
+    {
+      newvalue.Text[i] = tmp[i];
+    }
+    newvalue.Nchars = Nchars;
+  }
+  else
+  {
+    //Format the value in the buffer
+    newvalue.Nchars = LICHEMFormFloat(newvalue.Text,(double)InpVal,wid);
+  }
   return newvalue;
 };
 
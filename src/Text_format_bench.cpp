@@ -0,0 +1,165 @@
+/*
+
+###############################################################################
+#                                                                             #
+#                 LICHEM: Layered Interacting CHEmical Models                 #
+#                              By: Eric G. Kratz                              #
+#                                                                             #
+#                      Symbiotic Computational Chemistry                      #
+#                                                                             #
+###############################################################################
+
+ Microbenchmark for the LICHEM number formatting functions.
+
+ Compares LICHEMFormFloat with the stringstream version it replaced. The
+ text of both versions is compared for widths 0-20 on every tenth value,
+ then the number of values formatted per second is printed for a few
+ common widths.
+
+ Usage: make bench
+
+*/
+
+//Make the LICHEM functions available
+#include "LICHEM_headers.h"
+
+//Original implementation
+template<typename T>
+string OldFormFloat(T InpVal, int wid)
+{
+  //Stringstream version of LICHEMFormFloat (before the FloatText buffer)
+  stringstream oldvalue;
+  string newvalue;
+  //Initialize settings
+  oldvalue.str("");
+  oldvalue << fixed;
+  oldvalue.precision(wid);
+  //Save input value to the string
+  oldvalue << InpVal;
+  newvalue = oldvalue.str();
+  //Check for a decimal place
+  bool HasDot = 0;
+  for (unsigned int i=0;i<newvalue.length();i++)
+  {
+    if (newvalue[i] == '.')
+    {
+      HasDot = 1;
+    }
+  }
+  if (!HasDot)
+  {
+    //Fix integers
+    if (LICHEMCount(newvalue) < (wid-2))
+    {
+      //Add a decimal point
+      newvalue += ".";
+    }
+    else
+    {
+      //Escape if the integer is too long
+      return newvalue;
+    }
+  }
+  int Nchars = newvalue.length();
+  //Resize string
+  if (Nchars > wid)
+  {
+    //Delete characters
+    newvalue.erase(newvalue.begin()+wid,newvalue.end());
+  }
+  else
+  {
+    //Pad with zeros
+    int diff = wid-Nchars;
+    for (int i=0;i<diff;i++)
+    {
+      //Add a zero
+      newvalue += "0";
+    }
+  }
+  return newvalue;
+};
+
+double BenchRate(chrono::steady_clock::time_point tstart, int Nvals)
+{
+  //Millions of values formatted per second since tstart
+  double WallTime = chrono::duration<double>(chrono::steady_clock::now()-
+                    tstart).count();
+  return Nvals/(1e6*WallTime);
+};
+
+int main()
+{
+  //Run the benchmark
+  int Nvals = 1000000; //Number of values to format
+  int Nbad = 0; //Number of values with different text
+  size_t Check = 0; //Checksum to keep the loops from being removed
+  vector<double> Vals; //Values to format
+  RandomStream Rand; //Reproducible values
+  Rand.Seed(1337,0,0,0);
+  //Mix positive and negative values over a wide range of magnitudes
+  for (int i=0;i<Nvals;i++)
+  {
+    double Mag = pow(10.0,Rand.Integer(40)-20); //Order of magnitude
+    Vals.push_back(2*(Rand.Uniform()-0.5)*Mag);
+  }
+  //Compare the text of the two versions
+  for (int wid=0;wid<=20;wid++)
+  {
+    for (int i=0;i<Nvals;i+=10)
+    {
+      string OldText = OldFormFloat(Vals[i],wid);
+      if (OldText != LICHEMFormFloat(Vals[i],wid).str())
+      {
+        Nbad += 1;
+      }
+    }
+  }
+  cout << "Values with different text: " << Nbad << '\n';
+  cout << '\n';
+  //Measure the throughput
+  cout << "Values formatted per second (millions):" << '\n';
+  int Widths[3] = {8,12,16}; //Common output widths
+  for (int k=0;k<3;k++)
+  {
+    int wid = Widths[k]; //Current width
+    ostringstream OutText; //Output buffer
+    char Text[64]; //Character buffer
+    //Original stringstream version
+    chrono::steady_clock::time_point tstart = chrono::steady_clock::now();
+    for (int i=0;i<Nvals;i++)
+    {
+      OutText.str("");
+      OutText << OldFormFloat(Vals[i],wid);
+      Check += OutText.tellp();
+    }
+    double OldRate = BenchRate(tstart,Nvals);
+    //New version written to a stream
+    tstart = chrono::steady_clock::now();
+    for (int i=0;i<Nvals;i++)
+    {
+      OutText.str("");
+      OutText << LICHEMFormFloat(Vals[i],wid);
+      Check += OutText.tellp();
+    }
+    double NewRate = BenchRate(tstart,Nvals);
+    //New version written to a buffer
+    tstart = chrono::steady_clock::now();
+    for (int i=0;i<Nvals;i++)
+    {
+      Check += LICHEMFormFloat(Text,Vals[i],wid);
+      Check += Text[0];
+    }
+    double BufRate = BenchRate(tstart,Nvals);
+    cout << " | Width: " << wid;
+    cout << " | Old: " << LICHEMFormFloat(OldRate,6);
+    cout << " | New: " << LICHEMFormFloat(NewRate,6);
+    cout << " | Buffer: " << LICHEMFormFloat(BufRate,6);
+    cout << '\n';
+  }
+  cout << '\n';
+  cout << "Checksum: " << (Check%1000) << '\n';
+  cout.flush();
+  return 0;
+};
+
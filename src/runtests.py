@@ -553,6 +553,37 @@ else:
 #    10) PBE0/AMOEBA energy
 #    11) DFP/Pseudobonds
 
+#Check the random numbers and binary trajectories
+line = "LICHEM results:"
+print(line)
+cmd = "lichem -selftest > tests.out"
+subprocess.call(cmd,shell=True)
+SelfTests = []
+SelfTests.append(["Random numbers:","Random number known answers"])
+SelfTests.append(["Binary traj. (double):","Binary trajectory (double)"])
+SelfTests.append(["Binary traj. (single):","Binary trajectory (single)"])
+SelfTests.append(["Binary traj. (compressed):",
+                  "Binary trajectory (compressed)"])
+for selftest in SelfTests:
+  line = ""
+  PassSelf = 0
+  cmd = ""
+  cmd += "grep -e"
+  cmd += ' "'+selftest[1]+': Pass" '
+  cmd += "tests.out"
+  try:
+    #Find the result
+    subprocess.check_output(cmd,shell=True)
+    PassSelf = 1
+  except:
+    #Test failed
+    PassSelf = 0
+  line = AddPass(selftest[0],PassSelf,line)
+  print(line)
+line = ""
+print(line)
+os.remove("tests.out")
+
 #Loop over tests
 for qmtest in QMTests:
   for mmtest in MMTests: